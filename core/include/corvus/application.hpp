@@ -34,6 +34,7 @@ public:
     void stop();
 
     Graphics::GraphicsContext* getGraphics() const { return this->graphicsContext.get(); }
+    Graphics::Window*          getWindow() const { return this->window.get(); }
 
 private:
     // Load ImGui resources and setup styling for the app to use.
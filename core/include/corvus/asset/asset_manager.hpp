@@ -31,6 +31,9 @@ public:
     virtual bool  canCreate() const { return false; }
     virtual void* create(const std::string& name) { return nullptr; }
 
+    // Finish work a save left running in the background
+    virtual void flush() { }
+
     virtual void   setLoaderContext(LoaderContext* ctx) { loaderContext = ctx; }
     LoaderContext* getLoaderContext() const { return loaderContext; }
 
@@ -129,6 +132,7 @@ private:
 
     std::atomic<bool>                         watcherRunning;
     std::atomic<bool>                         shuttingDown;
+    std::atomic<uint64_t>                     dataGeneration { 0 };
     std::thread                               watcherThread;
     mutable std::mutex                        assetMutex;
     std::unordered_map<std::string, uint64_t> fileModificationTimes; // Keys are internal format
@@ -245,6 +249,12 @@ public:
     bool hasAsset(const UUID& id) const;
     bool reloadAsset(const UUID& id);
 
+    /**
+     * Bumped whenever loaded asset data is deleted, unloaded or reloaded. Caches holding raw
+     * pointers into assets (the render world's proxies) resolve them again when it changes.
+     */
+    uint64_t getDataGeneration() const { return dataGeneration.load(std::memory_order_acquire); }
+
     template <typename T>
     AssetHandle<T> load(const std::string& userPath) {
         std::lock_guard<std::mutex> lock(assetMutex);
@@ -1,7 +1,9 @@
 #pragma once
 #include "asset_handle.hpp"
 #include "asset_manager.hpp"
+#include "corvus/jobs/job_system.hpp"
 #include "corvus/log.hpp"
+#include "corvus/renderer/mesh_simplifier.hpp"
 #include "corvus/renderer/model.hpp"
 #define STB_IMAGE_IMPLEMENTATION
 #include "stb_image.h"
@@ -98,62 +100,82 @@ public:
             return nullptr;
         }
 
-        auto* model = new Renderer::Model();
-
-        for (const auto& shape : shapes) {
-            std::vector<Renderer::Vertex> vertices;
-            std::vector<uint32_t>         indices;
-            vertices.reserve(shape.mesh.indices.size());
-            indices.reserve(shape.mesh.indices.size());
-
-            for (size_t i = 0; i < shape.mesh.indices.size(); ++i) {
-                const tinyobj::index_t& idx = shape.mesh.indices[i];
-
-                glm::vec3 pos(0.0f);
-                glm::vec3 norm(0.0f, 1.0f, 0.0f);
-                glm::vec2 uv(0.0f);
-
-                // Position
-                if (idx.vertex_index >= 0) {
-                    int vx = idx.vertex_index * 3;
-                    if (vx + 2 < attrib.vertices.size()) {
-                        pos = glm::vec3(attrib.vertices[vx + 0],
-                                        attrib.vertices[vx + 1],
-                                        attrib.vertices[vx + 2]);
+        // Shapes convert independently across workers, the meshes are then created here since
+        // the loading thread owns the graphics context
+        std::vector<std::vector<Renderer::Vertex>> shapeVertices(shapes.size());
+        std::vector<std::vector<uint32_t>>         shapeIndices(shapes.size());
+
+        const auto convertShapes = [&](const size_t first, const size_t last) {
+            for (size_t s = first; s < last; ++s) {
+                const auto& shape    = shapes[s];
+                auto&       vertices = shapeVertices[s];
+                auto&       indices  = shapeIndices[s];
+                vertices.reserve(shape.mesh.indices.size());
+                indices.reserve(shape.mesh.indices.size());
+
+                for (size_t i = 0; i < shape.mesh.indices.size(); ++i) {
+                    const tinyobj::index_t& idx = shape.mesh.indices[i];
+
+                    glm::vec3 pos(0.0f);
+                    glm::vec3 norm(0.0f, 1.0f, 0.0f);
+                    glm::vec2 uv(0.0f);
+
+                    // Position
+                    if (idx.vertex_index >= 0) {
+                        int vx = idx.vertex_index * 3;
+                        if (vx + 2 < attrib.vertices.size()) {
+                            pos = glm::vec3(attrib.vertices[vx + 0],
+                                            attrib.vertices[vx + 1],
+                                            attrib.vertices[vx + 2]);
+                        }
                     }
-                }
 
-                // Normal
-                if (idx.normal_index >= 0) {
-                    int nx = idx.normal_index * 3;
-                    if (nx + 2 < attrib.normals.size()) {
-                        norm = glm::vec3(
-                            attrib.normals[nx + 0], attrib.normals[nx + 1], attrib.normals[nx + 2]);
+                    // Normal
+                    if (idx.normal_index >= 0) {
+                        int nx = idx.normal_index * 3;
+                        if (nx + 2 < attrib.normals.size()) {
+                            norm = glm::vec3(attrib.normals[nx + 0],
+                                             attrib.normals[nx + 1],
+                                             attrib.normals[nx + 2]);
+                        }
                     }
-                }
 
-                // TexCoord (flip V for consistency)
-                if (idx.texcoord_index >= 0) {
-                    int tx = idx.texcoord_index * 2;
-                    if (tx + 1 < attrib.texcoords.size()) {
-                        uv = glm::vec2(attrib.texcoords[tx + 0], 1.0f - attrib.texcoords[tx + 1]);
+                    // TexCoord (flip V for consistency)
+                    if (idx.texcoord_index >= 0) {
+                        int tx = idx.texcoord_index * 2;
+                        if (tx + 1 < attrib.texcoords.size()) {
+                            uv = glm::vec2(attrib.texcoords[tx + 0],
+                                           1.0f - attrib.texcoords[tx + 1]);
+                        }
                     }
-                }
 
-                vertices.push_back({ pos, norm, uv });
-                indices.push_back(static_cast<uint32_t>(i));
+                    vertices.push_back({ pos, norm, uv });
+                    indices.push_back(static_cast<uint32_t>(i));
+                }
             }
+        };
+        JobSystem::get().parallelFor(0, shapes.size(), 1, convertShapes);
 
-            if (vertices.empty()) {
+        auto* model = new Renderer::Model();
+
+        for (size_t s = 0; s < shapes.size(); ++s) {
+            if (shapeVertices[s].empty()) {
                 CORVUS_CORE_WARN("Skipping empty shape in OBJ: {}", path);
                 continue;
             }
 
-            Renderer::Mesh mesh = Renderer::Mesh::createFromVertices(*ctx, vertices, indices);
+            Renderer::Mesh mesh
+                = Renderer::Mesh::createFromVertices(*ctx, shapeVertices[s], shapeIndices[s]);
             model->addMesh(std::move(mesh));
         }
 
-        CORVUS_CORE_INFO("Loaded OBJ: {} ({} meshes)", path, model->getMeshes().size());
+        // Reduced copies for distant rendering, picked per frame by screen coverage
+        Renderer::MeshSimplifier::generateLods(*ctx, *model);
+
+        CORVUS_CORE_INFO("Loaded OBJ: {} ({} meshes, {} LODs)",
+                         path,
+                         model->getMeshes().size(),
+                         model->getLodCount());
         return model;
     }
 
@@ -4,89 +4,25 @@
 #include "asset_manager.hpp"
 #include "corvus/log.hpp"
 #include "corvus/scene.hpp"
-#include <cereal/archives/json.hpp>
-#include <physfs.h>
-#include <sstream>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <vector>
 
 namespace Corvus::Core {
 
+/**
+ * Saving takes a snapshot of the scene and writes it on a background thread, so the caller only
+ * pays for the snapshot. Binary scenes that were loaded or saved before append the records of
+ * changed entities instead of being rewritten, until the appended changes grow past half the
+ * file. Loading waits for a pending write first.
+ */
 class SceneLoader : public AssetLoader<Scene> {
 public:
-    Scene* loadTyped(const std::string& path) override {
-        PHYSFS_File* file = PHYSFS_openRead(path.c_str());
-        if (!file) {
-            CORVUS_CORE_ERROR("Failed to open scene file: {}", path);
-            return nullptr;
-        }
-
-        PHYSFS_sint64     fileSize = PHYSFS_fileLength(file);
-        std::vector<char> buffer(fileSize);
-        PHYSFS_readBytes(file, buffer.data(), fileSize);
-        PHYSFS_close(file);
-
-        try {
-            std::istringstream       iss(std::string(buffer.begin(), buffer.end()));
-            cereal::JSONInputArchive ar(iss);
-
-            Scene* scene = new Scene("Loading...", getAssetManager());
-            ar(cereal::make_nvp("scene", *scene));
-
-            CORVUS_CORE_INFO("Loaded scene: {}", scene->name);
-            return scene;
-        } catch (const std::exception& e) {
-            CORVUS_CORE_ERROR("Failed to parse scene file {}: {}", path, e.what());
-            return nullptr;
-        }
-    }
-
-    bool saveTyped(const Scene* scene, const std::string& path) override {
-        if (!scene) {
-            CORVUS_CORE_ERROR("Cannot save null scene");
-            return false;
-        }
-
-        try {
-            std::ostringstream oss;
-            {
-                cereal::JSONOutputArchive ar(oss);
-                ar(cereal::make_nvp("scene", *scene));
-            }
-            std::string data = oss.str();
-
-            // path is already the correct PhysFS path (e.g., "project/scenes/Hello.scene")
-            // For writes, we need to strip the mount alias prefix
-            std::string writePath = path;
-            size_t      slashPos  = writePath.find('/');
-            if (slashPos != std::string::npos) {
-                writePath = writePath.substr(slashPos + 1);
-            }
+    ~SceneLoader() override;
 
-            auto lastSlash = writePath.find_last_of('/');
-            if (lastSlash != std::string::npos) {
-                PHYSFS_mkdir(writePath.substr(0, lastSlash).c_str());
-            }
-
-            PHYSFS_File* file = PHYSFS_openWrite(writePath.c_str());
-            if (!file) {
-                CORVUS_CORE_ERROR("Failed to open scene for write: {}", writePath);
-                return false;
-            }
-
-            PHYSFS_sint64 written = PHYSFS_writeBytes(file, data.c_str(), data.size());
-            PHYSFS_close(file);
-
-            if (written != static_cast<PHYSFS_sint64>(data.size())) {
-                CORVUS_CORE_ERROR("Failed to write complete scene data: {}", path);
-                return false;
-            }
-
-            CORVUS_CORE_INFO("Scene saved: {} ({} bytes)", path, data.size());
-            return true;
-        } catch (const std::exception& e) {
-            CORVUS_CORE_ERROR("Failed to save scene {}: {}", path, e.what());
-            return false;
-        }
-    }
+    Scene* loadTyped(const std::string& path) override;
+    bool   saveTyped(const Scene* scene, const std::string& path) override;
 
     bool canCreate() const override { return true; }
 
@@ -103,6 +39,25 @@ public:
     }
 
     AssetType getType() const override { return AssetType::Scene; }
+
+    /**
+     * Block until the last save is on disk
+     */
+    void flush() override;
+
+private:
+    struct PendingWrite {
+        std::string       path; // PhysFS write path, without the mount alias
+        std::vector<char> data; // Binary scene or delta
+        bool              append = false;
+        bool              json   = false; // Convert the binary snapshot to JSON before writing
+    };
+
+    void write(const PendingWrite& pending);
+
+    std::mutex        writerMutex;
+    std::thread       writer;
+    std::atomic<bool> writeFailed { false };
 };
 
 }
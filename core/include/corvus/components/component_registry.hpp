@@ -1,11 +1,19 @@
 #pragma once
+#include "corvus/util/memory_stream.hpp"
+#include <cereal/archives/binary.hpp>
 #include <cereal/archives/json.hpp>
 #include <cereal/types/string.hpp>
 #include <cereal/types/unordered_map.hpp>
 #include <cereal/types/vector.hpp>
+#include <concepts>
+#include <cstring>
 #include <entt/entt.hpp>
 #include <functional>
+#include <memory>
+#include <span>
 #include <sstream>
+#include <string>
+#include <type_traits>
 #include <typeindex>
 
 namespace Corvus::Core::Components {
@@ -18,11 +26,145 @@ using DeserializerFunc
 
 using ComponentCheckerFunc = std::function<bool(entt::entity, entt::registry&)>;
 
+/**
+ * Version of a component's serialized form, declared with CEREAL_CLASS_VERSION between the
+ * component and its REGISTER_COMPONENT (0 if it never was). Saved data carries the version it was
+ * written with and gets it back on load, so a new field is a version bump and an if (version >= N)
+ * in serialize.
+ */
+template <typename T>
+uint32_t componentVersion() {
+    return cereal::detail::Version<T>::version;
+}
+
+/**
+ * Run a component's serialize with an explicit version. The registry stores the version itself,
+ * next to the component in JSON and per block or record in binary scenes, rather than leaving it
+ * to cereal which would require it in every file written before the component had one.
+ */
+template <typename Archive, typename T>
+void serializeComponentFields(Archive& ar, T& component, const uint32_t version) {
+    if constexpr (requires { component.serialize(ar, version); })
+        component.serialize(ar, version);
+    else
+        ar(component);
+}
+
+/**
+ * Trivially copyable components that can convert one element of an older raw block
+ */
+template <typename T>
+concept RawMigratable = requires(uint32_t version, std::span<const char> bytes, T& out) {
+    { T::migrateRaw(version, bytes, out) } -> std::same_as<bool>;
+};
+
+/**
+ * Every component of one type in a binary scene. Entities are stored as their position in the
+ * scene's entity order. Trivially copyable components are kept as raw bytes with their size as
+ * the stride, the others as a cereal binary archive with a stride of 0.
+ *
+ * Raw blocks are only copied back as they are when both version and stride match the component,
+ * otherwise its static migrateRaw(version, bytes, component) has to convert every element.
+ */
+struct ComponentBlock {
+    std::vector<uint32_t> indices;
+    std::vector<char>     data;
+    uint32_t              version = 0;
+    uint32_t              stride  = 0;
+};
+
+using EntityPositions = std::unordered_map<entt::entity, uint32_t>;
+
+using BlockWriterFunc
+    = std::function<void(entt::registry&, const EntityPositions&, ComponentBlock&)>;
+
+using BlockReaderFunc = std::function<bool(
+    entt::registry&, std::span<const entt::entity>, uint32_t, uint32_t, std::span<const char>)>;
+
 using TypeToNameMap   = std::unordered_map<std::type_index, std::string>;
 using NameToTypeMap   = std::unordered_map<std::string, std::type_index>;
 using SerializerMap   = std::unordered_map<std::type_index, SerializerFunc>;
 using DeserializerMap = std::unordered_map<std::string, DeserializerFunc>;
 using CheckerMap      = std::unordered_map<std::type_index, ComponentCheckerFunc>;
+using BlockWriterMap  = std::unordered_map<std::string, BlockWriterFunc>;
+using BlockReaderMap  = std::unordered_map<std::string, BlockReaderFunc>;
+
+/**
+ * Told about every add, patch and removal of a registered component once connected through
+ * ComponentRegistry::connectListener. Runs on the thread making the change.
+ */
+class ComponentListener {
+public:
+    virtual ~ComponentListener() = default;
+
+    virtual void onComponentChanged(entt::entity entity) = 0;
+};
+
+inline void
+notifyComponentListener(ComponentListener& listener, entt::registry&, const entt::entity entity) {
+    listener.onComponentChanged(entity);
+}
+
+/**
+ * Every component of one type copied out of a registry, for putting the registry back the way it
+ * was. Restoring moves the components back in, so a snapshot is restored once.
+ */
+class ComponentSnapshot {
+public:
+    virtual ~ComponentSnapshot() = default;
+
+    virtual void restore(entt::registry& registry) = 0;
+};
+
+template <typename T>
+class TypedComponentSnapshot final : public ComponentSnapshot {
+public:
+    explicit TypedComponentSnapshot(entt::registry& registry) {
+        auto view = registry.view<T>();
+        owners.assign(view.begin(), view.end());
+
+        if constexpr (std::is_trivially_copyable_v<T>) {
+            // Plain memory, default constructed once by resize and then copied over with memcpy
+            // rather than through the copy constructor
+            components.resize(owners.size());
+            for (size_t i = 0; i < owners.size(); ++i)
+                std::memcpy(&components[i], &view.template get<T>(owners[i]), sizeof(T));
+        } else {
+            components.reserve(owners.size());
+            for (const auto entity : owners)
+                components.push_back(view.template get<T>(entity));
+        }
+    }
+
+    void restore(entt::registry& registry) override {
+        registry.insert<T>(
+            owners.begin(), owners.end(), std::make_move_iterator(components.begin()));
+        owners.clear();
+        components.clear();
+    }
+
+private:
+    std::vector<entt::entity> owners;
+    std::vector<T>            components;
+};
+
+using BinarySerializerFunc
+    = std::function<bool(entt::entity, entt::registry&, std::string&, uint32_t&)>;
+
+using BinaryDeserializerFunc
+    = std::function<bool(entt::entity, entt::registry&, uint32_t, std::span<const char>)>;
+
+using RemoverFunc = std::function<void(entt::entity, entt::registry&)>;
+
+using ListenerConnectorFunc = std::function<void(entt::registry&, ComponentListener&, bool)>;
+
+using SnapshotFunc = std::function<std::unique_ptr<ComponentSnapshot>(entt::registry&)>;
+
+using BinarySerializerMap   = std::unordered_map<std::string, BinarySerializerFunc>;
+using BinaryDeserializerMap = std::unordered_map<std::string, BinaryDeserializerFunc>;
+using RemoverMap            = std::unordered_map<std::string, RemoverFunc>;
+using ListenerConnectorMap  = std::unordered_map<std::string, ListenerConnectorFunc>;
+using SnapshotMap           = std::unordered_map<std::string, SnapshotFunc>;
 
 /**
  * @class ComponentRegistry
@@ -44,6 +186,14 @@ class ComponentRegistry {
     SerializerMap   serializers;   ///< Functions to serialize components to JSON
     DeserializerMap deserializers; ///< Functions to deserialize components from JSON
     CheckerMap      checkers;      ///< Functions to check if entity has component
+    BlockWriterMap  blockWriters;  ///< Functions to write a whole component type as one block
+    BlockReaderMap  blockReaders;  ///< Functions to bulk insert a component block
+
+    BinarySerializerMap   binarySerializers;   ///< Functions to write one component as binary
+    BinaryDeserializerMap binaryDeserializers; ///< Functions to add or replace one from binary
+    RemoverMap            removers;            ///< Functions to remove a component from an entity
+    ListenerConnectorMap  listenerConnectors;  ///< Functions to (dis)connect change listeners
+    SnapshotMap           snapshots;           ///< Functions to copy out every component of a type
 
 public:
     /**
@@ -72,10 +222,21 @@ public:
                                   entt::registry&            registry,
                                   cereal::JSONOutputArchive& ar,
                                   const std::string&         name) {
-            if (registry.all_of<T>(entity)) {
-                auto& component = registry.get<T>(entity);
+            if (!registry.all_of<T>(entity))
+                return;
+
+            auto&          component = registry.get<T>(entity);
+            const uint32_t version   = componentVersion<T>();
+            if (version == 0) {
                 ar(cereal::make_nvp(name, component));
+                return;
             }
+
+            ar.setNextName(name.c_str());
+            ar.startNode();
+            ar(cereal::make_nvp("cereal_class_version", version));
+            serializeComponentFields(ar, component, version);
+            ar.finishNode();
         };
 
         // Deserializer reads component from the JSON archive and adds to entity
@@ -83,7 +244,22 @@ public:
                                              entt::registry&           registry,
                                              cereal::JSONInputArchive& ar) {
             T component;
-            ar(cereal::make_nvp(typeName, component));
+            if (componentVersion<T>() == 0) {
+                ar(cereal::make_nvp(typeName, component));
+            } else {
+                // Scenes written before the component had a version don't store one
+                ar.setNextName(typeName.c_str());
+                ar.startNode();
+                uint32_t    version = 0;
+                const char* next    = ar.getNodeName();
+                if (next && std::strcmp(next, "cereal_class_version") == 0)
+                    ar(cereal::make_nvp("cereal_class_version", version));
+                if (version > componentVersion<T>())
+                    throw cereal::Exception(typeName + " version " + std::to_string(version)
+                                            + " is newer than this build");
+                serializeComponentFields(ar, component, version);
+                ar.finishNode();
+            }
             registry.emplace<T>(entity, std::move(component));
         };
 
@@ -91,6 +267,137 @@ public:
         checkers[typeIdx] = [](const entt::entity entity, const entt::registry& registry) -> bool {
             return registry.all_of<T>(entity);
         };
+
+        // Block writer packs every component of this type in the scene one after another
+        blockWriters[typeName] = [](entt::registry&        registry,
+                                    const EntityPositions& positions,
+                                    ComponentBlock&        block) {
+            std::vector<entt::entity> owners;
+            for (const auto entity : registry.view<T>()) {
+                if (const auto it = positions.find(entity); it != positions.end()) {
+                    block.indices.push_back(it->second);
+                    owners.push_back(entity);
+                }
+            }
+
+            block.version = componentVersion<T>();
+            if constexpr (std::is_trivially_copyable_v<T>) {
+                block.stride = sizeof(T);
+                block.data.resize(owners.size() * sizeof(T));
+                for (size_t i = 0; i < owners.size(); ++i)
+                    std::memcpy(
+                        block.data.data() + i * sizeof(T), &registry.get<T>(owners[i]), sizeof(T));
+            } else {
+                block.stride = 0;
+                std::ostringstream stream;
+                {
+                    cereal::BinaryOutputArchive ar(stream);
+                    for (const auto entity : owners)
+                        serializeComponentFields(ar, registry.get<T>(entity), block.version);
+                }
+                const std::string bytes = stream.str();
+                block.data.assign(bytes.begin(), bytes.end());
+            }
+        };
+
+        // Block reader builds the components of a block and inserts them in one go
+        blockReaders[typeName] = [](entt::registry&                     registry,
+                                    const std::span<const entt::entity> owners,
+                                    const uint32_t                      version,
+                                    const uint32_t                      stride,
+                                    const std::span<const char>         data) -> bool {
+            if (version > componentVersion<T>())
+                return false;
+
+            std::vector<T> components(owners.size());
+
+            if constexpr (std::is_trivially_copyable_v<T>) {
+                if (stride == 0 || data.size() < owners.size() * stride)
+                    return false;
+
+                if (version == componentVersion<T>() && stride == sizeof(T)) {
+                    std::memcpy(components.data(), data.data(), owners.size() * sizeof(T));
+                } else if constexpr (RawMigratable<T>) {
+                    // Written by an older layout, converted one element at a time
+                    for (size_t i = 0; i < components.size(); ++i) {
+                        const auto element = data.subspan(i * stride, stride);
+                        if (!T::migrateRaw(version, element, components[i]))
+                            return false;
+                    }
+                } else {
+                    return false;
+                }
+            } else {
+                if (stride != 0)
+                    return false;
+                MemoryInputStream          stream(data);
+                cereal::BinaryInputArchive ar(stream);
+                for (auto& component : components)
+                    serializeComponentFields(ar, component, version);
+            }
+
+            registry.insert<T>(
+                owners.begin(), owners.end(), std::make_move_iterator(components.begin()));
+            return true;
+        };
+
+        // Binary serializer writes a single component, used for per entity records
+        binarySerializers[typeName] = [](const entt::entity entity,
+                                         entt::registry&    registry,
+                                         std::string&       out,
+                                         uint32_t&          version) {
+            if (!registry.all_of<T>(entity))
+                return false;
+
+            version = componentVersion<T>();
+            std::ostringstream stream;
+            {
+                cereal::BinaryOutputArchive ar(stream);
+                serializeComponentFields(ar, registry.get<T>(entity), version);
+            }
+            out = stream.str();
+            return true;
+        };
+
+        binaryDeserializers[typeName] = [](const entt::entity          entity,
+                                           entt::registry&             registry,
+                                           const uint32_t              version,
+                                           const std::span<const char> data) {
+            if (version > componentVersion<T>())
+                return false;
+
+            T component;
+            {
+                MemoryInputStream          stream(data);
+                cereal::BinaryInputArchive ar(stream);
+                serializeComponentFields(ar, component, version);
+            }
+            registry.emplace_or_replace<T>(entity, std::move(component));
+            return true;
+        };
+
+        removers[typeName] = [](const entt::entity entity, entt::registry& registry) {
+            registry.remove<T>(entity);
+        };
+
+        listenerConnectors[typeName]
+            = [](entt::registry& registry, ComponentListener& listener, const bool connect) {
+                  if (connect) {
+                      registry.on_construct<T>().template connect<&notifyComponentListener>(
+                          listener);
+                      registry.on_update<T>().template connect<&notifyComponentListener>(listener);
+                      registry.on_destroy<T>().template connect<&notifyComponentListener>(
+                          listener);
+                  } else {
+                      registry.on_construct<T>().disconnect(listener);
+                      registry.on_update<T>().disconnect(listener);
+                      registry.on_destroy<T>().disconnect(listener);
+                  }
+              };
+
+        snapshots[typeName] = [](entt::registry& registry) -> std::unique_ptr<ComponentSnapshot> {
+            return std::make_unique<TypedComponentSnapshot<T>>(registry);
+        };
     }
 
     /**
@@ -142,6 +449,86 @@ public:
      */
     bool hasComponent(std::type_index typeIdx, entt::entity entity, entt::registry& registry);
 
+    /**
+     * @brief Write every component of a type that belongs to the given entities as one block
+     * @param typeName The string name of the component type
+     * @param registry The registry containing the components
+     * @param positions Position of each saved entity in the scene's entity order
+     * @param block The block to fill
+     * @return False if the type is not registered
+     */
+    bool writeComponentBlock(const std::string&     typeName,
+                             entt::registry&        registry,
+                             const EntityPositions& positions,
+                             ComponentBlock&        block);
+
+    /**
+     * @brief Add the components of a block to their entities with a single range insert
+     * @param typeName The string name of the component type
+     * @param registry The registry to add the components to
+     * @param owners The entity of each component, in block order
+     * @param version The component version stored with the block
+     * @param stride The stride stored with the block
+     * @param data The component data of the block
+     * @return False if the type is unknown, or the block is of a newer version or of a layout
+     * that can't be migrated
+     */
+    bool readComponentBlock(const std::string&            typeName,
+                            entt::registry&               registry,
+                            std::span<const entt::entity> owners,
+                            uint32_t                      version,
+                            uint32_t                      stride,
+                            std::span<const char>         data);
+
+    /**
+     * @brief Serialize one component as a cereal binary archive
+     * @param typeName The string name of the component type
+     * @param entity The entity that owns the component
+     * @param registry The registry containing the component
+     * @param out Receives the archive
+     * @param version Receives the component version the archive was written with
+     * @return False if the type is unknown or the entity doesn't have it
+     */
+    bool serializeComponentBinary(const std::string& typeName,
+                                  entt::entity       entity,
+                                  entt::registry&    registry,
+                                  std::string&       out,
+                                  uint32_t&          version);
+
+    /**
+     * @brief Add a component from a binary archive, replacing the one the entity has
+     * @return False if the type is unknown or the archive is of a newer version
+     */
+    bool deserializeComponentBinary(const std::string&    typeName,
+                                    entt::entity          entity,
+                                    entt::registry&       registry,
+                                    uint32_t              version,
+                                    std::span<const char> data);
+
+    /**
+     * @brief Check if a component type is registered under this name
+     */
+    bool isRegistered(const std::string& typeName) const;
+
+    /**
+     * @brief Remove a component by type name, if the entity has it
+     */
+    void
+    removeComponent(const std::string& typeName, entt::entity entity, entt::registry& registry);
+
+    /**
+     * @brief Notify listener about changes to every registered component type of registry
+     */
+    void connectListener(entt::registry& registry, ComponentListener& listener);
+    void disconnectListener(entt::registry& registry, ComponentListener& listener);
+
+    /**
+     * @brief Copy every registered component out of a registry, one snapshot per type
+     * @param registry The registry to copy from
+     * @return Snapshots of the types the registry has any components of
+     */
+    std::vector<std::unique_ptr<ComponentSnapshot>> snapshotComponents(entt::registry& registry);
+
     /**
      * @brief Get all registered component type names
      * @return Vector of component name strings
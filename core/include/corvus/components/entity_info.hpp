@@ -15,7 +15,8 @@ class EntityInfoComponent {
 public:
     explicit EntityInfoComponent(std::string tag = "New entity", const bool enabled = true)
         : tag(std::move(tag)), enabled(enabled) {
-        boost::uuids::random_generator gen;
+        // Seeding a generator is far more expensive than drawing from one
+        static thread_local boost::uuids::random_generator gen;
         id = boost::uuids::to_string(gen());
     }
 
@@ -30,4 +31,10 @@ public:
 };
 
 REGISTER_COMPONENT(EntityInfoComponent, "EntityInfo");
+
+/**
+ * Present while EntityInfoComponent::enabled is false. The scene keeps it in sync, so disabled
+ * entities can be excluded from views and groups without reading the info of each one.
+ */
+struct DisabledTag { };
 }
@@ -2,6 +2,10 @@
 #include "cereal/cereal.hpp"
 #include "component_registry.hpp"
 #include "corvus/components/serializers.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
 // #include <raylib.h>
 
 namespace Corvus::Core::Components {
@@ -38,8 +42,13 @@ struct LightComponent {
     float shadowNearPlane = 0.1f;
     float shadowFarPlane  = 100.0f;
 
+    // Cascades of the primary directional light, at most CascadedShadowMap::MAX_CASCADES
+    int   cascadeCount       = 4;
+    float cascadeSplitLambda = 0.75f; // 0 uniform splits, 1 logarithmic splits
+
+    // Version 1 added the cascade settings
     template <class Archive>
-    void serialize(Archive& ar) {
+    void serialize(Archive& ar, const std::uint32_t version) {
         int lightTypeInt = static_cast<int>(type);
         ar(cereal::make_nvp("type", lightTypeInt));
         if constexpr (Archive::is_loading::value)
@@ -59,9 +68,37 @@ struct LightComponent {
         ar(cereal::make_nvp("shadowDistance", shadowDistance));
         ar(cereal::make_nvp("shadowNearPlane", shadowNearPlane));
         ar(cereal::make_nvp("shadowFarPlane", shadowFarPlane));
+
+        if (version >= 1) {
+            ar(cereal::make_nvp("cascadeCount", cascadeCount));
+            ar(cereal::make_nvp("cascadeSplitLambda", cascadeSplitLambda));
+        }
+    }
+
+    /**
+     * Raw blocks of binary scenes written before component versions, which may or may not have
+     * the cascade settings. They are the last fields, so the stride tells the two apart and the
+     * older layout keeps the defaults.
+     */
+    static bool migrateRaw(const std::uint32_t         version,
+                           const std::span<const char> bytes,
+                           LightComponent&             out) {
+        if (version != 0)
+            return false;
+
+        if (bytes.size() == sizeof(LightComponent)
+            || bytes.size() == offsetof(LightComponent, cascadeCount)) {
+            std::memcpy(&out, bytes.data(), bytes.size());
+            return true;
+        }
+        return false;
     }
 };
 
-REGISTER_COMPONENT(LightComponent, "Light");
+}
+
+CEREAL_CLASS_VERSION(Corvus::Core::Components::LightComponent, 1);
 
+namespace Corvus::Core::Components {
+REGISTER_COMPONENT(LightComponent, "Light");
 }
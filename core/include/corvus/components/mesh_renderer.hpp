@@ -25,9 +25,11 @@ struct MeshRendererComponent {
     AssetHandle<Renderer::Model> modelHandle;
     AssetHandle<MaterialAsset>   materialHandle;
     bool                         renderWireframe = false;
+    bool                         castShadows     = true;
+    bool                         isStatic        = false; // Never moves, merged into static batches
 
-    // Cached generated primitive
-    std::unique_ptr<Renderer::Model> generatedModel;
+    // Cached generated primitive, shared by copies since it is only ever replaced, never modified
+    std::shared_ptr<Renderer::Model> generatedModel;
     bool                             hasGeneratedModel = false;
 
     // Primitive parameters
@@ -61,8 +63,8 @@ struct MeshRendererComponent {
         hasGeneratedModel = false;
     }
 
-    MeshRendererComponent(const MeshRendererComponent&)            = delete;
-    MeshRendererComponent& operator=(const MeshRendererComponent&) = delete;
+    MeshRendererComponent(const MeshRendererComponent&)            = default;
+    MeshRendererComponent& operator=(const MeshRendererComponent&) = default;
 
     MeshRendererComponent(MeshRendererComponent&& other) noexcept { *this = std::move(other); }
 
@@ -75,13 +77,16 @@ struct MeshRendererComponent {
             hasGeneratedModel       = other.hasGeneratedModel;
             params                  = other.params;
             renderWireframe         = other.renderWireframe;
+            castShadows             = other.castShadows;
+            isStatic                = other.isStatic;
             other.hasGeneratedModel = false;
         }
         return *this;
     }
 
+    // Version 1 added cast_shadows, 2 static
     template <class Archive>
-    void serialize(Archive& ar) {
+    void serialize(Archive& ar, const std::uint32_t version) {
         int primitiveTypeInt = static_cast<int>(primitiveType);
         ar(CEREAL_NVP(primitiveTypeInt));
         if constexpr (Archive::is_loading::value)
@@ -91,6 +96,11 @@ struct MeshRendererComponent {
         ar(cereal::make_nvp("material_handle", materialHandle));
         ar(cereal::make_nvp("render_wireframe", renderWireframe));
 
+        if (version >= 1)
+            ar(cereal::make_nvp("cast_shadows", castShadows));
+        if (version >= 2)
+            ar(cereal::make_nvp("static", isStatic));
+
         switch (primitiveType) {
             case PrimitiveType::Cube:
                 ar(CEREAL_NVP(params.cube.size));
@@ -114,9 +124,6 @@ struct MeshRendererComponent {
     }
 
     void generateModel(Graphics::GraphicsContext& ctx) {
-        generatedModel.reset();
-        hasGeneratedModel = false;
-
         Renderer::Model model;
         switch (primitiveType) {
             case PrimitiveType::Cube:
@@ -135,10 +142,14 @@ struct MeshRendererComponent {
                     ctx, params.cylinder.radius, params.cylinder.height, params.cylinder.slices);
                 break;
             default:
+                generatedModel.reset();
+                hasGeneratedModel = false;
                 return;
         }
 
-        generatedModel    = std::make_unique<Renderer::Model>(std::move(model));
+        // Replaced only once the new model exists so it never reuses the old address, caches keyed
+        // on the model pointer (static batches, shadow casters) then see the change
+        generatedModel    = std::make_shared<Renderer::Model>(std::move(model));
         hasGeneratedModel = true;
     }
 
@@ -214,6 +225,10 @@ struct MeshRendererComponent {
     }
 };
 
-REGISTER_COMPONENT(MeshRendererComponent, "MeshRenderer");
+}
+
+CEREAL_CLASS_VERSION(Corvus::Core::Components::MeshRendererComponent, 2);
 
+namespace Corvus::Core::Components {
+REGISTER_COMPONENT(MeshRendererComponent, "MeshRenderer");
 }
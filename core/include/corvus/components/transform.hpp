@@ -50,4 +50,35 @@ struct TransformComponent {
 
 REGISTER_COMPONENT(TransformComponent, "Transform");
 
+/**
+ * Makes the transform relative to another entity, named by its EntityInfo id so the link survives
+ * saving and loading. A parent that does not exist leaves the entity at the root.
+ */
+struct ParentComponent {
+    std::string parent;
+
+    template <class Archive>
+    void serialize(Archive& ar) {
+        ar(cereal::make_nvp("parent", parent));
+    }
+};
+
+REGISTER_COMPONENT(ParentComponent, "Parent");
+
+/**
+ * Local to world matrix, written by the scene's TransformHierarchy and never serialized. Edits
+ * go to the TransformComponent.
+ */
+struct WorldTransformComponent {
+    glm::mat4 matrix = glm::mat4(1.0f);
+
+    glm::vec3 getPosition() const { return glm::vec3(matrix[3]); }
+
+    glm::vec3 getScale() const {
+        return { glm::length(glm::vec3(matrix[0])),
+                 glm::length(glm::vec3(matrix[1])),
+                 glm::length(glm::vec3(matrix[2])) };
+    }
+};
+
 }
@@ -27,6 +27,15 @@ public:
         return getRegistry().get<T>(entityHandle);
     }
 
+    /**
+     * Edit a component through the registry so observers (the scene's render world) see it.
+     * Changes made through getComponent need a patch afterwards, the functions are optional.
+     */
+    template <typename T, typename... Func>
+    T& patchComponent(Func&&... func) {
+        return getRegistry().patch<T>(entityHandle, std::forward<Func>(func)...);
+    }
+
     template <typename T>
     bool hasComponent() const {
         return getRegistry().all_of<T>(entityHandle);
@@ -0,0 +1,90 @@
+#pragma once
+
+#include "corvus/entity.hpp"
+#include <cstdint>
+#include <iterator>
+#include <unordered_map>
+#include <vector>
+
+namespace Corvus::Core {
+
+/**
+ * Entities in a stable order with constant time removal. Removing leaves a hole that iteration
+ * skips, so erasing never invalidates iterators. Holes are squeezed out by the next push_back once
+ * they make up half the list, the order is never shuffled.
+ */
+class EntityList {
+public:
+    template <typename Value, typename Slots>
+    class Iterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type        = Entity;
+        using difference_type   = std::ptrdiff_t;
+        using pointer           = Value*;
+        using reference         = Value&;
+
+        Iterator() = default;
+        Iterator(Slots* slots, const size_t index) : slots_(slots), index_(index) { skipHoles(); }
+
+        reference operator*() const { return (*slots_)[index_]; }
+        pointer   operator->() const { return &(*slots_)[index_]; }
+
+        Iterator& operator++() {
+            ++index_;
+            skipHoles();
+            return *this;
+        }
+
+        Iterator operator++(int) {
+            Iterator previous = *this;
+            ++*this;
+            return previous;
+        }
+
+        bool operator==(const Iterator& other) const { return index_ == other.index_; }
+        bool operator!=(const Iterator& other) const { return index_ != other.index_; }
+
+    private:
+        void skipHoles() {
+            while (index_ < slots_->size() && !(*slots_)[index_])
+                ++index_;
+        }
+
+        Slots* slots_ = nullptr;
+        size_t index_ = 0;
+    };
+
+    using iterator       = Iterator<Entity, std::vector<Entity>>;
+    using const_iterator = Iterator<const Entity, const std::vector<Entity>>;
+
+    void push_back(const Entity& entity);
+
+    /**
+     * Drop an entity, returns false if it was not in the list. Iterators stay valid.
+     */
+    bool erase(const Entity& entity);
+    void clear();
+
+    bool   contains(const Entity& entity) const;
+    size_t size() const { return indices_.size(); }
+    bool   empty() const { return indices_.empty(); }
+
+    /**
+     * Live entities in order, without holes
+     */
+    std::vector<Entity> toVector() const;
+
+    iterator       begin() { return { &slots_, 0 }; }
+    iterator       end() { return { &slots_, slots_.size() }; }
+    const_iterator begin() const { return { &slots_, 0 }; }
+    const_iterator end() const { return { &slots_, slots_.size() }; }
+
+private:
+    void compact();
+
+    std::vector<Entity>                        slots_; // Holes are null entities
+    std::unordered_map<entt::entity, uint32_t> indices_;
+};
+
+}
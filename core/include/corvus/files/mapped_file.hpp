@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <span>
+#include <string>
+
+namespace Corvus::Core {
+
+/**
+ * Read only memory mapping of a file on disk. The pages are only read in as they are touched, so
+ * large files are not copied up front.
+ */
+class MappedFile {
+public:
+    /**
+     * Map a file by its operating system path, nullptr if it can't be opened or mapped
+     */
+    static std::unique_ptr<MappedFile> open(const std::string& path);
+
+    /**
+     * Map a file by its PhysFS path. Files that are not plain files on disk (inside an archive)
+     * can't be mapped and give nullptr, read those through PhysFS instead.
+     */
+    static std::unique_ptr<MappedFile> openPhysFS(const std::string& path);
+
+    ~MappedFile();
+
+    MappedFile(const MappedFile&)            = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    const char*           data() const { return data_; }
+    size_t                size() const { return size_; }
+    std::span<const char> bytes() const { return { data_, size_ }; }
+
+private:
+    MappedFile() = default;
+
+    const char* data_ = nullptr;
+    size_t      size_ = 0;
+
+#if defined(_WIN32)
+    void* file_    = nullptr;
+    void* mapping_ = nullptr;
+#endif
+};
+
+}
@@ -25,6 +25,20 @@ enum class PrimitiveType {
     Points
 };
 
+// Comparison used by the depth test
+enum class DepthFunc {
+    Less,
+    LessEqual,
+    Equal,
+    Always
+};
+
+// How blended fragments combine with the target
+enum class BlendFunc {
+    Alpha,              // Straight alpha over the destination
+    WeightedAccumulate, // Additive color, alpha multiplies destination alpha by 1 - source alpha
+};
+
 enum class ResourceType {
     VBO,
     IBO,
@@ -32,9 +46,55 @@ enum class ResourceType {
     Shader,
     Tex2D,
     TexCube,
-    FBO
+    FBO,
+    SSBO,
+    Readback,
+    TexBuffer,
+    Tex2DArray
+};
+
+// Access qualifier for image load/store bindings
+enum class ImageAccess {
+    ReadOnly,
+    WriteOnly,
+    ReadWrite
+};
+
+// Texel format used when binding a texture as an image or backing a buffer texture
+enum class ImageFormat {
+    RGBA8,
+    RGBA16F,
+    RGBA32F,
+    R32F,
+    R32UI
+};
+
+// Pixel layout requested from an asynchronous framebuffer readback
+enum class PixelFormat {
+    RGBA8,
+    RGBA32F,
+    R32UI,
+    Depth32F
+};
+
+// Memory barrier bits, combined with operator| when recording a barrier
+enum class BarrierBits : uint32_t {
+    VertexAttribArray = 1u << 0,
+    ElementArray      = 1u << 1,
+    Uniform           = 1u << 2,
+    TextureFetch      = 1u << 3,
+    ShaderImageAccess = 1u << 4,
+    Command           = 1u << 5,
+    BufferUpdate      = 1u << 6,
+    Framebuffer       = 1u << 7,
+    ShaderStorage     = 1u << 8,
+    All               = 0xFFFFFFFFu
 };
 
+inline BarrierBits operator|(BarrierBits a, BarrierBits b) {
+    return static_cast<BarrierBits>(static_cast<uint32_t>(a) | static_cast<uint32_t>(b));
+}
+
 // Forward declarations
 class Window;
 struct VertexBuffer;
@@ -43,7 +103,11 @@ struct VertexArray;
 struct Shader;
 struct Texture2D;
 struct TextureCube;
+struct Texture2DArray;
 struct Framebuffer;
+struct StorageBuffer;
+struct TextureBuffer;
+struct PixelReadback;
 struct CommandBuffer;
 class GraphicsContext;
 
@@ -74,7 +138,23 @@ struct Command {
         SetShaderUniformVec4,
         SetShaderUniformVec2,
         SetDepthMask,
-        SetLineWidth
+        SetLineWidth,
+        SetClipDistances,
+        SetDepthFunc,
+        SetColorMask,
+        SetBlendFunc,
+        BlitFramebuffer,
+        UpdateStorageBuffer,
+        BindStorageBuffer,
+        BindImageTexture,
+        Dispatch,
+        MemoryBarrier,
+        ReadPixels,
+        PushDebugGroup,
+        PopDebugGroup,
+        UpdateTextureBuffer,
+        BindTextureBuffer,
+        BindTextureArray
     };
 
     Type type;
@@ -105,6 +185,7 @@ struct Command {
         bool          index16;
         uint32_t      offset;
         PrimitiveType mode;
+        uint32_t      instanceCount = 1;
     };
 
     struct FramebufferData {
@@ -136,6 +217,25 @@ struct Command {
         float width;
     };
 
+    struct ClipDistanceData {
+        uint32_t count;
+    };
+
+    struct DepthFuncData {
+        DepthFunc func;
+    };
+
+    struct BlendFuncData {
+        BlendFunc func;
+    };
+
+    struct BlitFramebufferData {
+        uint32_t srcFb, srcWidth, srcHeight;
+        uint32_t dstFb, dstWidth, dstHeight;
+        bool     color;
+        bool     depth;
+    };
+
     struct ScissorData {
         uint32_t x, y, w, h;
     };
@@ -192,6 +292,47 @@ struct Command {
         float       vec[2];
     };
 
+    struct UpdateStorageBufferData {
+        uint32_t             sbId;
+        uint32_t             offset;
+        std::vector<uint8_t> data;
+    };
+
+    struct BindStorageBufferData {
+        uint32_t slot, sbId;
+    };
+
+    struct BindImageTextureData {
+        uint32_t    unit, texId, level;
+        ImageAccess access;
+        ImageFormat format;
+    };
+
+    struct DispatchData {
+        uint32_t x, y, z;
+    };
+
+    struct MemoryBarrierData {
+        BarrierBits barriers;
+    };
+
+    struct ReadPixelsData {
+        uint32_t    readbackId;
+        uint32_t    fbId;
+        uint32_t    x, y, w, h;
+        PixelFormat format;
+        uint32_t    attachment;
+    };
+
+    struct DebugGroupData {
+        std::string name;
+    };
+
+    struct UpdateTextureBufferData {
+        uint32_t             texId;
+        std::vector<uint8_t> data;
+    };
+
     std::variant<ViewportData,
                  ShaderData,
                  VAOData,
@@ -212,7 +353,19 @@ struct Command {
                  SetShaderUniformVec2Data,
                  DepthMaskData,
                  LineWidthData,
+                 ClipDistanceData,
+                 DepthFuncData,
+                 BlendFuncData,
+                 BlitFramebufferData,
                  FaceCullingData,
+                 UpdateStorageBufferData,
+                 BindStorageBufferData,
+                 BindImageTextureData,
+                 DispatchData,
+                 MemoryBarrierData,
+                 ReadPixelsData,
+                 DebugGroupData,
+                 UpdateTextureBufferData,
                  std::monostate>
         data;
 };
@@ -241,10 +394,23 @@ public:
 
     // Shader
     virtual Shader shaderCreate(const std::string& vs, const std::string& fs) = 0;
-    virtual void   shaderDestroy(uint32_t id)                                 = 0;
+    virtual Shader
+    shaderCreateGeometry(const std::string& vs, const std::string& gs, const std::string& fs)
+        = 0;
+    virtual Shader shaderCreateCompute(const std::string& cs) = 0;
+    virtual void   shaderDestroy(uint32_t id)                 = 0;
+
+    // Storage buffer (SSBO)
+    virtual StorageBuffer sbCreate(const void* data, uint32_t size)                         = 0;
+    virtual void          sbGetData(uint32_t id, void* out, uint32_t size, uint32_t offset) = 0;
+    virtual void          sbDestroy(uint32_t id)                                            = 0;
+
+    // Buffer texture (samplerBuffer), a linear buffer fetched through texelFetch
+    virtual TextureBuffer texBufferCreate(ImageFormat format, const void* data, uint32_t size) = 0;
+    virtual void          texBufferDestroy(uint32_t id)                                        = 0;
 
     // Texture
-    virtual Texture2D tex2DCreate(uint32_t w, uint32_t h)                             = 0;
+    virtual Texture2D tex2DCreate(uint32_t w, uint32_t h, ImageFormat format)         = 0;
     virtual Texture2D tex2DCreateDepth(uint32_t w, uint32_t h)                        = 0;
     virtual void      tex2DSetData(uint32_t id, const void* data, uint32_t sizeBytes) = 0;
     virtual void      tex2DDestroy(uint32_t id)                                       = 0;
@@ -255,6 +421,9 @@ public:
         = 0;
     virtual void texCubeDestroy(uint32_t id) = 0;
 
+    virtual Texture2DArray tex2DArrayCreateDepth(uint32_t w, uint32_t h, uint32_t layers) = 0;
+    virtual void           tex2DArrayDestroy(uint32_t id)                                 = 0;
+
     // Command buffer + draw
     virtual CommandBuffer cmdCreate()                                                        = 0;
     virtual void          cmdBegin(uint32_t id)                                              = 0;
@@ -273,12 +442,29 @@ public:
                                     uint32_t                   texID,
                                     std::optional<std::string> uniformName = std::nullopt)
         = 0;
+    virtual void cmdBindTextureBuffer(uint32_t                   cmdID,
+                                      uint32_t                   slot,
+                                      uint32_t                   texID,
+                                      std::optional<std::string> uniformName = std::nullopt)
+        = 0;
+    virtual void cmdBindTextureArray(uint32_t                   cmdID,
+                                     uint32_t                   slot,
+                                     uint32_t                   texID,
+                                     std::optional<std::string> uniformName = std::nullopt)
+        = 0;
     virtual void cmdDrawIndexed(uint32_t      id,
                                 uint32_t      elemCount,
                                 bool          index16,
                                 uint32_t      indexOffset = 0,
                                 PrimitiveType primitive   = PrimitiveType::Triangles)
         = 0;
+    virtual void cmdDrawIndexedInstanced(uint32_t      id,
+                                         uint32_t      elemCount,
+                                         bool          index16,
+                                         uint32_t      instanceCount,
+                                         uint32_t      indexOffset = 0,
+                                         PrimitiveType primitive   = PrimitiveType::Triangles)
+        = 0;
 
     // Framebuffer
     virtual Framebuffer fbCreate(uint32_t width, uint32_t height)                             = 0;
@@ -286,6 +472,8 @@ public:
     virtual void        fbAttachTextureCubeFace(uint32_t fbID, uint32_t texID, int faceIndex) = 0;
     virtual void        fbDestroy(uint32_t fbID)                                              = 0;
     virtual void        fbAttachDepthTexture(uint32_t fbID, uint32_t texID)                   = 0;
+    virtual void fbAttachDepthTextureLayer(uint32_t fbID, uint32_t texID, uint32_t layer)     = 0;
+    virtual void fbAttachDepthTextureCube(uint32_t fbID, uint32_t texID)                      = 0;
 
     virtual void cmdBindFramebuffer(uint32_t cmdID, uint32_t fbID, uint32_t width, uint32_t height)
         = 0;
@@ -316,6 +504,9 @@ public:
     virtual void cmdUpdateIndexBuffer(
         uint32_t cmdID, uint32_t iboID, const void* data, uint32_t count, bool index16)
         = 0;
+    virtual void
+    cmdUpdateTextureBuffer(uint32_t cmdID, uint32_t texID, const void* data, uint32_t size)
+        = 0;
 
     // Shader uniforms (deferred)
     virtual void
@@ -341,6 +532,50 @@ public:
 
     virtual void cmdSetLineWidth(uint32_t cmdId, float width) = 0;
 
+    virtual void cmdSetClipDistances(uint32_t cmdId, uint32_t count) = 0;
+
+    virtual void cmdSetDepthFunc(uint32_t cmdId, DepthFunc func) = 0;
+
+    virtual void cmdSetColorMask(uint32_t cmdId, bool enable) = 0;
+
+    virtual void cmdSetBlendFunc(uint32_t cmdId, BlendFunc func) = 0;
+
+    virtual void cmdBlitFramebuffer(uint32_t cmdId, const Command::BlitFramebufferData& blit) = 0;
+
+    // Compute (deferred)
+    virtual void cmdUpdateStorageBuffer(
+        uint32_t cmdID, uint32_t sbID, const void* data, uint32_t size, uint32_t offset = 0)
+        = 0;
+    virtual void cmdBindStorageBuffer(uint32_t cmdID, uint32_t slot, uint32_t sbID) = 0;
+    virtual void cmdBindImageTexture(uint32_t    cmdID,
+                                     uint32_t    unit,
+                                     uint32_t    texID,
+                                     ImageAccess access,
+                                     ImageFormat format,
+                                     uint32_t    level = 0)
+        = 0;
+    virtual void cmdDispatch(uint32_t cmdID, uint32_t x, uint32_t y, uint32_t z) = 0;
+    virtual void cmdMemoryBarrier(uint32_t cmdID, BarrierBits barriers)          = 0;
+
+    // Asynchronous readback, resolved by the backend a frame or more after submission
+    virtual PixelReadback cmdReadPixelsAsync(uint32_t    cmdID,
+                                             uint32_t    fbID,
+                                             uint32_t    x,
+                                             uint32_t    y,
+                                             uint32_t    w,
+                                             uint32_t    h,
+                                             PixelFormat format,
+                                             uint32_t    attachment = 0)
+        = 0;
+    virtual bool readbackReady(uint32_t id) const                              = 0;
+    virtual bool readbackGetData(uint32_t id, std::vector<uint8_t>& out) const = 0;
+    virtual void readbackDestroy(uint32_t id)                                  = 0;
+
+    // Debug markers for external GL tools, prefer the CORVUS_GPU_* macros so they compile out
+    virtual void cmdPushDebugGroup(uint32_t cmdID, const char* name)               = 0;
+    virtual void cmdPopDebugGroup(uint32_t cmdID)                                  = 0;
+    virtual void setObjectLabel(ResourceType type, uint32_t id, const char* label) = 0;
+
     /**
      * Enqueue a deferred deletion task, done to prevent deferred commands from using deleted
      * resources.
@@ -402,6 +637,7 @@ struct VertexBuffer : HandleBase {
     uint32_t sizeBytes { 0 };
 
     void setData(CommandBuffer& cmd, const void* data, uint32_t size);
+    void setLabel(const char* label) const;
     void release();
 };
 
@@ -410,12 +646,14 @@ struct IndexBuffer : HandleBase {
     bool     index16 { true };
 
     void setData(CommandBuffer& cmd, const void* indices, uint32_t newCount, bool is16 = true);
+    void setLabel(const char* label) const;
     void release();
 };
 
 struct VertexArray : HandleBase {
     void addVertexBuffer(const VertexBuffer& vb, const VertexBufferLayout& layout) const;
     void setIndexBuffer(const IndexBuffer& ib) const;
+    void setLabel(const char* label) const;
     void release();
 };
 
@@ -428,6 +666,7 @@ struct Shader : HandleBase {
     void setVec3(CommandBuffer& cmd, const char* name, const glm::vec3& v);
     void setVec2(CommandBuffer& cmd, const char* name, const glm::vec2& v);
     void setVec4(CommandBuffer& cmd, const char* name, const glm::vec4& v);
+    void setLabel(const char* label) const;
     void release();
 };
 
@@ -436,12 +675,32 @@ struct Texture2D : HandleBase {
 
     void     setData(const void* data, uint32_t sizeBytes);
     uint64_t getNativeHandle() const { return id; }
+    void     setLabel(const char* label) const;
     void     release();
 };
 
 struct TextureCube : HandleBase {
     uint32_t resolution { 0 };
 
+    void setLabel(const char* label) const;
+    void release();
+};
+
+struct Texture2DArray : HandleBase {
+    uint32_t width { 0 };
+    uint32_t height { 0 };
+    uint32_t layers { 0 };
+
+    void setLabel(const char* label) const;
+    void release();
+};
+
+struct TextureBuffer : HandleBase {
+    uint32_t    sizeBytes { 0 };
+    ImageFormat format { ImageFormat::RGBA32F };
+
+    void setData(CommandBuffer& cmd, const void* data, uint32_t size);
+    void setLabel(const char* label) const;
     void release();
 };
 
@@ -449,10 +708,49 @@ struct Framebuffer : HandleBase {
     uint32_t width { 0 };
     uint32_t height { 0 };
 
+    // Fragment output location N writes to attachment N, all attached targets are drawn to
     void attachTexture2D(const Texture2D& tex, uint32_t attachment = 0);
     void attachTextureCubeFace(const TextureCube& tex, int faceIndex);
     void attachDepthTexture(const Texture2D& tex);
+    void attachDepthTextureLayer(const Texture2DArray& tex, uint32_t layer);
+    // Attaches all six faces for layered rendering, the geometry stage selects via gl_Layer
+    void attachDepthTextureCube(const TextureCube& tex);
     void bind(uint32_t cmdID) const;
+    void setLabel(const char* label) const;
+    void release();
+};
+
+struct StorageBuffer : HandleBase {
+    uint32_t sizeBytes { 0 };
+
+    /**
+     * Write size bytes at offset when the command buffer executes. Writes inside the buffer
+     * only touch those bytes, a write at offset 0 does not shrink it. A write past the end grows
+     * the buffer to offset + size, keeping the existing contents, and anything between the old
+     * end and offset is undefined.
+     */
+    void setData(CommandBuffer& cmd, const void* data, uint32_t size, uint32_t offset = 0);
+
+    /**
+     * Read the buffer contents back to the CPU immediately. Stalls until all pending GPU writes
+     * are complete, only use for tooling and debugging.
+     */
+    void getData(void* out, uint32_t size, uint32_t offset = 0) const;
+    void setLabel(const char* label) const;
+    void release();
+};
+
+/**
+ * Future-like handle for an asynchronous framebuffer readback. The pixels are copied into a pixel
+ * pack buffer when the command buffer executes and become available once the GPU fence signals,
+ * usually one or two frames later. Poll ready() instead of waiting.
+ */
+struct PixelReadback : HandleBase {
+    uint32_t    width { 0 }, height { 0 };
+    PixelFormat format { PixelFormat::RGBA8 };
+
+    bool ready() const;
+    bool getData(std::vector<uint8_t>& out) const;
     void release();
 };
 
@@ -470,10 +768,22 @@ struct CommandBuffer : HandleBase {
     void bindTextureCube(uint32_t                   slot,
                          const TextureCube&         t,
                          std::optional<std::string> uniformName = std::nullopt);
+    void bindTextureBuffer(uint32_t                   slot,
+                           const TextureBuffer&       t,
+                           std::optional<std::string> uniformName = std::nullopt);
+    void bindTextureArray(uint32_t                   slot,
+                          const Texture2DArray&      t,
+                          std::optional<std::string> uniformName = std::nullopt);
     void drawIndexed(uint32_t      elemCount,
                      bool          index16,
                      uint32_t      indexOffset = 0,
                      PrimitiveType primitive   = PrimitiveType::Triangles);
+    // Shaders tell instances apart through gl_InstanceID
+    void drawIndexedInstanced(uint32_t      elemCount,
+                              bool          index16,
+                              uint32_t      instanceCount,
+                              uint32_t      indexOffset = 0,
+                              PrimitiveType primitive   = PrimitiveType::Triangles);
     void bindFramebuffer(const Framebuffer& fb);
     void unbindFramebuffer();
     void
@@ -485,6 +795,17 @@ struct CommandBuffer : HandleBase {
     void enableScissor(bool enable);
     void setDepthMask(bool enable);
     void setLineWidth(float width);
+    // Enables gl_ClipDistance[0..count), 0 disables user clipping
+    void setClipDistances(uint32_t count);
+    void setDepthFunc(DepthFunc func);
+    // Disabling color writes leaves only depth (and stencil) writes, for depth-only passes
+    void setColorMask(bool enable);
+    // Stays in effect across setBlendState until changed again
+    void setBlendFunc(BlendFunc func);
+    // Copies color and/or depth, scaling when sizes differ. Leaves dst bound as the target.
+    void blitFramebuffer(const Framebuffer& src, const Framebuffer& dst, bool color, bool depth);
+    void pushDebugGroup(const char* name);
+    void popDebugGroup();
     void release();
 
     // User callbacks
@@ -497,6 +818,7 @@ struct CommandBuffer : HandleBase {
     // Buffer updates (deferred)
     void updateVertexBuffer(const VertexBuffer& vb, const void* data, uint32_t size);
     void updateIndexBuffer(const IndexBuffer& ib, const void* data, uint32_t count, bool index16);
+    void updateTextureBuffer(const TextureBuffer& tb, const void* data, uint32_t size);
 
     // Shader uniforms (deferred)
     void setShaderUniformMat4(const Shader& shader, const char* name, const float* m16);
@@ -505,6 +827,29 @@ struct CommandBuffer : HandleBase {
     void setShaderUniformVec3(const Shader& shader, const char* name, const float* vec3);
     void setShaderUniformVec4(const Shader& shader, const char* name, const float* vec4);
     void setShaderUniformVec2(const Shader& shader, const char* name, const float* vec2);
+
+    // Compute
+    void updateStorageBuffer(const StorageBuffer& sb,
+                             const void*          data,
+                             uint32_t             size,
+                             uint32_t             offset = 0);
+    void bindStorageBuffer(uint32_t slot, const StorageBuffer& sb);
+    void bindImageTexture(uint32_t         unit,
+                          const Texture2D& t,
+                          ImageAccess      access,
+                          ImageFormat      format,
+                          uint32_t         level = 0);
+    void dispatch(uint32_t x, uint32_t y = 1, uint32_t z = 1);
+    void memoryBarrier(BarrierBits barriers);
+
+    // Readback
+    PixelReadback readPixelsAsync(const Framebuffer& fb,
+                                  uint32_t           x,
+                                  uint32_t           y,
+                                  uint32_t           w,
+                                  uint32_t           h,
+                                  PixelFormat        format     = PixelFormat::RGBA8,
+                                  uint32_t           attachment = 0);
 };
 
 // Graphics context
@@ -528,11 +873,20 @@ public:
     virtual IndexBuffer   createIndexBuffer(const void* indices, uint32_t count, bool index16) = 0;
     virtual VertexArray   createVertexArray()                                                  = 0;
     virtual Shader        createShader(const std::string& vs, const std::string& fs)           = 0;
+    virtual Shader
+    createShader(const std::string& vs, const std::string& gs, const std::string& fs) = 0;
     virtual Texture2D     createTexture2D(uint32_t w, uint32_t h)                              = 0;
+    virtual Texture2D     createTexture2D(uint32_t w, uint32_t h, ImageFormat format)          = 0;
     virtual Texture2D     createDepthTexture(uint32_t width, uint32_t height)                  = 0;
+    virtual Texture2DArray
+    createDepthTextureArray(uint32_t width, uint32_t height, uint32_t layers) = 0;
     virtual TextureCube   createTextureCube(uint32_t resolution)                               = 0;
     virtual CommandBuffer createCommandBuffer()                                                = 0;
     virtual Framebuffer   createFramebuffer(uint32_t width, uint32_t height)                   = 0;
+    virtual Shader        createComputeShader(const std::string& cs)                           = 0;
+    virtual StorageBuffer createStorageBuffer(const void* data, uint32_t size)                 = 0;
+    virtual TextureBuffer
+    createTextureBuffer(ImageFormat format, const void* data, uint32_t size) = 0;
 
     virtual GraphicsAPI getAPI() const = 0;
 
@@ -568,3 +922,14 @@ inline void VertexBufferLayout::push<uint8_t>(uint32_t count) {
 }
 
 }
+
+// GPU debug markers and object labels, compiled out of non-debug builds
+#ifdef CORVUS_DEBUG
+#define CORVUS_GPU_PUSH_GROUP(cmd, name) (cmd).pushDebugGroup(name)
+#define CORVUS_GPU_POP_GROUP(cmd)        (cmd).popDebugGroup()
+#define CORVUS_GPU_LABEL(handle, label)  (handle).setLabel(label)
+#else
+#define CORVUS_GPU_PUSH_GROUP(cmd, name) ((void)0)
+#define CORVUS_GPU_POP_GROUP(cmd)        ((void)0)
+#define CORVUS_GPU_LABEL(handle, label)  ((void)0)
+#endif
@@ -31,10 +31,23 @@ public:
 
     // Shader
     Shader shaderCreate(const std::string& vs, const std::string& fs) override;
+    Shader shaderCreateGeometry(const std::string& vs,
+                                const std::string& gs,
+                                const std::string& fs) override;
+    Shader shaderCreateCompute(const std::string& cs) override;
     void   shaderDestroy(uint32_t id) override;
 
+    // Storage buffer
+    StorageBuffer sbCreate(const void* data, uint32_t size) override;
+    void          sbGetData(uint32_t id, void* out, uint32_t size, uint32_t offset) override;
+    void          sbDestroy(uint32_t id) override;
+
+    // Buffer texture
+    TextureBuffer texBufferCreate(ImageFormat format, const void* data, uint32_t size) override;
+    void          texBufferDestroy(uint32_t id) override;
+
     // Texture
-    Texture2D tex2DCreate(uint32_t w, uint32_t h) override;
+    Texture2D tex2DCreate(uint32_t w, uint32_t h, ImageFormat format) override;
     Texture2D tex2DCreateDepth(uint32_t w, uint32_t h) override;
     void      tex2DSetData(uint32_t id, const void* data, uint32_t sizeBytes) override;
     void      tex2DDestroy(uint32_t id) override;
@@ -47,6 +60,9 @@ public:
                                    uint32_t    sizeBytes) override;
     void        texCubeDestroy(uint32_t id) override;
 
+    Texture2DArray tex2DArrayCreateDepth(uint32_t w, uint32_t h, uint32_t layers) override;
+    void           tex2DArrayDestroy(uint32_t id) override;
+
     // Command buffer, records and executes commands
     CommandBuffer cmdCreate() override;
     void          cmdBegin(uint32_t id) override;
@@ -55,6 +71,11 @@ public:
     void cmdSetViewport(uint32_t id, uint32_t x, uint32_t y, uint32_t w, uint32_t h) override;
     void cmdSetShader(uint32_t id, uint32_t shaderId) override;
     void cmdSetLineWidth(uint32_t cmdId, float width) override;
+    void cmdSetClipDistances(uint32_t cmdId, uint32_t count) override;
+    void cmdSetDepthFunc(uint32_t cmdId, DepthFunc func) override;
+    void cmdSetColorMask(uint32_t cmdId, bool enable) override;
+    void cmdSetBlendFunc(uint32_t cmdId, BlendFunc func) override;
+    void cmdBlitFramebuffer(uint32_t cmdId, const Command::BlitFramebufferData& blit) override;
     void cmdSetVAO(uint32_t id, uint32_t vaoId) override;
     void cmdBindTexture(uint32_t                   id,
                         uint32_t                   slot,
@@ -64,11 +85,25 @@ public:
                             uint32_t                   slot,
                             uint32_t                   texID,
                             std::optional<std::string> uniformName = std::nullopt) override;
+    void cmdBindTextureBuffer(uint32_t                   cmdID,
+                              uint32_t                   slot,
+                              uint32_t                   texID,
+                              std::optional<std::string> uniformName = std::nullopt) override;
+    void cmdBindTextureArray(uint32_t                   cmdID,
+                             uint32_t                   slot,
+                             uint32_t                   texID,
+                             std::optional<std::string> uniformName = std::nullopt) override;
     void cmdDrawIndexed(uint32_t      id,
                         uint32_t      elemCount,
                         bool          index16,
                         uint32_t      indexOffset = 0,
                         PrimitiveType primitive   = PrimitiveType::Triangles) override;
+    void cmdDrawIndexedInstanced(uint32_t      id,
+                                 uint32_t      elemCount,
+                                 bool          index16,
+                                 uint32_t      instanceCount,
+                                 uint32_t      indexOffset = 0,
+                                 PrimitiveType primitive   = PrimitiveType::Triangles) override;
     void cmdSetScissor(uint32_t id, uint32_t x, uint32_t y, uint32_t w, uint32_t h) override;
     void cmdEnableScissor(uint32_t id, bool enable) override;
     void cmdSetBlendState(uint32_t id, bool enable) override;
@@ -80,6 +115,8 @@ public:
     void        fbAttachTexture2D(uint32_t fbID, uint32_t texID, uint32_t attachment) override;
     void        fbAttachDepthTexture(uint32_t fbID, uint32_t texID) override;
     void        fbAttachTextureCubeFace(uint32_t fbID, uint32_t texID, int faceIndex) override;
+    void fbAttachDepthTextureLayer(uint32_t fbID, uint32_t texID, uint32_t layer) override;
+    void fbAttachDepthTextureCube(uint32_t fbID, uint32_t texID) override;
     void        fbDestroy(uint32_t fbID) override;
     void
     cmdBindFramebuffer(uint32_t cmdID, uint32_t fbID, uint32_t width, uint32_t height) override;
@@ -107,6 +144,10 @@ public:
     cmdUpdateVertexBuffer(uint32_t cmdID, uint32_t vboID, const void* data, uint32_t size) override;
     void cmdUpdateIndexBuffer(
         uint32_t cmdID, uint32_t iboID, const void* data, uint32_t count, bool index16) override;
+    void cmdUpdateTextureBuffer(uint32_t    cmdID,
+                                uint32_t    texID,
+                                const void* data,
+                                uint32_t    size) override;
 
     // Shader uniforms (deferred)
     void cmdSetShaderUniformMat4(uint32_t     cmdID,
@@ -133,6 +174,40 @@ public:
                                  const float* vec2) override;
     void cmdSetDepthMask(uint32_t id, bool enable) override;
 
+    // Compute (deferred)
+    void cmdUpdateStorageBuffer(uint32_t    cmdID,
+                                uint32_t    sbID,
+                                const void* data,
+                                uint32_t    size,
+                                uint32_t    offset = 0) override;
+    void cmdBindStorageBuffer(uint32_t cmdID, uint32_t slot, uint32_t sbID) override;
+    void cmdBindImageTexture(uint32_t    cmdID,
+                             uint32_t    unit,
+                             uint32_t    texID,
+                             ImageAccess access,
+                             ImageFormat format,
+                             uint32_t    level = 0) override;
+    void cmdDispatch(uint32_t cmdID, uint32_t x, uint32_t y, uint32_t z) override;
+    void cmdMemoryBarrier(uint32_t cmdID, BarrierBits barriers) override;
+
+    // Asynchronous readback
+    PixelReadback cmdReadPixelsAsync(uint32_t    cmdID,
+                                     uint32_t    fbID,
+                                     uint32_t    x,
+                                     uint32_t    y,
+                                     uint32_t    w,
+                                     uint32_t    h,
+                                     PixelFormat format,
+                                     uint32_t    attachment = 0) override;
+    bool          readbackReady(uint32_t id) const override;
+    bool          readbackGetData(uint32_t id, std::vector<uint8_t>& out) const override;
+    void          readbackDestroy(uint32_t id) override;
+
+    // Debug markers
+    void cmdPushDebugGroup(uint32_t cmdID, const char* name) override;
+    void cmdPopDebugGroup(uint32_t cmdID) override;
+    void setObjectLabel(ResourceType type, uint32_t id, const char* label) override;
+
     void enqueueDelete(ResourceType type, uint32_t id) override;
 
 private:
@@ -143,6 +218,14 @@ private:
         bool                 recording = false;
     };
 
+    struct ReadbackData {
+        GLuint               pbo       = 0;
+        GLsync               fence     = nullptr;
+        uint32_t             sizeBytes = 0;
+        bool                 ready     = false;
+        std::vector<uint8_t> pixels;
+    };
+
     struct PendingDelete {
         ResourceType type;
         uint32_t     id;
@@ -157,6 +240,21 @@ private:
     uint32_t                                        nextCmdBufferId_ = 1;
     std::vector<uint32_t>                           pendingSubmissions_;
 
+    // Buffer texture id -> backing buffer object
+    std::unordered_map<uint32_t, GLuint> textureBufferStorage_;
+
+    // Framebuffer id -> bit per attached color attachment, all of them are drawn to (MRT)
+    std::unordered_map<uint32_t, uint32_t> fbColorAttachments_;
+    void                                   applyDrawBuffers(uint32_t fbID) const;
+
+    std::unordered_map<uint32_t, ReadbackData> readbacks_;
+    uint32_t                                   nextReadbackId_ = 1;
+
+    /**
+     * Resolve readbacks whose fence has signaled, never blocks.
+     */
+    void pollReadbacks();
+
     void executeCommand(const Command& cmd);
 };
 
@@ -176,11 +274,19 @@ public:
     IndexBuffer   createIndexBuffer(const void* indices, uint32_t count, bool index16) override;
     VertexArray   createVertexArray() override;
     Shader        createShader(const std::string& vs, const std::string& fs) override;
+    Shader
+    createShader(const std::string& vs, const std::string& gs, const std::string& fs) override;
     Texture2D     createTexture2D(uint32_t w, uint32_t h) override;
+    Texture2D     createTexture2D(uint32_t w, uint32_t h, ImageFormat format) override;
     TextureCube   createTextureCube(uint32_t resolution) override;
     CommandBuffer createCommandBuffer() override;
     Texture2D     createDepthTexture(uint32_t width, uint32_t height) override;
     Framebuffer   createFramebuffer(uint32_t width, uint32_t height) override;
+    Shader        createComputeShader(const std::string& cs) override;
+    StorageBuffer createStorageBuffer(const void* data, uint32_t size) override;
+    TextureBuffer createTextureBuffer(ImageFormat format, const void* data, uint32_t size) override;
+    Texture2DArray
+    createDepthTextureArray(uint32_t width, uint32_t height, uint32_t layers) override;
 
     GraphicsAPI getAPI() const override { return GraphicsAPI::OpenGL; }
 
@@ -0,0 +1,141 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Corvus::Core {
+
+/**
+ * Jobs still outstanding from one fork, JobSystem::wait on it to join
+ */
+class JobCounter {
+public:
+    JobCounter() = default;
+
+    JobCounter(const JobCounter&)            = delete;
+    JobCounter& operator=(const JobCounter&) = delete;
+
+    bool done() const { return pending_.load(std::memory_order_acquire) == 0; }
+
+private:
+    friend class JobSystem;
+    std::atomic<uint32_t> pending_ { 0 };
+};
+
+/**
+ * Fixed pool of worker threads with a deque each. A thread pushes and pops its own deque from the
+ * back and idle workers steal from the front of the others, so forked work stays hot in the cache
+ * of the thread that made it. Waiting threads run jobs instead of blocking.
+ *
+ * The thread that first calls get() is the main thread. Jobs posted with runOnMainThread only run
+ * there, either while it waits or when the application pumps them once a frame, which is where
+ * anything touching the graphics context has to go.
+ */
+class JobSystem {
+public:
+    using Job = std::function<void()>;
+
+    /**
+     * Shared scheduler with one worker per core besides the main thread
+     */
+    static JobSystem& get();
+
+    explicit JobSystem(uint32_t workerCount);
+    ~JobSystem();
+
+    JobSystem(const JobSystem&)            = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+
+    /**
+     * Queue a job on the calling thread's deque, counted until it finishes
+     */
+    void run(JobCounter& counter, Job job);
+
+    /**
+     * Queue a job that may only run on the main thread, such as a GPU upload
+     */
+    void runOnMainThread(JobCounter& counter, Job job);
+
+    /**
+     * Run queued jobs until every job counted by counter has finished. Safe from inside a job.
+     */
+    void wait(JobCounter& counter);
+
+    /**
+     * Run the main thread jobs queued so far, called once a frame by the application
+     */
+    void pumpMainThread();
+
+    /**
+     * Split [begin, end) into chunks of at most grainSize and call func(first, last) for each,
+     * in parallel, returning once all are done. The caller runs the first chunk itself and small
+     * ranges never leave the calling thread.
+     */
+    template <typename Func>
+    void parallelFor(size_t begin, size_t end, size_t grainSize, Func&& func);
+
+    uint32_t getWorkerCount() const { return static_cast<uint32_t>(workers_.size()); }
+    bool     isMainThread() const { return std::this_thread::get_id() == mainThread_; }
+
+private:
+    struct Entry {
+        Job         job;
+        JobCounter* counter = nullptr;
+    };
+
+    struct WorkQueue {
+        std::mutex        mutex;
+        std::deque<Entry> jobs;
+    };
+
+    void workerLoop(uint32_t queueIndex);
+
+    // Own deque from the back, then the others from the front
+    bool tryRunOne(uint32_t queueIndex);
+    bool tryRunMainThreadOne();
+    void execute(Entry& entry);
+
+    uint32_t callerQueue();
+
+    std::vector<std::unique_ptr<WorkQueue>> queues_; // 0 is the main thread, then one per worker
+    WorkQueue                               mainThreadQueue_;
+    std::vector<std::thread>                workers_;
+    std::thread::id                         mainThread_;
+
+    std::mutex              sleepMutex_;
+    std::condition_variable wake_;
+    std::atomic<uint32_t>   queued_ { 0 }; // Jobs in queues_, workers sleep while it is 0
+    std::atomic<uint32_t>   nextQueue_ { 0 };
+    std::atomic<bool>       running_ { true };
+};
+
+template <typename Func>
+void JobSystem::parallelFor(const size_t begin, const size_t end, size_t grainSize, Func&& func) {
+    if (end <= begin)
+        return;
+
+    grainSize = std::max<size_t>(grainSize, 1);
+    if (workers_.empty() || end - begin <= grainSize) {
+        func(begin, end);
+        return;
+    }
+
+    JobCounter counter;
+    for (size_t first = begin + grainSize; first < end; first += grainSize) {
+        const size_t last = std::min(first + grainSize, end);
+        run(counter, [&func, first, last] { func(first, last); });
+    }
+
+    func(begin, begin + grainSize);
+    wait(counter);
+}
+
+}
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <entt/entt.hpp>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace Corvus::Core {
+
+/**
+ * Components a system only reads
+ */
+template <typename... Components>
+struct Reads { };
+
+/**
+ * Components a system writes, through patch so observers see the change
+ */
+template <typename... Components>
+struct Writes { };
+
+/**
+ * Runs systems over a registry in registration order, except that systems whose component sets do
+ * not conflict are grouped into one stage and run concurrently on the job system. Two systems
+ * conflict when one writes a component the other reads or writes.
+ *
+ * Systems in a stage share the registry, so they may only touch the components they declared and
+ * must not create or destroy entities or add and remove components. Observers that add or remove
+ * components in reaction to a patch (the scene's disabled tag) go through deferChange, since that
+ * reorders pools other systems of the stage may be iterating.
+ */
+class SystemScheduler {
+public:
+    using SystemFn = std::function<void(entt::registry& registry, double deltaTime)>;
+    using ChangeFn = void (*)(entt::registry& registry, entt::entity entity);
+
+    template <typename... Read, typename... Write>
+    void add(std::string name, Reads<Read...>, Writes<Write...>, SystemFn system);
+
+    /**
+     * Run every system once, a stage only starts when the one before it has finished
+     */
+    void run(entt::registry& registry, double deltaTime);
+
+    /**
+     * Apply change to entity now, or if systems are running concurrently on registry queue it to
+     * be applied on the thread calling run once their stage has finished. Safe from any thread.
+     */
+    static void deferChange(entt::registry& registry, entt::entity entity, ChangeFn change);
+
+    void   clear();
+    size_t getSystemCount() const { return systems_.size(); }
+    size_t getStageCount() const { return stages_.size(); }
+
+private:
+    struct System {
+        std::string                          name;
+        std::vector<entt::id_type>           reads;
+        std::vector<entt::id_type>           writes;
+        SystemFn                             run;
+        std::function<void(entt::registry&)> assure; // Creates the pools before stages go wide
+    };
+
+    void schedule(System system);
+
+    std::vector<System>                systems_;
+    std::vector<std::vector<uint32_t>> stages_; // Indices into systems_
+};
+
+template <typename... Read, typename... Write>
+void SystemScheduler::add(std::string name, Reads<Read...>, Writes<Write...>, SystemFn system) {
+    schedule({ std::move(name),
+               { entt::type_hash<Read>::value()... },
+               { entt::type_hash<Write>::value()... },
+               std::move(system),
+               [](entt::registry& registry) {
+                   (static_cast<void>(registry.view<Read>()), ...);
+                   (static_cast<void>(registry.view<Write>()), ...);
+               } });
+}
+
+}
@@ -12,7 +12,7 @@ public:
 
     virtual void onAttach() { }
     virtual void onDetach() { }
-    virtual void onUpdate() { }
+    virtual void onUpdate(double deltaTime) { }
     virtual void onImGuiRender() { }
 
     const std::string& getName() const { return debugName; }
@@ -1,7 +1,71 @@
 #pragma once
 
+#include "corvus/application.hpp"
+#include "corvus/components/transform.hpp"
+#include "corvus/jobs/system_scheduler.hpp"
+#include "corvus/layer.hpp"
+#include "corvus/renderer/camera.hpp"
+#include "corvus/scene.hpp"
+#include <cstdint>
+#include <vector>
+
+namespace Corvus::Core {
+
 /**
  * @brief Layer that runs the main section of the game.
  * This includes the ECS driver and the main game loop.
+ *
+ * Systems tick at a fixed rate no matter how fast frames are rendered. Frame time is banked and
+ * spent in whole ticks, and each frame draws transforms blended between the last two ticks by
+ * whatever time is left over.
  */
-namespace Corvus::GameLayer { }
+class GameLayer : public Layer {
+public:
+    GameLayer(Application& application, Scene& scene, double ticksPerSecond = 60.0);
+
+    void onUpdate(double deltaTime) override;
+
+    SystemScheduler&  getSystems() { return systems_; }
+    Renderer::Camera& getCamera() { return camera_; }
+
+    void   setTickRate(double ticksPerSecond);
+    double getFixedDelta() const { return fixedDelta_; }
+
+    /**
+     * Ticks allowed in one frame. After a long stall the rest of the backlog is dropped instead of
+     * simulated, otherwise slow ticks cause longer frames which need even more ticks.
+     */
+    void     setMaxTicksPerFrame(uint32_t maxTicks) { maxTicksPerFrame_ = maxTicks; }
+    uint32_t getMaxTicksPerFrame() const { return maxTicksPerFrame_; }
+
+    float    getInterpolationAlpha() const { return alpha_; } // Of the last frame, in [0, 1)
+    uint64_t getTickCount() const { return tickCount_; }
+
+private:
+    void tick();
+
+    // Pose every moved entity between its last two ticks, and put the simulated pose back after
+    void interpolateTransforms();
+    void restoreTransforms();
+
+    struct TransformState {
+        entt::entity                   entity;
+        Components::TransformComponent transform;
+    };
+
+    Application&     application_;
+    Scene&           scene_;
+    Renderer::Camera camera_;
+    SystemScheduler  systems_;
+
+    double   fixedDelta_;
+    double   accumulator_      = 0.0;
+    uint32_t maxTicksPerFrame_ = 8;
+    float    alpha_            = 0.0f;
+    uint64_t tickCount_        = 0;
+
+    std::vector<TransformState> previous_;     // Every transform before the last tick
+    std::vector<TransformState> interpolated_; // Simulated pose of the entities drawn blended
+};
+
+}
@@ -0,0 +1,55 @@
+#pragma once
+#include <cstddef>
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+#include <vector>
+
+namespace Corvus::Renderer {
+
+/**
+ * Positions, rotations and scales stored as structure-of-arrays so their matrices can be built
+ * 4 (SSE) or 8 (AVX) at a time.
+ */
+struct TransformSoA {
+    std::vector<float> positionX;
+    std::vector<float> positionY;
+    std::vector<float> positionZ;
+    std::vector<float> rotationX;
+    std::vector<float> rotationY;
+    std::vector<float> rotationZ;
+    std::vector<float> rotationW;
+    std::vector<float> scaleX;
+    std::vector<float> scaleY;
+    std::vector<float> scaleZ;
+
+    void   clear();
+    void   reserve(size_t count);
+    void   push(const glm::vec3& position, const glm::quat& rotation, const glm::vec3& scale);
+    size_t size() const { return positionX.size(); }
+};
+
+/**
+ * translate * rotate * scale, the same matrix TransformComponent::getMatrix builds. The rotation
+ * is expected to be normalized.
+ */
+glm::mat4 composeMatrix(const glm::vec3& position,
+                        const glm::quat& rotation,
+                        const glm::vec3& scale);
+
+/**
+ * Build the matrices of transforms [first, last) into out[first, last)
+ */
+void composeMatrices(const TransformSoA& transforms, size_t first, size_t last, glm::mat4* out);
+
+/**
+ * Inverse transpose of the upper 3x3. Rotations with a uniform scale skip the inverse, the matrix
+ * is only divided by the squared scale.
+ */
+glm::mat3 normalMatrix(const glm::mat4& model);
+
+/**
+ * Normal matrices of count models, several at a time
+ */
+void normalMatrices(const glm::mat4* models, size_t count, glm::mat3* out);
+
+}
@@ -10,6 +10,13 @@ enum class ProjectionType {
     Orthographic
 };
 
+// Forward shades every object as it is drawn, deferred writes surface data to a G-buffer first
+// and shades each covered pixel once in a full screen pass
+enum class RenderPath {
+    Forward,
+    Deferred
+};
+
 class Camera {
 public:
     Camera();
@@ -50,12 +57,25 @@ public:
     const glm::mat4& getProjectionMatrix() const;
     glm::mat4        getViewProjectionMatrix() const;
 
-    // Frustum culling (future use)
+    // Frustum culling, planes point inwards and are normalized
     struct Frustum {
         glm::vec4 planes[6]; // Left, Right, Bottom, Top, Near, Far
+
+        /**
+         * Extract the frustum planes from any view-projection matrix, including light space
+         * matrices used for shadow rendering.
+         */
+        static Frustum fromMatrix(const glm::mat4& viewProj);
     };
     const Frustum& getFrustum() const;
 
+    // Lay down opaque depth first so the lit pass shades each visible pixel once
+    void setDepthPrePass(bool enabled) { depthPrePass = enabled; }
+    bool isDepthPrePassEnabled() const { return depthPrePass; }
+
+    void       setRenderPath(RenderPath path) { renderPath = path; }
+    RenderPath getRenderPath() const { return renderPath; }
+
 private:
     void updateViewMatrix() const;
     void updateProjectionMatrix() const;
@@ -81,8 +101,10 @@ private:
     float orthoSize;
 
     // Common params
-    float nearPlane;
-    float farPlane;
+    float      nearPlane;
+    float      farPlane;
+    bool       depthPrePass = false;
+    RenderPath renderPath   = RenderPath::Forward;
 
     // Cached matrices
     mutable glm::mat4 viewMatrix {};
@@ -0,0 +1,58 @@
+#pragma once
+#include "corvus/renderer/camera.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Corvus::Core {
+class JobSystem;
+}
+
+namespace Corvus::Renderer {
+
+/**
+ * Bounding spheres stored as structure-of-arrays so the frustum test can process 4 (SSE) or
+ * 8 (AVX) spheres per iteration.
+ */
+struct SphereBoundsSoA {
+    std::vector<float> centerX;
+    std::vector<float> centerY;
+    std::vector<float> centerZ;
+    std::vector<float> radius;
+
+    void   clear();
+    void   reserve(size_t count);
+    void   push(const glm::vec3& center, float r);
+    size_t size() const { return radius.size(); }
+};
+
+/**
+ * Test every sphere against the frustum planes. visible[i] is set to 1 when sphere i is inside or
+ * intersects the frustum and 0 when it lies entirely behind one of the planes.
+ *
+ * @return Number of visible spheres
+ */
+uint32_t cullSpheres(const Camera::Frustum& frustum,
+                     const SphereBoundsSoA& bounds,
+                     std::vector<uint8_t>&  visible);
+
+/**
+ * Same as above, spread over the workers of jobs instead of the shared scheduler
+ */
+uint32_t cullSpheres(const Camera::Frustum& frustum,
+                     const SphereBoundsSoA& bounds,
+                     std::vector<uint8_t>&  visible,
+                     Core::JobSystem&       jobs);
+
+/**
+ * Test every sphere against a single bounding sphere, such as a point light's range.
+ * visible[i] is set to 1 when the spheres overlap.
+ *
+ * @return Number of visible spheres
+ */
+uint32_t cullSpheres(const glm::vec3&       center,
+                     float                  radius,
+                     const SphereBoundsSoA& bounds,
+                     std::vector<uint8_t>&  visible);
+
+}
@@ -0,0 +1,28 @@
+#pragma once
+#include "corvus/graphics/graphics.hpp"
+#include <cstdint>
+
+namespace Corvus::Renderer {
+
+/**
+ * Surface data written by the deferred path's geometry pass, sized to the render target
+ *   albedo  RGBA8    albedo, metallic in alpha
+ *   normal  RGBA16F  world normal, smoothness in w
+ *   depth            world position is rebuilt from it in the lighting pass
+ */
+class GBuffer {
+public:
+    Graphics::Texture2D   albedo;
+    Graphics::Texture2D   normal;
+    Graphics::Texture2D   depth;
+    Graphics::Framebuffer framebuffer;
+    uint32_t              width       = 0;
+    uint32_t              height      = 0;
+    bool                  initialized = false;
+
+    // Recreates the targets only when the size changed
+    void resize(Graphics::GraphicsContext& ctx, uint32_t w, uint32_t h);
+    void cleanup();
+};
+
+}
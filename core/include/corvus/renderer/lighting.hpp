@@ -1,8 +1,10 @@
 #pragma once
 #include "corvus/graphics/graphics.hpp"
+#include "corvus/renderer/shadow_atlas.hpp"
 #include "entt/entity/fwd.hpp"
 #include <array>
 #include <glm/glm.hpp>
+#include <limits>
 #include <vector>
 
 namespace Corvus::Renderer {
@@ -19,6 +21,9 @@ enum class LightType {
 struct Light {
     LightType type = LightType::Directional;
 
+    // Stable identity (the entity) so shadow atlas tiles persist across frames, max when unset
+    uint32_t id = std::numeric_limits<uint32_t>::max();
+
     // Transform
     glm::vec3 position  = glm::vec3(0.0f);
     glm::vec3 direction = glm::vec3(0.0f, -1.0f, 0.0f);
@@ -31,9 +36,8 @@ struct Light {
     float range = 10.0f;
 
     // Spot light properties
-    float innerCutoff    = 12.5f; // degrees
-    float outerCutoff    = 17.5f; // degrees
-    int   shadowMapIndex = -1;
+    float innerCutoff = 12.5f; // degrees
+    float outerCutoff = 17.5f; // degrees
 
     // Shadow properties
     bool     castShadows         = false;
@@ -41,38 +45,33 @@ struct Light {
     float    shadowBias          = 0.005f;
     float    shadowStrength      = 1.0f;
 
-    // Directional light shadow frustum
-    float shadowDistance  = 50.0f;
-    float shadowNearPlane = 0.1f;
-    float shadowFarPlane  = 100.0f;
-};
-
-/**
- * Shadow map for directional/spotlights
- */
-struct ShadowMap {
-    Graphics::Framebuffer framebuffer;
-    Graphics::Texture2D   depthTexture;
-    glm::mat4             lightSpaceMatrix{};
-    uint32_t              resolution  = 1024;
-    bool                  initialized = false;
-
-    void initialize(Graphics::GraphicsContext& ctx, uint32_t res);
-    void cleanup();
+    // Directional light shadow frustum, cascades cover the camera view up to shadowDistance
+    // and capture casters up to shadowFarPlane towards the light
+    float    shadowDistance     = 50.0f;
+    float    shadowNearPlane    = 0.1f;
+    float    shadowFarPlane     = 100.0f;
+    uint32_t cascadeCount       = 4;
+    float    cascadeSplitLambda = 0.75f; // 0 uniform splits, 1 logarithmic splits
 };
 
 /**
- * Cubemap shadow for point lights
+ * Cascaded shadow map for the primary directional light, one array layer per cascade
  */
-struct CubemapShadow {
-    Graphics::Framebuffer framebuffer;
-    Graphics::TextureCube depthCubemap;
-    glm::vec3             lightPosition;
-    float                 farPlane    = 25.0f;
-    uint32_t              resolution  = 1024;
-    bool                  initialized = false;
-
-    void initialize(Graphics::GraphicsContext& ctx, uint32_t res);
+struct CascadedShadowMap {
+    static constexpr uint32_t MAX_CASCADES = 4;
+
+    Graphics::Texture2DArray                        depthArray;
+    std::array<Graphics::Framebuffer, MAX_CASCADES> framebuffers;
+    std::array<glm::mat4, MAX_CASCADES>             lightSpaceMatrices {};
+    std::array<float, MAX_CASCADES>                 splitDepths {}; // View space far distance
+    std::array<uint64_t, MAX_CASCADES>              casterHashes {};
+    uint32_t                                        cascadeCount = 0;
+    uint32_t                                        resolution   = 1024;
+    float                                           bias         = 0.005f;
+    float                                           strength     = 1.0f;
+    bool                                            initialized  = false;
+
+    void initialize(Graphics::GraphicsContext& ctx, uint32_t res, uint32_t cascades);
     void cleanup();
 };
 
@@ -81,9 +80,20 @@ struct CubemapShadow {
  */
 class LightingSystem {
 public:
-    static constexpr uint32_t MAX_LIGHTS        = 16;
-    static constexpr uint32_t MAX_SHADOW_MAPS   = 4;
-    static constexpr uint32_t MAX_POINT_SHADOWS = 4;
+    // Spot and point light shadows share one DEPTH32F atlas (64 MB at 4096)
+    static constexpr uint32_t SHADOW_ATLAS_SIZE = 4096;
+
+    // Froxel grid used to bin point and spot lights, depth slices are logarithmic
+    static constexpr uint32_t CLUSTER_X     = 16;
+    static constexpr uint32_t CLUSTER_Y     = 9;
+    static constexpr uint32_t CLUSTER_Z     = 24;
+    static constexpr uint32_t CLUSTER_COUNT = CLUSTER_X * CLUSTER_Y * CLUSTER_Z;
+
+    // Texture units after the material (0-2) slots
+    static constexpr uint32_t SHADOW_ATLAS_TEXTURE_SLOT = 3;
+    static constexpr uint32_t SHADOW_DATA_TEXTURE_SLOT  = 4;
+    static constexpr uint32_t CASCADE_TEXTURE_SLOT      = 11;
+    static constexpr uint32_t CLUSTER_TEXTURE_SLOT      = 12;
 
     LightingSystem() = default;
     ~LightingSystem();
@@ -137,28 +147,37 @@ public:
     const Light* getPrimaryDirectionalLight() const;
 
     /**
-     * Cull lights for a specific object (returns closest lights)
+     * Bin point and spot lights into the view's cluster grid and record the upload,
+     * call once per view before drawing with applyLightingUniforms
      */
-    struct CulledLights {
-        std::vector<const Light*> pointLights;
-        std::vector<const Light*> spotLights;
-    };
-    CulledLights cullLightsForObject(const glm::vec3& position, float radius) const;
+    void buildClusters(Graphics::CommandBuffer& cmd, const glm::mat4& view, const glm::mat4& proj);
+
+    /**
+     * Number of (light, cluster) pairs produced by the last buildClusters call
+     */
+    uint32_t getClusterLightReferences() const {
+        return static_cast<uint32_t>(clusterIndices_.size());
+    }
+
+    /**
+     * Get the spot and point light shadow atlas (for SceneRenderer)
+     */
+    ShadowAtlas& getShadowAtlas() { return shadowAtlas_; }
 
     /**
-     * Get shadow maps (for SceneRenderer)
+     * Atlas tiles of lights_[lightIndex], nullptr when it has no shadow this frame
      */
-    const std::vector<ShadowMap>& getShadowMaps() const { return shadowMaps_; }
-    std::vector<ShadowMap>&       getShadowMaps() { return shadowMaps_; }
+    ShadowAtlasSlot* getShadowSlot(size_t lightIndex) {
+        return lightIndex < shadowSlots_.size() ? shadowSlots_[lightIndex] : nullptr;
+    }
 
     /**
-     * Get cubemap shadows (for SceneRenderer)
+     * Get the directional light cascades (for SceneRenderer)
      */
-    const std::vector<CubemapShadow>& getCubemapShadows() const { return cubemapShadows_; }
-    std::vector<CubemapShadow>&       getCubemapShadows() { return cubemapShadows_; }
+    CascadedShadowMap& getCascadedShadowMap() { return cascades_; }
 
     /**
-     * Prepare shadow maps for rendering (ensures they're initialized)
+     * Prepare shadow maps for rendering, assigns atlas tiles to the shadowed spot and point lights
      */
     void prepareShadowMaps(Graphics::GraphicsContext& ctx);
 
@@ -168,9 +187,14 @@ public:
     Graphics::Shader& getShadowShader();
 
     /**
-     * Calculate light space matrix for directional light
+     * Get the point shadow shader, writes all selected cube faces to their atlas tiles in one draw
      */
-    glm::mat4 calculateDirectionalLightMatrix(const Light& light, const glm::vec3& sceneCenter);
+    Graphics::Shader& getPointShadowShader();
+
+    /**
+     * Split the camera frustum and fit a texel snapped light matrix around each cascade
+     */
+    void calculateCascades(const Light& light, const glm::mat4& view, const glm::mat4& proj);
 
     /**
      * Calculate light space matrix for spotlight
@@ -184,12 +208,10 @@ public:
     calculatePointLightMatrices(const glm::vec3& lightPos, float nearPlane, float farPlane);
 
     /**
-     * Apply lighting uniforms to a shader for a specific object
+     * Apply lighting uniforms to a shader, per-light data comes from the cluster buffers
      */
     void applyLightingUniforms(Graphics::CommandBuffer& cmd,
                                Graphics::Shader&        shader,
-                               const glm::vec3&         objectPosition,
-                               float                    objectRadius,
                                const glm::vec3&         cameraPosition);
 
     /**
@@ -198,9 +220,9 @@ public:
     void bindShadowTextures(Graphics::CommandBuffer& cmd);
 
     /**
-     * Set shadow properties (called by SceneRenderer after rendering shadow maps)
+     * Bind the cluster light, grid and index buffers to shader
      */
-    void setShadowProperties(const std::vector<float>& biases, const std::vector<float>& strengths);
+    void bindClusterTextures(Graphics::CommandBuffer& cmd);
 
     /**
      * Cleanup
@@ -216,20 +238,44 @@ private:
     glm::vec3          ambientColor_ = glm::vec3(0.1f, 0.1f, 0.15f);
 
     // Shadow maps
-    std::vector<ShadowMap>     shadowMaps_;
-    std::vector<CubemapShadow> cubemapShadows_;
+    ShadowAtlas                   shadowAtlas_;
+    std::vector<ShadowAtlasSlot*> shadowSlots_; // Parallel to lights_
+    CascadedShadowMap             cascades_;
+    bool                          cascadesActive_ = false;
+    Graphics::Texture2DArray      emptyCascades_; // 1x1 stand in bound while there are no cascades
 
-    // Shadow properties (stored per shadow map)
-    std::vector<float> shadowBiases_;
-    std::vector<float> shadowStrengths_;
+    // Per-light shadow data referenced from the cluster light texels, rebuilt by buildClusters
+    Graphics::TextureBuffer shadowDataBuffer_;
+    std::vector<glm::vec4>  shadowDataTexels_;
 
     // Shadow shader
     Graphics::Shader shadowShader_;
     bool             shadowShaderInitialized_ = false;
+    Graphics::Shader pointShadowShader_;
+    bool             pointShadowShaderInitialized_ = false;
+
+    // Clustered light buffers, rebuilt by buildClusters
+    Graphics::TextureBuffer clusterLightBuffer_; // 4 RGBA32F texels per light
+    Graphics::TextureBuffer clusterGridBuffer_;  // 2 R32UI texels per cluster, offset and count
+    Graphics::TextureBuffer clusterIndexBuffer_; // R32UI light indices referenced by the grid
+    float                   clusterNear_     = 0.1f;
+    float                   clusterLogScale_ = 1.0f;
+
+    // Inclusive cluster range touched by a light
+    struct ClusterRange {
+        uint32_t light;
+        uint32_t minX, maxX;
+        uint32_t minY, maxY;
+        uint32_t minZ, maxZ;
+    };
+
+    // CPU staging for the cluster buffers, kept to avoid per-frame allocations
+    std::vector<glm::vec4>    clusterLightTexels_;
+    std::vector<uint32_t>     clusterGridTexels_;
+    std::vector<uint32_t>     clusterIndices_;
+    std::vector<ClusterRange> clusterRanges_;
 
-    // Shadow map management
-    ShadowMap&     getShadowMap(size_t index);
-    CubemapShadow& getCubemapShadow(size_t index);
+    void ensureClusterBuffers();
 
     // Helper to normalize color from 0-255 or 0-1 range to 0-1
     static glm::vec3 normalizeColor(const glm::vec3& color);
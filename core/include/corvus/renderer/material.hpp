@@ -53,6 +53,9 @@ public:
     // Bind all state and uniforms to the command buffer
     void bind(CommandBuffer& cmd);
 
+    // Same as bind, but binds and sets uniforms on a variant of the material's shader
+    void bind(CommandBuffer& cmd, Shader& variant);
+
     // Shader access
     Shader& getShader() { return shader; }
 
@@ -4,6 +4,7 @@
 #include "corvus/asset/material/material.hpp"
 #include "corvus/graphics/graphics.hpp"
 #include "corvus/renderer/material.hpp"
+#include <array>
 #include <unordered_map>
 
 namespace Corvus::Renderer {
@@ -15,6 +16,23 @@ namespace Corvus::Renderer {
  */
 class MaterialRenderer {
 public:
+    /**
+     * Variants of the default lit shader, sharing its material uniforms
+     *   Instanced                 u_Model and u_NormalMatrix are read per instance from
+     *                             u_InstanceData
+     *   GBuffer                   writes surface data to the G-buffer instead of shading
+     *   WeightedBlended           writes to the order-independent transparency targets
+     *   *Instanced                the pass variant with per instance transforms
+     */
+    enum class ShaderVariant {
+        Instanced,
+        GBuffer,
+        GBufferInstanced,
+        WeightedBlended,
+        WeightedBlendedInstanced,
+        Count
+    };
+
     explicit MaterialRenderer(Graphics::GraphicsContext& ctx);
     ~MaterialRenderer();
 
@@ -32,6 +50,20 @@ public:
      */
     Shader* apply(Material& material, CommandBuffer& cmd);
 
+    /**
+     * Apply a Material with a variant of its shader, only the default shader has variants.
+     *
+     * @return The variant that was bound or nullptr if the material has no such variant
+     */
+    Shader* applyVariant(Material& material, CommandBuffer& cmd, ShaderVariant variant);
+    bool    supportsVariant(const Material& material, ShaderVariant variant) const;
+
+    /**
+     * Whether the material renders with the default lit shader, whose vertex stage the renderer
+     * knows and can reproduce in depth-only passes
+     */
+    bool usesDefaultShader(const Material& material) const;
+
     /**
      * Apply a MaterialAsset by converting it to a Material first.
      * This is an adapter for the asset system.
@@ -58,14 +90,22 @@ public:
     Shader&    getDefaultShader();
     Texture2D& getDefaultTexture();
 
+    /**
+     * Full screen pass shading the G-buffer with the default lit lighting, reads u_GBufferAlbedo,
+     * u_GBufferNormal and u_GBufferDepth
+     */
+    Shader& getDeferredLightingShader();
+
 private:
     Graphics::GraphicsContext& context;
 
     // Default resources
-    Shader    defaultShader;
-    Texture2D defaultTexture;
-    bool      defaultsInitialized = false;
-    void      initializeDefaults();
+    Shader                                                         defaultShader;
+    std::array<Shader, static_cast<size_t>(ShaderVariant::Count)> defaultVariants;
+    Shader                                                         deferredLightingShader;
+    Texture2D                                                      defaultTexture;
+    bool                                                           defaultsInitialized = false;
+    void                                                           initializeDefaults();
 };
 
 }
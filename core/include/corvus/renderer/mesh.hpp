@@ -53,6 +53,7 @@ public:
 
     // Draw command
     void draw(CommandBuffer& cmd, bool wireframe = false) const;
+    void drawInstanced(CommandBuffer& cmd, uint32_t instanceCount, bool wireframe = false) const;
 
     // Metadata
     bool               valid() const { return indexCount > 0 && vao.valid(); }
@@ -90,6 +91,9 @@ private:
 
     std::vector<Vertex>   vertices;
     std::vector<uint32_t> indices;
+
+    // Cached on first query, reset when vertices change
+    mutable float boundingRadius = -1.0f;
 };
 
 }
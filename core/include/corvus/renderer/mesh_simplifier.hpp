@@ -0,0 +1,47 @@
+#pragma once
+#include "corvus/graphics/graphics.hpp"
+#include "corvus/renderer/mesh.hpp"
+#include "corvus/renderer/model.hpp"
+#include <vector>
+
+namespace Corvus::Renderer {
+
+/**
+ * Quadric error metric mesh simplification (Garland and Heckbert) and LOD chain generation
+ */
+namespace MeshSimplifier {
+
+    struct LodSettings {
+        uint32_t levels         = 3;     // Reduced levels to generate, capped by Model::MAX_LODS
+        float    reduction      = 0.5f;  // Triangle ratio of each level to the one before
+        float    maxError       = 0.02f; // Largest allowed deviation, relative to the mesh radius
+        float    screenCoverage = 0.25f; // First reduced level, halved for each level after
+    };
+
+    /**
+     * Reduce a triangle list by collapsing the cheapest edges onto one of their endpoints, so
+     * surviving vertices keep their attributes. Vertices sharing a position are welded for the
+     * topology and border or non-manifold edges never move.
+     *
+     * @param targetIndexCount Stop once the result has this many indices or fewer
+     * @param maxError Stop before a collapse would move the surface further than this
+     * @param outVertices Compacted vertices referenced by outIndices
+     * @return Whether anything was removed
+     */
+    bool simplify(const std::vector<Vertex>&   vertices,
+                  const std::vector<uint32_t>& indices,
+                  size_t                       targetIndexCount,
+                  float                        maxError,
+                  std::vector<Vertex>&         outVertices,
+                  std::vector<uint32_t>&       outIndices);
+
+    /**
+     * Replace the model's LOD levels with simplified copies of its triangle meshes. Stops early
+     * once a level barely reduces the previous one. Meshes are simplified on the job system and
+     * uploaded on the calling thread, which has to be the one ctx renders on.
+     */
+    void generateLods(GraphicsContext& ctx, Model& model, const LodSettings& settings = {});
+
+}
+
+}
@@ -1,6 +1,7 @@
 #pragma once
 #include "corvus/graphics/graphics.hpp"
 #include "corvus/renderer/mesh.hpp"
+#include <algorithm>
 #include <memory>
 #include <vector>
 
@@ -9,9 +10,15 @@ namespace Corvus::Renderer {
 /**
  * A model is a collection of meshes that make up a 3D object.
  * Models can be loaded from files or procedurally generated.
+ *
+ * Optional LOD levels hold reduced copies of the meshes. Level 0 is always the full detail meshes,
+ * level N is used once the model covers less than its screen coverage (fraction of the screen
+ * height taken by the bounding sphere).
  */
 class Model {
 public:
+    static constexpr uint32_t MAX_LODS = 4; // Including level 0
+
     Model()                            = default;
     Model(const Model&)                = delete;
     Model& operator=(const Model&)     = delete;
@@ -30,15 +37,55 @@ public:
     // Check if the model has any meshes
     bool valid() const { return !meshes.empty(); }
 
-    // Draw all meshes
-    void draw(CommandBuffer& cmd, bool wireframe = false) const {
-        for (const auto& mesh : meshes) {
+    // Append a coarser level, coverage must be below the previous level's
+    void addLod(std::vector<std::shared_ptr<Mesh>> lodMeshes, float screenCoverage) {
+        if (getLodCount() < MAX_LODS)
+            lods.push_back({ std::move(lodMeshes), screenCoverage });
+    }
+
+    uint32_t getLodCount() const { return 1 + static_cast<uint32_t>(lods.size()); }
+
+    const std::vector<std::shared_ptr<Mesh>>& getLodMeshes(uint32_t lod) const {
+        return lod == 0 || lod > lods.size() ? meshes : lods[lod - 1].meshes;
+    }
+
+    // Level 0 is used at any size
+    float getLodScreenCoverage(uint32_t lod) const {
+        return lod == 0 || lod > lods.size() ? 1.0f : lods[lod - 1].screenCoverage;
+    }
+
+    // Levels may reuse meshes that could not be reduced, those belong to level 0
+    void clearLods() {
+        for (auto& level : lods) {
+            for (auto& mesh : level.meshes) {
+                if (mesh && std::find(meshes.begin(), meshes.end(), mesh) == meshes.end())
+                    mesh->release();
+            }
+        }
+        lods.clear();
+    }
+
+    // Draw all meshes of a level
+    void draw(CommandBuffer& cmd, bool wireframe = false, uint32_t lod = 0) const {
+        for (const auto& mesh : getLodMeshes(lod)) {
             if (mesh && mesh->valid()) {
                 mesh->draw(cmd, wireframe);
             }
         }
     }
 
+    // Draw all meshes of a level once per instance
+    void drawInstanced(CommandBuffer& cmd,
+                       uint32_t       instanceCount,
+                       bool           wireframe = false,
+                       uint32_t       lod       = 0) const {
+        for (const auto& mesh : getLodMeshes(lod)) {
+            if (mesh && mesh->valid()) {
+                mesh->drawInstanced(cmd, instanceCount, wireframe);
+            }
+        }
+    }
+
     // Calculate bounding radius for all meshes
     float getBoundingRadius() const {
         float maxRadius = 0.0f;
@@ -51,6 +98,7 @@ public:
     }
 
     void release() {
+        clearLods();
         for (auto& mesh : meshes) {
             if (mesh) {
                 mesh->release();
@@ -60,7 +108,13 @@ public:
     }
 
 private:
+    struct Lod {
+        std::vector<std::shared_ptr<Mesh>> meshes;
+        float                              screenCoverage;
+    };
+
     std::vector<std::shared_ptr<Mesh>> meshes;
+    std::vector<Lod>                   lods; // Coarser with each level
 };
 
 }
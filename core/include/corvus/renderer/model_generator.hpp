@@ -35,6 +35,11 @@ namespace ModelGenerator {
                          float                      height = 1.0f,
                          uint32_t                   slices = 16);
 
+    /**
+     * Create a single triangle covering all of clip space, for full screen passes
+     */
+    Model createFullscreenTriangle(Graphics::GraphicsContext& ctx);
+
 }
 
 }
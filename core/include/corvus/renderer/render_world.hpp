@@ -0,0 +1,148 @@
+#pragma once
+
+#include "corvus/asset/asset_manager.hpp"
+#include "corvus/components/entity_info.hpp"
+#include "corvus/components/light.hpp"
+#include "corvus/components/mesh_renderer.hpp"
+#include "corvus/components/transform.hpp"
+#include "corvus/renderer/lighting.hpp"
+#include "corvus/renderer/material_renderer.hpp"
+#include "corvus/renderer/renderable.hpp"
+#include "corvus/renderer/static_batch.hpp"
+#include <entt/entt.hpp>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace Corvus::Renderer {
+
+/**
+ * Renderables and lights kept alive across frames for the entities of one registry. Observers on
+ * the mesh renderer, light, world transform and disabled tag storages mark entities dirty, and
+ * update only refreshes those, so an unchanged scene costs nothing to gather. World transforms
+ * come from the scene's TransformHierarchy.
+ *
+ * Enabled meshes and lights are read through owning groups, which keep them packed at the front of
+ * their pools. Nothing else may own the mesh renderer, world transform or light storages.
+ *
+ * Observers only fire through the registry (emplace, replace, patch, remove, destroy). Code that
+ * edits a component through a reference has to patch it afterwards for the edit to show up.
+ * Proxies point straight into model and material assets, so when the asset manager deletes,
+ * unloads or reloads any asset data every proxy is resolved again and the static chunks rebuilt.
+ * Observers may fire from several threads at once, update runs while nothing else touches the
+ * registry.
+ */
+class RenderWorld {
+public:
+    RenderWorld(GraphicsContext& context, MaterialRenderer& materialRenderer);
+    ~RenderWorld();
+
+    RenderWorld(const RenderWorld&)            = delete;
+    RenderWorld& operator=(const RenderWorld&) = delete;
+
+    /**
+     * Observe a registry, dropping the previous one. Every entity is gathered on the next update.
+     * The registry has to outlive the render world or be detached first.
+     */
+    void            attach(entt::registry& registry);
+    void            detach();
+    entt::registry* getRegistry() const { return registry_; }
+
+    /**
+     * Regather every entity, for changes the observers cannot see such as a reloaded asset
+     */
+    void markAllDirty();
+
+    /**
+     * Refresh dirty proxies and rebuild the runtime material of any edited material asset.
+     * Proxies are resolved again first if the asset manager's data changed since the last update.
+     *
+     * @param staticBatcher Static meshes are merged through it, nullptr draws them one by one
+     */
+    void update(Core::AssetManager* assetManager, StaticBatcher* staticBatcher);
+
+    /**
+     * Dynamic proxies followed by one renderable per static chunk
+     */
+    const std::vector<Renderable>& getRenderables() const { return renderables_; }
+    const std::vector<Light>&      getLights() const { return lights_; }
+
+    uint32_t getProxiesUpdated() const { return proxiesUpdated_; } // During the last update
+    bool     staticBatchesUpdated() const { return staticUpdated_; }
+
+private:
+    void onChanged(entt::registry& registry, entt::entity entity);
+    void onMoved(entt::registry& registry, entt::entity entity);
+
+    template <typename Component, auto OnUpdate = &RenderWorld::onChanged>
+    void connect(entt::registry& registry);
+
+    template <typename Component>
+    void disconnect(entt::registry& registry);
+
+    auto meshGroup() {
+        using namespace Core::Components;
+        return registry_->group<MeshRendererComponent, WorldTransformComponent>(
+            entt::exclude<DisabledTag>);
+    }
+
+    auto lightGroup() {
+        using namespace Core::Components;
+        return registry_->group<LightComponent>(entt::get<WorldTransformComponent>,
+                                                entt::exclude<DisabledTag>);
+    }
+
+    // Re-resolve model, material and light data, returns false while an asset is not loaded yet
+    bool refresh(entt::entity entity, Core::AssetManager* assetManager, bool batchStatic);
+    // Safe to run concurrently for different entities, returns whether a static mesh moved
+    bool refreshTransform(entt::entity entity);
+    void refreshLight(entt::entity                                     entity,
+                      const Core::Components::LightComponent*          light,
+                      const Core::Components::WorldTransformComponent* transform);
+
+    void removeMesh(entt::entity entity);
+    void removeLight(entt::entity entity);
+    // Squeeze out the static meshes removed during this update, keeping the rest in order
+    void compactStatic();
+
+    void retainMaterial(const Core::MaterialAsset* asset);
+    void releaseMaterial(const Core::MaterialAsset* asset);
+
+    struct MeshProxy {
+        const Core::MaterialAsset* materialAsset = nullptr;
+        float                      localRadius   = 1.0f; // Mesh space, scaled on transform edits
+        uint32_t                   index         = 0;    // Into renderables_ or staticMeshes_
+        bool                       isStatic      = false;
+    };
+
+    GraphicsContext&  context_;
+    MaterialRenderer& materialRenderer_;
+    entt::registry*   registry_ = nullptr;
+
+    std::vector<entt::entity> dirty_;    // Everything gets re-resolved
+    std::vector<entt::entity> moved_;    // Only the transform changed
+    std::vector<entt::entity> awaiting_; // Retried every update until their assets load
+    std::mutex                observerMutex_; // Guards dirty_ and moved_ while systems patch
+
+    std::unordered_map<entt::entity, MeshProxy> meshes_;
+    std::vector<Renderable>                     renderables_;
+    std::vector<entt::entity>                   renderableOwners_; // Parallel to the dynamic part
+
+    std::vector<StaticMeshInstance> staticMeshes_;
+    std::vector<entt::entity>       staticOwners_; // Null for removed meshes until compacted
+    uint32_t                        staticHoles_   = 0;
+    bool                            staticChanged_ = false;
+    bool                            staticUpdated_ = false;
+
+    std::unordered_map<entt::entity, uint32_t> lightIndices_;
+    std::vector<Light>                         lights_;
+    std::vector<entt::entity>                  lightOwners_;
+
+    // Distinct material assets in use, so edits to them are applied without visiting every proxy
+    std::unordered_map<const Core::MaterialAsset*, uint32_t> materialRefs_;
+
+    uint64_t assetGeneration_ = 0; // Asset manager data generation the proxies were resolved at
+    uint32_t proxiesUpdated_  = 0;
+};
+
+}
@@ -11,8 +11,10 @@ struct Renderable {
     Model*    model     = nullptr;
     Material* material  = nullptr;
     glm::mat4 transform = glm::mat4(1.0f);
-    bool      wireframe = false;
-    bool      enabled   = true;
+    bool      wireframe   = false;
+    bool      enabled     = true;
+    bool      castShadows = true;
+    uint64_t  id          = 0; // Stable across frames (entity + 1) for LOD hysteresis, 0 if none
 
     // Optional: for culling/lighting
     glm::vec3 position       = glm::vec3(0.0f);
@@ -6,25 +6,58 @@
 #include "corvus/components/transform.hpp"
 #include "corvus/graphics/graphics.hpp"
 #include "corvus/renderer/camera.hpp"
+#include "corvus/renderer/culling.hpp"
+#include "corvus/renderer/gbuffer.hpp"
 #include "corvus/renderer/lighting.hpp"
 #include "corvus/renderer/material_renderer.hpp"
+#include "corvus/renderer/render_world.hpp"
 #include "corvus/renderer/renderable.hpp"
+#include "corvus/renderer/static_batch.hpp"
+#include "corvus/renderer/transparency.hpp"
 #include <array>
 #include <entt/entt.hpp>
+#include <unordered_map>
 
 namespace Corvus::Renderer {
 
 struct RenderStats {
-    uint32_t drawCalls        = 0;
-    uint32_t triangles        = 0;
-    uint32_t vertices         = 0;
-    uint32_t entitiesRendered = 0;
+    uint32_t drawCalls           = 0;
+    uint32_t triangles           = 0;
+    uint32_t vertices            = 0;
+    uint32_t entitiesRendered    = 0;
+    uint32_t entitiesCulled      = 0;
+    uint32_t shadowCastersCulled = 0;
+    uint32_t shadowMapsRendered  = 0;
+    uint32_t shadowMapsCached    = 0;
+    uint32_t instancedBatches    = 0; // Groups drawn with one instanced draw per mesh
+    uint32_t staticChunks        = 0;
+    uint32_t staticChunksRebuilt = 0;
+    uint32_t depthPrePassDraws   = 0;
+    uint32_t deferredDraws       = 0; // Written to the G-buffer, shaded by the lighting pass
+    uint32_t transparentDraws    = 0;
+    uint32_t lodCulled           = 0; // Below the LOD cull coverage
+    uint32_t proxiesUpdated      = 0; // Render world entries refreshed from the ECS
+
+    std::array<uint32_t, Model::MAX_LODS> lodTriangles {};
 
     void reset() {
-        drawCalls        = 0;
-        triangles        = 0;
-        vertices         = 0;
-        entitiesRendered = 0;
+        drawCalls           = 0;
+        triangles           = 0;
+        vertices            = 0;
+        entitiesRendered    = 0;
+        entitiesCulled      = 0;
+        shadowCastersCulled = 0;
+        shadowMapsRendered  = 0;
+        shadowMapsCached    = 0;
+        instancedBatches    = 0;
+        staticChunks        = 0;
+        staticChunksRebuilt = 0;
+        depthPrePassDraws   = 0;
+        deferredDraws       = 0;
+        transparentDraws    = 0;
+        lodCulled           = 0;
+        proxiesUpdated      = 0;
+        lodTriangles.fill(0);
     }
 };
 
@@ -33,7 +66,12 @@ struct RenderStats {
  */
 class SceneRenderer {
 public:
+    // After the lighting slots, read by the instanced default shader
+    static constexpr uint32_t INSTANCE_TEXTURE_SLOT = 5;
+    static constexpr uint32_t INSTANCE_TEXELS       = 7; // Model matrix, then normal matrix
+
     explicit SceneRenderer(GraphicsContext& context);
+    ~SceneRenderer();
 
     /**
      * Render a collection of renderables (low-level, fully manual)
@@ -43,15 +81,19 @@ public:
      * @param proj Projection matrix
      * @param cameraPos Camera world position
      * @param targetFB Optional framebuffer target (nullptr = screen)
+     * @param depthPrePass Draw opaque depth first, the lit pass then only shades visible pixels
+     * @param path Deferred needs a framebuffer target, it falls back to forward on the screen
      */
     void render(const std::vector<Renderable>& renderables,
                 const glm::mat4&               view,
                 const glm::mat4&               proj,
                 const glm::vec3&               cameraPos,
-                const Graphics::Framebuffer*   targetFB = nullptr);
+                const Graphics::Framebuffer*   targetFB     = nullptr,
+                bool                           depthPrePass = false,
+                RenderPath                     path         = RenderPath::Forward);
 
     /**
-     * Render with camera (convenience wrapper)
+     * Render with camera (convenience wrapper), the pre-pass and render path follow the camera
      */
     void render(const std::vector<Renderable>& renderables,
                 const Camera&                  camera,
@@ -59,7 +101,9 @@ public:
 
     /**
      * Render an entire ECS scene
-     * This is a utility method that converts ECS components to renderables
+     * Renderables and lights are kept in a render world attached to the registry, only entities
+     * whose components were added, removed or patched since the last call are converted again.
+     * Components edited through a reference need a registry patch to be picked up.
      *
      * @param registry ECS registry containing entities
      * @param camera Camera to render from
@@ -71,6 +115,17 @@ public:
                      Core::AssetManager*          assetManager,
                      const Graphics::Framebuffer* targetFB = nullptr);
 
+    /**
+     * Observe a registry ahead of renderScene, needed when the registry object moves so the old
+     * one is released while it still exists
+     */
+    void attachRegistry(entt::registry& registry) { renderWorld_.attach(registry); }
+
+    /**
+     * Convert every entity again on the next renderScene, for edits the registry never saw
+     */
+    void invalidateRenderWorld() { renderWorld_.markAllDirty(); }
+
     /**
      * Get the lighting system
      */
@@ -105,6 +160,38 @@ public:
     const RenderStats& getStats() const { return stats_; }
     void               resetStats() { stats_.reset(); }
 
+    /**
+     * Toggle view and shadow frustum culling of renderable bounding spheres
+     */
+    void setFrustumCulling(bool enabled) { frustumCulling_ = enabled; }
+    bool isFrustumCullingEnabled() const { return frustumCulling_; }
+
+    /**
+     * Toggle merging static mesh renderers into world space chunks in renderScene. Chunks are
+     * rebuilt on their own when a static entity changes, invalidate forces a full rebuild.
+     */
+    void setStaticBatching(bool enabled);
+    bool isStaticBatchingEnabled() const { return staticBatching_; }
+    void invalidateStaticBatches();
+
+    /**
+     * How blended materials are drawn. Weighted blended needs a framebuffer target and the
+     * default shader, anything else stays in the sorted queue.
+     */
+    void             setTransparencyMode(TransparencyMode mode) { transparencyMode_ = mode; }
+    TransparencyMode getTransparencyMode() const { return transparencyMode_; }
+
+    /**
+     * Model LOD levels are picked from the fraction of the screen height a renderable's bounding
+     * sphere covers. A level only changes once the coverage passes its threshold by the
+     * hysteresis fraction, so objects on a boundary do not flicker. Renderables covering less
+     * than the cull coverage are skipped entirely, 0 disables that.
+     */
+    void  setLodHysteresis(float fraction) { lodHysteresis_ = fraction; }
+    float getLodHysteresis() const { return lodHysteresis_; }
+    void  setLodCullCoverage(float coverage) { lodCullCoverage_ = coverage; }
+    float getLodCullCoverage() const { return lodCullCoverage_; }
+
     /**
      * Direct access to graphics context (use sparingly)
      */
@@ -113,49 +200,186 @@ public:
     MaterialRenderer& getMaterialRenderer() { return materialRenderer_; };
 
 private:
+    void render(const std::vector<Renderable>& renderables,
+                const glm::mat4&               view,
+                const glm::mat4&               proj,
+                const glm::vec3&               cameraPos,
+                const Camera::Frustum&         frustum,
+                const Graphics::Framebuffer*   targetFB,
+                bool                           depthPrePass,
+                RenderPath                     path);
+
+    /**
+     * Fill the SoA bounds used by every culling test this frame
+     */
+    void buildCullBounds(const std::vector<Renderable>& renderables);
+
+    /**
+     * Run the frustum test over the current bounds, all visible when culling is disabled
+     */
+    void cullAgainst(const Camera::Frustum& frustum, std::vector<uint8_t>& visible) const;
+    void cullAgainst(const glm::vec3& center, float radius, std::vector<uint8_t>& visible) const;
+
+    /**
+     * Drop non-casters from shadowVisible_ and hash the remaining casters into lightHash
+     */
+    uint64_t collectShadowCasters(const std::vector<Renderable>& renderables, uint64_t lightHash);
+
+    enum class DrawPass : uint8_t {
+        Lit,            // Forward shaded into the target, opaque then sorted transparent
+        GBuffer,        // Deferred surface data
+        WeightedBlended // Order-independent transparency accumulation
+    };
+
+    DrawPass passFor(const Material& material, bool deferred, bool weightedBlended) const;
+
+    /**
+     * Sort the visible renderables into batches sharing model, material and winding, and stream
+     * the transforms of every instanced batch into instanceTexels_. Sorted transparent objects
+     * get a batch each.
+     */
+    void buildDrawBatches(const std::vector<Renderable>& renderables,
+                          const glm::mat4&               view,
+                          const glm::mat4&               proj,
+                          bool                           deferred,
+                          bool                           weightedBlended);
+
+    uint32_t selectLod(const Model& model, float coverage, uint32_t previous) const;
+
+    /**
+     * Write the depth of opaque batches with depth-only shaders, color writes masked off. Batches
+     * drawn here are marked so the lit pass draws them with an equal depth test.
+     */
+    void renderDepthPrePass(CommandBuffer&                 cmd,
+                            const std::vector<Renderable>& renderables,
+                            const glm::mat4&               view,
+                            const glm::mat4&               proj);
+
+    // Depth-only counterpart of the instanced default shader
+    Shader& getDepthInstancedShader();
+
+    /**
+     * Draw the batches assigned to one pass
+     */
+    void drawBatches(CommandBuffer&                 cmd,
+                     const std::vector<Renderable>& renderables,
+                     const glm::mat4&               view,
+                     const glm::mat4&               proj,
+                     const glm::vec3&               cameraPos,
+                     DrawPass                       pass);
+
+    /**
+     * Shade the G-buffer into the target with one full screen pass, lights come from the same
+     * clusters as forward shading. Writes depth so later forward draws are tested against it.
+     */
+    void renderDeferredLighting(CommandBuffer&               cmd,
+                                const glm::mat4&             view,
+                                const glm::mat4&             proj,
+                                const glm::vec3&             cameraPos,
+                                const Graphics::Framebuffer& targetFB);
+
+    /**
+     * Accumulate the weighted blended batches against a copy of the target's depth, then resolve
+     * them over the target in one full screen pass
+     */
+    void renderWeightedBlended(CommandBuffer&                 cmd,
+                               const std::vector<Renderable>& renderables,
+                               const glm::mat4&               view,
+                               const glm::mat4&               proj,
+                               const glm::vec3&               cameraPos,
+                               const Graphics::Framebuffer&   targetFB);
+
+    Model&  getFullscreenTriangle();
+    Shader& getOITCompositeShader();
+
     static void setupStandardUniforms(CommandBuffer& cmd,
                                Shader&        shader,
                                const glm::mat4&         model,
                                const glm::mat4&         view,
                                const glm::mat4&         proj);
 
+    static void setupViewUniforms(CommandBuffer&   cmd,
+                                  Shader&          shader,
+                                  const glm::mat4& view,
+                                  const glm::mat4& proj);
+
     void setupLightingUniforms(CommandBuffer& cmd,
                                Shader&        shader,
-                               const glm::vec3&         objectPos,
-                               float                    objectRadius,
                                const glm::vec3&         cameraPos);
 
     /**
      * Render shadow maps for current lights
      */
-    void renderShadowMaps(const std::vector<Renderable>& renderables);
+    void renderShadowMaps(const std::vector<Renderable>& renderables,
+                          const glm::mat4&               view,
+                          const glm::mat4&               proj);
 
-    void renderDirectionalShadowMap(const ShadowMap&                     shadowMap,
-                                    const glm::mat4&               lightSpaceMatrix,
-                                    const std::vector<Renderable>& renderables,
-                                    Shader&                        shadowShader) const;
+    void renderCascadedShadowMap(CascadedShadowMap&             cascades,
+                                 const std::vector<Renderable>& renderables,
+                                 Shader&                        shadowShader);
 
-    void renderPointShadowMap(CubemapShadow&                  cubemap,
+    void renderSpotShadowMap(const ShadowAtlasSlot&         slot,
+                             const std::vector<Renderable>& renderables,
+                             Shader&                        shadowShader);
+
+    void renderPointShadowMap(const ShadowAtlasSlot&          slot,
                               const Light&                    light,
                               const std::array<glm::mat4, 6>& lightMatrices,
-                              const std::vector<Renderable>&  renderables,
-                              Shader&               shadowShader) const;
-
-    /**
-     * Collect lights from ECS registry and add them to our lighting system
-     */
-    void collectLightsFromRegistry(entt::registry& registry);
-
-    /**
-     * Collect renderables from ECS registry
-     */
-    std::vector<Renderable> collectRenderables(entt::registry&     registry,
-                                               Core::AssetManager* assetManager);
+                              const std::vector<Renderable>&  renderables);
 
     GraphicsContext& context_;
     RenderStats                stats_;
     MaterialRenderer           materialRenderer_;
     LightingSystem             lighting_;
+
+    // Culling scratch, reused across frames to avoid allocations
+    bool                 frustumCulling_ = true;
+    SphereBoundsSoA      cullBounds_;
+    std::vector<uint8_t> visible_;
+    std::vector<uint8_t> shadowVisible_;
+    std::vector<uint8_t> faceVisible_;
+    std::vector<uint8_t> faceMasks_; // Bit per cube face a point shadow caster touches
+
+    bool          staticBatching_ = true;
+    StaticBatcher staticBatcher_;
+    RenderWorld   renderWorld_;
+
+    struct DrawItem {
+        const Material* material;
+        const Model*    model;
+        uint32_t        index;
+        float           depth; // View space, sorts opaque draws front to back
+        uint8_t         lod;
+        bool            wireframe;
+        bool            mirrored;
+    };
+
+    struct DrawBatch {
+        uint32_t first;          // Into drawItems_
+        uint32_t count;
+        int32_t  instanceOffset; // First instance in instanceBuffer_, -1 when drawn one by one
+        bool     prePassed;      // Depth already written by the pre-pass
+        DrawPass pass;
+    };
+
+    // Batching scratch, reused across frames to avoid allocations
+    std::vector<DrawItem>   drawItems_;
+    std::vector<DrawBatch>  drawBatches_;
+    std::vector<glm::vec4>  instanceTexels_;
+    std::vector<uint32_t>   instanceSources_; // Renderable index of each instance
+    Graphics::TextureBuffer instanceBuffer_;
+    Shader                  depthInstancedShader_;
+
+    float                                 lodHysteresis_   = 0.1f;
+    float                                 lodCullCoverage_ = 0.0f;
+    std::unordered_map<uint64_t, uint8_t> lodPrevious_; // Renderable id to level
+    std::unordered_map<uint64_t, uint8_t> lodCurrent_;
+
+    GBuffer               gbuffer_;
+    TransparencyMode      transparencyMode_ = TransparencyMode::Sorted;
+    WeightedBlendedBuffer oitBuffer_;
+    Shader                oitCompositeShader_;
+    Model                 fullscreenTriangle_;
 };
 
 }
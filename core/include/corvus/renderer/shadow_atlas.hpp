@@ -0,0 +1,85 @@
+#pragma once
+#include "corvus/graphics/graphics.hpp"
+#include <array>
+#include <cstdint>
+#include <glm/glm.hpp>
+#include <unordered_map>
+#include <vector>
+
+namespace Corvus::Renderer {
+
+/**
+ * Square region of the shadow atlas, in texels
+ */
+struct ShadowAtlasTile {
+    uint32_t x    = 0;
+    uint32_t y    = 0;
+    uint32_t size = 0;
+};
+
+/**
+ * Tiles owned by one shadowed light, one for a spot light and one per cube face for a point light.
+ * Kept across frames while the light keeps requesting the same tile size, so cached contents stay
+ * valid.
+ */
+struct ShadowAtlasSlot {
+    std::array<ShadowAtlasTile, 6> tiles {};
+    glm::mat4                      lightSpaceMatrix {}; // Spot lights only
+    uint64_t                       casterHash    = 0;   // Light and casters drawn, 0 if none
+    uint64_t                       lastFrame     = 0;
+    uint32_t                       tileCount     = 0;
+    uint32_t                       requestedSize = 0; // Tiles are smaller when the atlas was full
+};
+
+/**
+ * Single depth texture shared by all spot and point light shadows. Tiles are handed out by a
+ * quadtree (buddy) allocator: a tile of size S/2^n is split from a free tile one level up, and
+ * freed tiles merge back with their three siblings.
+ */
+class ShadowAtlas {
+public:
+    static constexpr uint32_t MIN_TILE_SIZE = 128;
+
+    Graphics::Texture2D   depthTexture;
+    Graphics::Framebuffer framebuffer;
+    uint32_t              size        = 0;
+    bool                  initialized = false;
+
+    void initialize(Graphics::GraphicsContext& ctx, uint32_t atlasSize);
+    void cleanup();
+
+    /**
+     * Start a frame, call retain for every light that still casts shadows and then
+     * releaseUnretained before acquiring, so freed space is available to new lights
+     */
+    void beginFrame() { ++frame_; }
+    void retain(uint64_t key, uint32_t tileCount, uint32_t tileSize);
+    void releaseUnretained();
+
+    /**
+     * Get the light's slot, allocating tiles if it has none. Tile size is rounded up to a power of
+     * two and halved until the tiles fit.
+     *
+     * @return nullptr when the atlas has no room left even at MIN_TILE_SIZE
+     */
+    ShadowAtlasSlot* acquire(uint64_t key, uint32_t tileCount, uint32_t tileSize);
+
+    /**
+     * Tile rectangle in texture coordinates, (offset.xy, scale.xy)
+     */
+    glm::vec4 uvRect(const ShadowAtlasTile& tile) const;
+
+private:
+    // Free tile origins per level, level 0 is the whole atlas
+    std::vector<std::vector<glm::uvec2>>          freeTiles_;
+    std::unordered_map<uint64_t, ShadowAtlasSlot> slots_;
+    uint64_t                                      frame_ = 0;
+
+    uint32_t levelOf(uint32_t tileSize) const;
+    uint32_t levelCount() const { return static_cast<uint32_t>(freeTiles_.size()); }
+    bool     allocateTile(uint32_t level, ShadowAtlasTile& tile);
+    void     freeTile(const ShadowAtlasTile& tile);
+    void     freeSlot(ShadowAtlasSlot& slot);
+};
+
+}
@@ -0,0 +1,101 @@
+#pragma once
+#include "corvus/graphics/graphics.hpp"
+#include "corvus/renderer/material.hpp"
+#include "corvus/renderer/model.hpp"
+#include "corvus/renderer/renderable.hpp"
+#include <glm/glm.hpp>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace Corvus::Renderer {
+
+/**
+ * A mesh that never moves, key identifies it across updates (the entity)
+ */
+struct StaticMeshInstance {
+    uint32_t  key         = 0;
+    Model*    model       = nullptr;
+    Material* material    = nullptr;
+    glm::mat4 transform   = glm::mat4(1.0f);
+    bool      castShadows = true;
+
+    bool operator==(const StaticMeshInstance& other) const {
+        return key == other.key && model == other.model && material == other.material
+            && transform == other.transform && castShadows == other.castShadows;
+    }
+};
+
+/**
+ * Merges static meshes sharing a material into world space chunks that draw in one call each.
+ * Meshes are binned into a uniform grid by position so a chunk stays small enough to cull, and a
+ * chunk is only rebuilt when a mesh in it was added, removed or edited.
+ */
+class StaticBatcher {
+public:
+    static constexpr float CHUNK_SIZE = 32.0f;
+
+    explicit StaticBatcher(Graphics::GraphicsContext& ctx);
+    ~StaticBatcher();
+
+    StaticBatcher(const StaticBatcher&)            = delete;
+    StaticBatcher& operator=(const StaticBatcher&) = delete;
+
+    /**
+     * Whether the model can be merged, needs CPU side triangles and no vertex colors since the
+     * merged vertices use the standard layout
+     */
+    static bool canBatch(const Model& model);
+
+    /**
+     * Bring the chunks in line with the current static meshes, unchanged chunks are kept as is
+     */
+    void update(const std::vector<StaticMeshInstance>& instances);
+
+    /**
+     * Drop every chunk, the next update rebuilds all of them
+     */
+    void invalidate();
+
+    /**
+     * Append one renderable per chunk, with an identity transform as vertices are in world space
+     */
+    void appendRenderables(std::vector<Renderable>& renderables);
+
+    uint32_t getChunkCount() const { return static_cast<uint32_t>(chunks_.size()); }
+    uint32_t getChunksRebuilt() const { return chunksRebuilt_; } // During the last update
+
+private:
+    struct ChunkKey {
+        Material*  material;
+        glm::ivec3 cell;
+        bool       castShadows;
+
+        bool operator==(const ChunkKey& other) const {
+            return material == other.material && cell == other.cell
+                && castShadows == other.castShadows;
+        }
+    };
+
+    struct ChunkKeyHash {
+        size_t operator()(const ChunkKey& key) const;
+    };
+
+    struct Chunk {
+        std::unique_ptr<Model>          model;
+        std::vector<StaticMeshInstance> members; // As of the last build
+        std::vector<StaticMeshInstance> pending; // Gathered this update
+        glm::vec3                       center { 0.0f };
+        float                           radius     = 0.0f;
+        uint64_t                        lastUpdate = 0;
+    };
+
+    void rebuild(Chunk& chunk);
+
+    Graphics::GraphicsContext&                        context_;
+    std::unordered_map<ChunkKey, Chunk, ChunkKeyHash> chunks_;
+    uint64_t                                          updateCount_   = 0;
+    uint32_t                                          chunksRebuilt_ = 0;
+};
+
+}
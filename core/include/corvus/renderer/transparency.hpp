@@ -0,0 +1,34 @@
+#pragma once
+#include "corvus/graphics/graphics.hpp"
+#include <cstdint>
+
+namespace Corvus::Renderer {
+
+// How blended materials are drawn after the opaque queue
+enum class TransparencyMode {
+    Sorted,         // One draw per object, back to front by view depth
+    WeightedBlended // Order independent, accumulated in one pass and resolved in another
+};
+
+/**
+ * Targets for weighted blended order-independent transparency (McGuire and Bavoil), sized to the
+ * render target. The opaque depth is copied in so transparent fragments behind it are rejected.
+ *   accum   RGBA16F  sum of weighted premultiplied color, product of 1 - alpha in a (revealage)
+ *   weight  R32F     sum of weighted alpha
+ */
+class WeightedBlendedBuffer {
+public:
+    Graphics::Texture2D   accum;
+    Graphics::Texture2D   weight;
+    Graphics::Texture2D   depth;
+    Graphics::Framebuffer framebuffer;
+    uint32_t              width       = 0;
+    uint32_t              height      = 0;
+    bool                  initialized = false;
+
+    // Recreates the targets only when the size changed
+    void resize(Graphics::GraphicsContext& ctx, uint32_t w, uint32_t h);
+    void cleanup();
+};
+
+}
@@ -3,23 +3,37 @@
 #include "corvus/components/component_registry.hpp"
 #include "corvus/components/mesh_renderer.hpp"
 #include "corvus/entity.hpp"
+#include "corvus/entity_list.hpp"
 #include "corvus/renderer/camera.hpp"
 #include "corvus/renderer/lighting.hpp"
 #include "corvus/renderer/scene_renderer.hpp"
+#include "corvus/scene_changes.hpp"
+#include "corvus/scene_snapshot.hpp"
+#include "corvus/transform_hierarchy.hpp"
 #include "entt/entt.hpp"
 #include <fstream>
+#include <span>
+#include <memory>
 #include <string>
 #include <string_view>
 #include <vector>
 
 namespace Corvus::Core {
 
+/**
+ * File format a scene is saved in, scenes keep the format they were loaded from
+ */
+enum class SceneFormat {
+    Json,
+    Binary
+};
+
 class Scene {
 public:
-    explicit Scene(const std::string_view& name, AssetManager* assetManager)
-        : name(name), assetManager(assetManager), renderer(nullptr) { }
+    explicit Scene(const std::string_view& name, AssetManager* assetManager);
 
-    std::vector<Entity>& getRootOrderedEntities() { return rootOrderedEntities; }
+    EntityList&       getRootOrderedEntities() { return rootOrderedEntities; }
+    const EntityList& getRootOrderedEntities() const { return rootOrderedEntities; }
 
     Scene(const Scene&)            = delete;
     Scene& operator=(const Scene&) = delete;
@@ -29,6 +43,42 @@ public:
     Entity createEntity(const std::string& entityName = std::string());
     void   destroyEntity(Entity entity);
 
+    /**
+     * Create count entities at once through the registry's range insert, for spawning large
+     * procedural content. They are appended to the root in order.
+     */
+    std::vector<Entity> createEntities(size_t count, const std::string& entityName = std::string());
+    void                destroyEntities(std::span<const Entity> entities);
+
+    /**
+     * Make child's transform relative to parent, a null parent moves it back to the root. The local
+     * transform is kept as is, so the child moves with the change of space.
+     */
+    void setParent(Entity child, Entity parent);
+
+    /**
+     * World matrices as of the last render
+     */
+    TransformHierarchy& getHierarchy() { return *hierarchy; }
+
+    /**
+     * Entities changed since the last save. Saving only has a const scene, the bookkeeping is not
+     * part of its state.
+     */
+    SceneChanges& getChanges() const { return *changes; }
+
+    /**
+     * Copy the registry and entity order in memory, for putting the scene back after playing it
+     * in the editor. Entity handles survive a restore, so selections and references stay valid.
+     */
+    SceneSnapshot snapshot();
+
+    /**
+     * Replace everything in the scene with the snapshot, which is used up. Unsaved changes are
+     * put back as they were when the snapshot was taken.
+     */
+    void restore(SceneSnapshot&& snapshot);
+
     /**
      * Render the scene using the new unified renderer
      *
@@ -47,6 +97,7 @@ public:
 
     std::string    name;
     entt::registry registry;
+    SceneFormat    format = SceneFormat::Json;
 
     template <class Archive>
     void serialize(Archive& ar) {
@@ -92,15 +143,18 @@ public:
         } else {
             CORVUS_CORE_TRACE("Starting scene serialization for scene: {}", name);
             CORVUS_CORE_TRACE("Serializing {} entities", rootOrderedEntities.size());
-            ar(cereal::make_nvp("entities", rootOrderedEntities));
+            const std::vector<Entity> entities = rootOrderedEntities.toVector();
+            ar(cereal::make_nvp("entities", entities));
             CORVUS_CORE_TRACE("Scene serialization complete");
         }
     }
 
 private:
-    std::vector<Entity>      rootOrderedEntities;
-    AssetManager*            assetManager;
-    Renderer::SceneRenderer* renderer;
+    EntityList                          rootOrderedEntities;
+    AssetManager*                       assetManager;
+    Renderer::SceneRenderer*            renderer;
+    std::unique_ptr<TransformHierarchy> hierarchy; // Heap allocated so its observers survive moves
+    std::unique_ptr<SceneChanges>       changes;   // Same as the hierarchy
 };
 
 }
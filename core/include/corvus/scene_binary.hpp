@@ -0,0 +1,65 @@
+#pragma once
+
+#include <cstdint>
+#include <entt/entity/fwd.hpp>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace Corvus::Core {
+class Scene;
+
+/**
+ * Binary scene files, an alternative to the JSON format for large scenes. Components are stored
+ * per type in contiguous blocks so loading inserts each type into the registry in one go instead
+ * of parsing and dispatching every component separately.
+ *
+ * Saving can append the records of changed entities instead of rewriting the file. Loading
+ * replays them in order over the blocks, so the last record of an entity wins.
+ *
+ * Layout, integers in the writer's byte order:
+ *   "CVSB", u32 version, u32 entity count, u32 block count, u32 name size, name
+ *   per block: u32 type name size, type name, u32 count, u32 component version, u32 stride,
+ *              u64 data size, u32 entity index[count], data
+ *   then any number of deltas: "CVSD", u32 record count, per record:
+ *              u8 kind, u32 id size, EntityInfo id, for written entities u32 component count
+ *              and per component u32 type name size, type name, u32 component version,
+ *              u64 data size, data
+ *
+ * Components of a registered type that can't be read (a newer version, or a raw layout the type
+ * has no migration for) fail the whole load rather than being skipped and lost on the next save.
+ */
+namespace SceneBinary {
+    constexpr char     MAGIC[4]       = { 'C', 'V', 'S', 'B' };
+    constexpr char     DELTA_MAGIC[4] = { 'C', 'V', 'S', 'D' };
+    constexpr uint32_t VERSION        = 3; // 2 added deltas, 3 component versions
+
+    /**
+     * True if the bytes start like a binary scene
+     */
+    bool isBinary(std::span<const char> bytes);
+
+    std::vector<char> write(const Scene& scene);
+
+    /**
+     * Records of the changed entities (whole entity, every registered component) and of the
+     * removed ones by EntityInfo id, to append to a binary scene of the same scene
+     */
+    std::vector<char> writeDelta(const Scene&                  scene,
+                                 std::span<const entt::entity> changed,
+                                 std::span<const std::string>  removed);
+
+    /**
+     * Replace the contents of scene with the binary scene in bytes, deltas included. Returns
+     * false and logs if the data is not a scene this version can read.
+     */
+    bool read(Scene& scene, std::span<const char> bytes);
+
+    /**
+     * Convert between the two formats, both throw if the input can't be parsed
+     */
+    std::vector<char> fromJson(std::span<const char> json);
+    std::string       toJson(std::span<const char> binary);
+}
+
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include "corvus/components/component_registry.hpp"
+#include <entt/entt.hpp>
+#include <mutex>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+namespace Corvus::Core {
+
+/**
+ * Entities whose registered components changed since the scene was last saved, so saving can
+ * write only their records. Also remembers what the scene file on disk holds, which decides
+ * between appending to it and rewriting it.
+ */
+class SceneChanges : public Components::ComponentListener {
+public:
+    SceneChanges() = default;
+    ~SceneChanges() override;
+
+    SceneChanges(const SceneChanges&)            = delete;
+    SceneChanges& operator=(const SceneChanges&) = delete;
+
+    void attach(entt::registry& registry);
+    void detach();
+
+    void onComponentChanged(entt::entity entity) override;
+
+    bool hasChanges() const;
+
+    /**
+     * Move out the entities changed since the last take (only those still alive) and the
+     * EntityInfo ids of the ones destroyed, then start over
+     */
+    void take(std::vector<entt::entity>& changed, std::vector<std::string>& removed);
+    void clear();
+
+    /**
+     * Everything not yet saved, copied out so a scene snapshot can put it back on restore
+     */
+    struct Pending {
+        std::unordered_set<entt::entity> changed;
+        std::vector<std::string>         removed;
+    };
+
+    Pending getPending() const;
+    void    setPending(Pending pending);
+
+    /**
+     * Size of the binary scene on disk and of the changes appended after it. A base of 0 means
+     * the file is not a binary scene, so changes can't be appended.
+     */
+    void   setSaved(size_t baseBytes, size_t deltaBytes);
+    size_t getSavedBaseBytes() const { return savedBaseBytes_; }
+    size_t getSavedDeltaBytes() const { return savedDeltaBytes_; }
+
+private:
+    void onInfoDestroyed(entt::registry& registry, entt::entity entity);
+
+    entt::registry* registry_ = nullptr;
+
+    // Game systems patch from job threads
+    mutable std::mutex               mutex_;
+    std::unordered_set<entt::entity> changed_;
+    std::vector<std::string>         removed_;
+
+    size_t savedBaseBytes_  = 0;
+    size_t savedDeltaBytes_ = 0;
+};
+
+}
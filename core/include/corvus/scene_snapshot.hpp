@@ -0,0 +1,46 @@
+#pragma once
+
+#include "corvus/components/component_registry.hpp"
+#include "corvus/entity_list.hpp"
+#include "corvus/scene_changes.hpp"
+#include <entt/entt.hpp>
+#include <memory>
+#include <vector>
+
+namespace Corvus::Core {
+class Scene;
+
+/**
+ * In memory copy of a scene's registry and entity order, taken before playing in the editor and
+ * restored when play stops. Nothing is serialized: the entity handles are copied as they are, and
+ * every registered component type is copied as a whole, memcpy for trivially copyable types.
+ * Generated meshes and asset handles are shared with the scene rather than duplicated.
+ *
+ * Components that are not registered are derived state (world transforms, disabled tags) and are
+ * rebuilt by the scene's observers as the registered ones are restored.
+ */
+class SceneSnapshot {
+public:
+    SceneSnapshot()                                = default;
+    SceneSnapshot(SceneSnapshot&&)                 = default;
+    SceneSnapshot& operator=(SceneSnapshot&&)      = default;
+    SceneSnapshot(const SceneSnapshot&)            = delete;
+    SceneSnapshot& operator=(const SceneSnapshot&) = delete;
+
+    /**
+     * False for a default constructed snapshot and once it has been restored
+     */
+    bool isValid() const { return valid; }
+
+private:
+    friend class Scene;
+
+    bool                                                        valid = false;
+    std::vector<entt::entity>                                   entities; // Registry handle pool
+    entt::entity                                                released = entt::null;
+    EntityList                                                  order;
+    std::vector<std::unique_ptr<Components::ComponentSnapshot>> components;
+    SceneChanges::Pending                                       pending;
+};
+
+}
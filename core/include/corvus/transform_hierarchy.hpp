@@ -0,0 +1,84 @@
+#pragma once
+
+#include "corvus/components/transform.hpp"
+#include "corvus/renderer/batch_transform.hpp"
+#include <atomic>
+#include <entt/entt.hpp>
+#include <unordered_map>
+#include <vector>
+
+namespace Corvus::Core {
+
+/**
+ * Resolves ParentComponent links of a registry and keeps the WorldTransformComponent of every
+ * entity with a transform up to date.
+ *
+ * Entities are stored structure of arrays and sorted by depth, so a parent is always finished
+ * before its children. Editing a transform marks it dirty, update then recomputes only the dirty
+ * entities and everything below them, one depth level at a time, and patches the world transforms
+ * that changed. Untouched entities never recompute their matrices. Adding, removing or reparenting
+ * transforms lays the entities out again, but keeps the matrices of those that didn't move.
+ */
+class TransformHierarchy {
+public:
+    TransformHierarchy() = default;
+    ~TransformHierarchy();
+
+    TransformHierarchy(const TransformHierarchy&)            = delete;
+    TransformHierarchy& operator=(const TransformHierarchy&) = delete;
+
+    /**
+     * Observe a registry, dropping the previous one. Everything is rebuilt on the next update.
+     */
+    void attach(entt::registry& registry);
+    void detach();
+
+    void update();
+
+    /**
+     * Cached world matrix, identity for entities the hierarchy has not seen yet
+     */
+    const glm::mat4& getWorldMatrix(entt::entity entity) const;
+    entt::entity     getParent(entt::entity entity) const;
+
+    uint32_t getDepthCount() const { return levels_.empty() ? 0 : uint32_t(levels_.size() - 1); }
+    uint32_t getUpdatedCount() const { return updated_; } // Recomputed during the last update
+
+private:
+    void onStructureChanged(entt::registry& registry, entt::entity entity);
+    void onTransformAdded(entt::registry& registry, entt::entity entity);
+    void onTransformChanged(entt::registry& registry, entt::entity entity);
+
+    // Resolve parents and lay entities out by depth, new and reparented entities come out dirty
+    void rebuild();
+
+    static constexpr uint32_t NO_PARENT = ~0u;
+
+    enum DirtyFlags : uint8_t {
+        LOCAL_DIRTY = 1 << 0, // Own transform edited
+        WORLD_DIRTY = 1 << 1, // World matrix has to be recomputed
+    };
+
+    entt::registry* registry_ = nullptr;
+
+    std::vector<entt::entity> entities_;
+    std::vector<uint32_t>     parents_; // Index of the parent, always before the child
+    std::vector<glm::mat4>    local_;
+    std::vector<glm::mat4>    world_;
+    std::vector<uint8_t>      flags_;
+    std::vector<uint32_t>     levels_; // First index of each depth, then the end
+
+    std::unordered_map<entt::entity, uint32_t> indices_;
+    std::vector<entt::entity>                  added_; // Transform constructed since the rebuild
+
+    // Transforms edited since the last update, reused between updates
+    std::vector<uint32_t>  editedIndices_;
+    Renderer::TransformSoA editedPoses_;
+    std::vector<glm::mat4> editedLocal_;
+
+    std::atomic<bool> structureChanged_ { true };
+    std::atomic<bool> pending_ { false }; // Some transform was edited since the last update
+    uint32_t          updated_ = 0;
+};
+
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <istream>
+#include <span>
+#include <streambuf>
+
+namespace Corvus::Core {
+
+/**
+ * Input stream reading straight out of a block of memory, such as a mapped file, without copying
+ * it into a string first. The memory has to outlive the stream.
+ */
+class MemoryInputStream : public std::istream {
+public:
+    explicit MemoryInputStream(const std::span<const char> bytes) : std::istream(&buffer_) {
+        char* begin = const_cast<char*>(bytes.data());
+        buffer_.set(begin, begin + bytes.size());
+    }
+
+private:
+    class Buffer : public std::streambuf {
+    public:
+        void set(char* begin, char* end) { setg(begin, begin, end); }
+    };
+
+    Buffer buffer_;
+};
+
+}
@@ -4,6 +4,7 @@
 #include "corvus/files/static_resource_file.hpp"
 #include "corvus/graphics/graphics.hpp"
 #include "corvus/graphics/opengl_context.hpp"
+#include "corvus/jobs/job_system.hpp"
 #include "corvus/log.hpp"
 #include "imgui.h"
 #include "physfs.h"
@@ -15,6 +16,9 @@ Application::Application(unsigned int width, unsigned int height, const std::str
     PHYSFS_init(nullptr);
     PHYSFS_mount("engine.zip", nullptr, 1);
 
+    // Started here so the thread owning the window and graphics context is the main thread
+    JobSystem::get();
+
     constexpr auto windowAPI   = Graphics::WindowAPI::GLFW;
     constexpr auto graphicsAPI = Graphics::GraphicsAPI::OpenGL;
 
@@ -83,6 +87,12 @@ void Application::run() {
         window->pollEvents();
         window->getFramebufferSize(fbw, fbh);
 
+        // The window timer restarts when read, so it is read once and shared by everything
+        const double deltaTime = window->getDeltaTime();
+
+        // Uploads and other graphics work handed back by jobs since the last frame
+        JobSystem::get().pumpMainThread();
+
         graphicsContext->beginFrame();
         {
             auto cmd = graphicsContext->createCommandBuffer();
@@ -94,11 +104,11 @@ void Application::run() {
         }
 
         for (Layer* layer : layerStack)
-            layer->onUpdate();
+            layer->onUpdate(deltaTime);
 
         // ImGui Frame
         ImGuiIO& io                = ImGui::GetIO();
-        io.DeltaTime               = static_cast<float>(window->getDeltaTime());
+        io.DeltaTime               = static_cast<float>(deltaTime);
         io.DisplaySize             = ImVec2(static_cast<float>(fbw), static_cast<float>(fbh));
         io.DisplayFramebufferScale = ImVec2(1.0f, 1.0f);
         imguiRenderer.newFrame();
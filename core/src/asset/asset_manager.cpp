@@ -103,6 +103,10 @@ AssetManager::~AssetManager() {
     stopFileWatcher();
     shuttingDown.store(true, std::memory_order_relaxed);
 
+    // Background saves still need the asset root
+    for (const auto& [type, loader] : loaders)
+        loader->flush();
+
     decltype(assets) localAssets;
     {
         std::lock_guard<std::mutex> lock(assetMutex);
@@ -379,6 +383,7 @@ bool AssetManager::deleteAsset(const UUID& id) {
 
         metadata.erase(id);
         fileModificationTimes.erase(internalPath);
+        dataGeneration.fetch_add(1, std::memory_order_release);
 
         CORVUS_CORE_INFO("Deleted asset: {}", internalPath);
     }
@@ -827,18 +832,21 @@ void AssetManager::decrementRef(const UUID& id) {
 
 void AssetManager::unload(const UUID& id) {
     std::lock_guard<std::mutex> lock(assetMutex);
-    assets.erase(id);
+    if (assets.erase(id) > 0)
+        dataGeneration.fetch_add(1, std::memory_order_release);
     CORVUS_CORE_INFO("Unloaded asset: {}", boost::uuids::to_string(id));
 }
 
 void AssetManager::unloadUnused() {
     std::lock_guard<std::mutex> lock(assetMutex);
-    std::erase_if(assets, [](const auto& pair) { return pair.second.refCount <= 0; });
+    if (std::erase_if(assets, [](const auto& pair) { return pair.second.refCount <= 0; }) > 0)
+        dataGeneration.fetch_add(1, std::memory_order_release);
 }
 
 void AssetManager::unloadAll() {
     std::lock_guard<std::mutex> lock(assetMutex);
     assets.clear();
+    dataGeneration.fetch_add(1, std::memory_order_release);
     CORVUS_CORE_INFO("Unloaded all assets");
 }
 
@@ -988,7 +996,8 @@ void AssetManager::checkFileChanges() {
             }
 
             // Unload the asset if loaded
-            assets.erase(deletedId);
+            if (assets.erase(deletedId) > 0)
+                dataGeneration.fetch_add(1, std::memory_order_release);
         }
     }
 }
@@ -1088,6 +1097,7 @@ bool AssetManager::reloadAsset(const UUID& id) {
     }
 
     entry.lastModified = getFileModTime(entry.path);
+    dataGeneration.fetch_add(1, std::memory_order_release);
     return true;
 }
 
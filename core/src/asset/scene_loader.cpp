@@ -0,0 +1,178 @@
+#include "corvus/asset/scene_loader.hpp"
+
+#include "corvus/files/mapped_file.hpp"
+#include "corvus/scene_binary.hpp"
+#include "corvus/util/memory_stream.hpp"
+#include <cereal/archives/json.hpp>
+#include <physfs.h>
+#include <span>
+
+namespace Corvus::Core {
+
+SceneLoader::~SceneLoader() { flush(); }
+
+void SceneLoader::flush() {
+    std::lock_guard lock(writerMutex);
+    if (writer.joinable())
+        writer.join();
+}
+
+Scene* SceneLoader::loadTyped(const std::string& path) {
+    flush();
+
+    // Files on disk are mapped so binary scenes are read in place, the rest go through PhysFS
+    std::vector<char>           buffer;
+    std::span<const char>       bytes;
+    std::unique_ptr<MappedFile> mapped = MappedFile::openPhysFS(path);
+    if (mapped) {
+        bytes = mapped->bytes();
+    } else {
+        PHYSFS_File* file = PHYSFS_openRead(path.c_str());
+        if (!file) {
+            CORVUS_CORE_ERROR("Failed to open scene file: {}", path);
+            return nullptr;
+        }
+
+        PHYSFS_sint64 fileSize = PHYSFS_fileLength(file);
+        buffer.resize(fileSize);
+        PHYSFS_readBytes(file, buffer.data(), fileSize);
+        PHYSFS_close(file);
+        bytes = buffer;
+    }
+
+    try {
+        Scene* scene = new Scene("Loading...", getAssetManager());
+
+        if (SceneBinary::isBinary(bytes)) {
+            if (!SceneBinary::read(*scene, bytes)) {
+                delete scene;
+                CORVUS_CORE_ERROR("Failed to read binary scene file {}", path);
+                return nullptr;
+            }
+            scene->format = SceneFormat::Binary;
+        } else {
+            MemoryInputStream        stream(bytes);
+            cereal::JSONInputArchive ar(stream);
+            ar(cereal::make_nvp("scene", *scene));
+
+            // JSON can't be appended to, the first save rewrites it
+            scene->getChanges().clear();
+            scene->getChanges().setSaved(0, 0);
+        }
+
+        CORVUS_CORE_INFO("Loaded scene: {}", scene->name);
+        return scene;
+    } catch (const std::exception& e) {
+        CORVUS_CORE_ERROR("Failed to parse scene file {}: {}", path, e.what());
+        return nullptr;
+    }
+}
+
+bool SceneLoader::saveTyped(const Scene* scene, const std::string& path) {
+    if (!scene) {
+        CORVUS_CORE_ERROR("Cannot save null scene");
+        return false;
+    }
+
+    // A failed write leaves the file in an unknown state, so the next save rewrites it
+    flush();
+    const bool lastFailed = writeFailed.exchange(false);
+
+    try {
+        PendingWrite pending;
+
+        // path is already the correct PhysFS path (e.g., "project/scenes/Hello.scene")
+        // For writes, we need to strip the mount alias prefix
+        pending.path    = path;
+        size_t slashPos = pending.path.find('/');
+        if (slashPos != std::string::npos) {
+            pending.path = pending.path.substr(slashPos + 1);
+        }
+
+        auto& changes = scene->getChanges();
+        if (scene->format == SceneFormat::Binary && changes.getSavedBaseBytes() > 0
+            && !lastFailed) {
+            std::vector<entt::entity> changed;
+            std::vector<std::string>  removed;
+            changes.take(changed, removed);
+            if (changed.empty() && removed.empty()) {
+                CORVUS_CORE_INFO("Scene unchanged, nothing to save: {}", path);
+                return true;
+            }
+
+            // Past half the base, replaying the changes on load costs more than rewriting once
+            auto         delta      = SceneBinary::writeDelta(*scene, changed, removed);
+            const size_t deltaBytes = changes.getSavedDeltaBytes() + delta.size();
+            if (deltaBytes <= changes.getSavedBaseBytes() / 2) {
+                CORVUS_CORE_INFO("Saving {} changed and {} removed entities of {}",
+                                 changed.size(),
+                                 removed.size(),
+                                 path);
+                changes.setSaved(changes.getSavedBaseBytes(), deltaBytes);
+                pending.data   = std::move(delta);
+                pending.append = true;
+            }
+        }
+
+        // Full saves snapshot the per type blocks, JSON is produced from them off this thread
+        if (!pending.append) {
+            changes.clear();
+            pending.data = SceneBinary::write(*scene);
+            pending.json = scene->format == SceneFormat::Json;
+            changes.setSaved(pending.json ? 0 : pending.data.size(), 0);
+        }
+
+        std::lock_guard lock(writerMutex);
+        writer = std::thread([this, pending = std::move(pending)] { write(pending); });
+        return true;
+    } catch (const std::exception& e) {
+        // Changes taken before the throw are neither in the file nor pending any more, only a
+        // full save writes them again
+        scene->getChanges().setSaved(0, 0);
+        CORVUS_CORE_ERROR("Failed to save scene {}: {}", path, e.what());
+        return false;
+    }
+}
+
+void SceneLoader::write(const PendingWrite& pending) {
+    try {
+        std::string           json;
+        std::span<const char> data = pending.data;
+        if (pending.json) {
+            json = SceneBinary::toJson(pending.data);
+            data = json;
+        }
+
+        auto lastSlash = pending.path.find_last_of('/');
+        if (lastSlash != std::string::npos) {
+            PHYSFS_mkdir(pending.path.substr(0, lastSlash).c_str());
+        }
+
+        PHYSFS_File* file = pending.append ? PHYSFS_openAppend(pending.path.c_str())
+                                           : PHYSFS_openWrite(pending.path.c_str());
+        if (!file) {
+            CORVUS_CORE_ERROR("Failed to open scene for write: {}", pending.path);
+            writeFailed = true;
+            return;
+        }
+
+        PHYSFS_sint64 written = PHYSFS_writeBytes(file, data.data(), data.size());
+        PHYSFS_close(file);
+
+        if (written != static_cast<PHYSFS_sint64>(data.size())) {
+            CORVUS_CORE_ERROR("Failed to write complete scene data: {}", pending.path);
+            writeFailed = true;
+            return;
+        }
+
+        CORVUS_CORE_INFO("Scene {}: {} ({} bytes)",
+                         pending.append ? "changes appended" : "saved",
+                         pending.path,
+                         data.size());
+    } catch (const std::exception& e) {
+        CORVUS_CORE_ERROR("Failed to save scene {}: {}", pending.path, e.what());
+        writeFailed = true;
+    }
+}
+
+}
@@ -50,6 +50,76 @@ bool ComponentRegistry::hasComponent(std::type_index typeIdx,
     return false;
 }
 
+bool ComponentRegistry::writeComponentBlock(const std::string&     typeName,
+                                            entt::registry&        registry,
+                                            const EntityPositions& positions,
+                                            ComponentBlock&        block) {
+    const auto it = blockWriters.find(typeName);
+    if (it == blockWriters.end())
+        return false;
+
+    it->second(registry, positions, block);
+    return true;
+}
+
+bool ComponentRegistry::readComponentBlock(const std::string&                  typeName,
+                                           entt::registry&                     registry,
+                                           const std::span<const entt::entity> owners,
+                                           const uint32_t                      version,
+                                           const uint32_t                      stride,
+                                           const std::span<const char>         data) {
+    const auto it = blockReaders.find(typeName);
+    return it != blockReaders.end() && it->second(registry, owners, version, stride, data);
+}
+
+bool ComponentRegistry::serializeComponentBinary(const std::string& typeName,
+                                                 const entt::entity entity,
+                                                 entt::registry&    registry,
+                                                 std::string&       out,
+                                                 uint32_t&          version) {
+    const auto it = binarySerializers.find(typeName);
+    return it != binarySerializers.end() && it->second(entity, registry, out, version);
+}
+
+bool ComponentRegistry::deserializeComponentBinary(const std::string&          typeName,
+                                                   const entt::entity          entity,
+                                                   entt::registry&             registry,
+                                                   const uint32_t              version,
+                                                   const std::span<const char> data) {
+    const auto it = binaryDeserializers.find(typeName);
+    return it != binaryDeserializers.end() && it->second(entity, registry, version, data);
+}
+
+bool ComponentRegistry::isRegistered(const std::string& typeName) const {
+    return nameToType.contains(typeName);
+}
+
+void ComponentRegistry::removeComponent(const std::string& typeName,
+                                        const entt::entity entity,
+                                        entt::registry&    registry) {
+    if (const auto it = removers.find(typeName); it != removers.end())
+        it->second(entity, registry);
+}
+
+void ComponentRegistry::connectListener(entt::registry& registry, ComponentListener& listener) {
+    for (const auto& connector : listenerConnectors | std::views::values)
+        connector(registry, listener, true);
+}
+
+void ComponentRegistry::disconnectListener(entt::registry& registry, ComponentListener& listener) {
+    for (const auto& connector : listenerConnectors | std::views::values)
+        connector(registry, listener, false);
+}
+
+std::vector<std::unique_ptr<ComponentSnapshot>>
+ComponentRegistry::snapshotComponents(entt::registry& registry) {
+    std::vector<std::unique_ptr<ComponentSnapshot>> result;
+    result.reserve(snapshots.size());
+    for (const auto& snapshot : snapshots | std::views::values)
+        result.push_back(snapshot(registry));
+    return result;
+}
+
 std::vector<std::string> ComponentRegistry::getRegisteredTypes() const {
     std::vector<std::string> types;
     for (const auto& key : nameToType | std::views::keys) {
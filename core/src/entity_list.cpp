@@ -0,0 +1,49 @@
+#include "corvus/entity_list.hpp"
+
+namespace Corvus::Core {
+
+void EntityList::push_back(const Entity& entity) {
+    // Squeezed here rather than in erase so destroying entities while iterating stays safe
+    if (slots_.size() >= 64 && indices_.size() * 2 < slots_.size())
+        compact();
+
+    const auto [it, inserted]
+        = indices_.try_emplace(entt::entity(entity), static_cast<uint32_t>(slots_.size()));
+    if (inserted)
+        slots_.push_back(entity);
+}
+
+bool EntityList::erase(const Entity& entity) {
+    const auto it = indices_.find(entt::entity(entity));
+    if (it == indices_.end())
+        return false;
+
+    slots_[it->second] = Entity();
+    indices_.erase(it);
+    return true;
+}
+
+void EntityList::clear() {
+    slots_.clear();
+    indices_.clear();
+}
+
+bool EntityList::contains(const Entity& entity) const {
+    return indices_.find(entt::entity(entity)) != indices_.end();
+}
+
+std::vector<Entity> EntityList::toVector() const { return std::vector<Entity>(begin(), end()); }
+
+void EntityList::compact() {
+    size_t live = 0;
+    for (size_t i = 0; i < slots_.size(); ++i) {
+        if (!slots_[i])
+            continue;
+
+        indices_[entt::entity(slots_[i])] = static_cast<uint32_t>(live);
+        slots_[live++]                    = slots_[i];
+    }
+    slots_.resize(live);
+}
+
+}
@@ -0,0 +1,106 @@
+#include "corvus/files/mapped_file.hpp"
+
+#include <filesystem>
+#include <physfs.h>
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace Corvus::Core {
+
+std::unique_ptr<MappedFile> MappedFile::open(const std::string& path) {
+    std::unique_ptr<MappedFile> mapped(new MappedFile());
+
+#if defined(_WIN32)
+    HANDLE file = CreateFileA(path.c_str(),
+                              GENERIC_READ,
+                              FILE_SHARE_READ,
+                              nullptr,
+                              OPEN_EXISTING,
+                              FILE_ATTRIBUTE_NORMAL,
+                              nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+        return nullptr;
+    mapped->file_ = file;
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size) || size.QuadPart == 0)
+        return nullptr;
+
+    mapped->mapping_ = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!mapped->mapping_)
+        return nullptr;
+
+    mapped->data_
+        = static_cast<const char*>(MapViewOfFile(mapped->mapping_, FILE_MAP_READ, 0, 0, 0));
+    if (!mapped->data_)
+        return nullptr;
+    mapped->size_ = static_cast<size_t>(size.QuadPart);
+#else
+    const int file = ::open(path.c_str(), O_RDONLY);
+    if (file < 0)
+        return nullptr;
+
+    struct stat info { };
+    if (fstat(file, &info) != 0 || info.st_size == 0) {
+        ::close(file);
+        return nullptr;
+    }
+
+    // The mapping keeps its own reference to the file
+    void* data = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, file, 0);
+    ::close(file);
+    if (data == MAP_FAILED)
+        return nullptr;
+
+    mapped->data_ = static_cast<const char*>(data);
+    mapped->size_ = static_cast<size_t>(info.st_size);
+#endif
+
+    return mapped;
+}
+
+std::unique_ptr<MappedFile> MappedFile::openPhysFS(const std::string& path) {
+    const char* realDir = PHYSFS_getRealDir(path.c_str());
+    if (!realDir)
+        return nullptr;
+
+    // The path is relative to where the directory is mounted
+    std::string relative = path;
+    if (const char* mountPoint = PHYSFS_getMountPoint(realDir)) {
+        const std::string prefix = mountPoint;
+        if (!prefix.empty() && prefix != "/" && relative.starts_with(prefix))
+            relative = relative.substr(prefix.size());
+    }
+
+    // Archives are files themselves, only mounted directories hold real files
+    std::error_code             error;
+    const std::filesystem::path realPath = std::filesystem::path(realDir) / relative;
+    if (!std::filesystem::is_regular_file(realPath, error))
+        return nullptr;
+
+    return open(realPath.string());
+}
+
+MappedFile::~MappedFile() {
+#if defined(_WIN32)
+    if (data_)
+        UnmapViewOfFile(data_);
+    if (mapping_)
+        CloseHandle(mapping_);
+    if (file_)
+        CloseHandle(file_);
+#else
+    if (data_)
+        munmap(const_cast<char*>(data_), size_);
+#endif
+}
+
+}
@@ -1,5 +1,6 @@
 #include "corvus/graphics/graphics.hpp"
 #include "corvus/graphics/opengl_context.hpp"
+#include <algorithm>
 #include <optional>
 
 namespace Corvus::Graphics {
@@ -95,6 +96,11 @@ void VertexBuffer::release() {
     }
 }
 
+void VertexBuffer::setLabel(const char* label) const {
+    if (valid())
+        be->setObjectLabel(ResourceType::VBO, id, label);
+}
+
 // IndexBuffer implementation
 void IndexBuffer::setData(CommandBuffer& cmd, const void* indices, uint32_t newCount, bool is16) {
     if (valid()) {
@@ -113,6 +119,11 @@ void IndexBuffer::release() {
     }
 }
 
+void IndexBuffer::setLabel(const char* label) const {
+    if (valid())
+        be->setObjectLabel(ResourceType::IBO, id, label);
+}
+
 // VertexArray implementation
 void VertexArray::addVertexBuffer(const VertexBuffer& vb, const VertexBufferLayout& layout) const {
     if (!valid() || !vb.valid())
@@ -144,6 +155,11 @@ void VertexArray::release() {
     }
 }
 
+void VertexArray::setLabel(const char* label) const {
+    if (valid())
+        be->setObjectLabel(ResourceType::VAO, id, label);
+}
+
 // Shader implementation
 void Shader::setUniform(CommandBuffer& cmd, const char* name, const float* m16) const {
     if (valid())
@@ -193,6 +209,11 @@ void Shader::release() {
     }
 }
 
+void Shader::setLabel(const char* label) const {
+    if (valid())
+        be->setObjectLabel(ResourceType::Shader, id, label);
+}
+
 // Texture2D implementation
 void Texture2D::setData(const void* data, uint32_t sizeBytes) {
     if (valid())
@@ -208,6 +229,11 @@ void Texture2D::release() {
     }
 }
 
+void Texture2D::setLabel(const char* label) const {
+    if (valid())
+        be->setObjectLabel(ResourceType::Tex2D, id, label);
+}
+
 // TextureCube implementation
 void TextureCube::release() {
     if (valid()) {
@@ -218,6 +244,48 @@ void TextureCube::release() {
     }
 }
 
+void TextureCube::setLabel(const char* label) const {
+    if (valid())
+        be->setObjectLabel(ResourceType::TexCube, id, label);
+}
+
+// Texture2DArray implementation
+void Texture2DArray::release() {
+    if (valid()) {
+        be->enqueueDelete(ResourceType::Tex2DArray, id);
+        id    = 0;
+        be    = nullptr;
+        width = height = layers = 0;
+    }
+}
+
+void Texture2DArray::setLabel(const char* label) const {
+    if (valid())
+        be->setObjectLabel(ResourceType::Tex2DArray, id, label);
+}
+
+// TextureBuffer implementation
+void TextureBuffer::setData(CommandBuffer& cmd, const void* data, uint32_t size) {
+    if (valid()) {
+        cmd.updateTextureBuffer(*this, data, size);
+        sizeBytes = size;
+    }
+}
+
+void TextureBuffer::setLabel(const char* label) const {
+    if (valid())
+        be->setObjectLabel(ResourceType::TexBuffer, id, label);
+}
+
+void TextureBuffer::release() {
+    if (valid()) {
+        be->enqueueDelete(ResourceType::TexBuffer, id);
+        id        = 0;
+        be        = nullptr;
+        sizeBytes = 0;
+    }
+}
+
 // Framebuffer implementation
 void Framebuffer::attachTexture2D(const Texture2D& tex, uint32_t attachment) {
     if (valid() && tex.valid())
@@ -234,6 +302,21 @@ void Framebuffer::attachDepthTexture(const Texture2D& tex) {
         be->fbAttachDepthTexture(id, tex.id);
 }
 
+void Framebuffer::attachDepthTextureLayer(const Texture2DArray& tex, uint32_t layer) {
+    if (valid() && tex.valid())
+        be->fbAttachDepthTextureLayer(id, tex.id, layer);
+}
+
+void Framebuffer::attachDepthTextureCube(const TextureCube& tex) {
+    if (valid() && tex.valid())
+        be->fbAttachDepthTextureCube(id, tex.id);
+}
+
+void Framebuffer::setLabel(const char* label) const {
+    if (valid())
+        be->setObjectLabel(ResourceType::FBO, id, label);
+}
+
 void Framebuffer::release() {
     if (valid()) {
         be->enqueueDelete(ResourceType::FBO, id);
@@ -243,6 +326,49 @@ void Framebuffer::release() {
     }
 }
 
+// StorageBuffer implementation
+void StorageBuffer::setData(CommandBuffer& cmd, const void* data, uint32_t size, uint32_t offset) {
+    if (valid()) {
+        cmd.updateStorageBuffer(*this, data, size, offset);
+        sizeBytes = std::max(sizeBytes, offset + size);
+    }
+}
+
+void StorageBuffer::getData(void* out, uint32_t size, uint32_t offset) const {
+    if (valid())
+        be->sbGetData(id, out, size, offset);
+}
+
+void StorageBuffer::release() {
+    if (valid()) {
+        be->enqueueDelete(ResourceType::SSBO, id);
+        id        = 0;
+        be        = nullptr;
+        sizeBytes = 0;
+    }
+}
+
+void StorageBuffer::setLabel(const char* label) const {
+    if (valid())
+        be->setObjectLabel(ResourceType::SSBO, id, label);
+}
+
+// PixelReadback implementation
+bool PixelReadback::ready() const { return valid() && be->readbackReady(id); }
+
+bool PixelReadback::getData(std::vector<uint8_t>& out) const {
+    return valid() && be->readbackGetData(id, out);
+}
+
+void PixelReadback::release() {
+    if (valid()) {
+        be->enqueueDelete(ResourceType::Readback, id);
+        id    = 0;
+        be    = nullptr;
+        width = height = 0;
+    }
+}
+
 // CommandBuffer implementation
 void CommandBuffer::begin() {
     if (valid())
@@ -279,6 +405,35 @@ void CommandBuffer::setLineWidth(float width) {
         be->cmdSetLineWidth(id, width);
 }
 
+void CommandBuffer::setClipDistances(uint32_t count) {
+    if (valid())
+        be->cmdSetClipDistances(id, count);
+}
+
+void CommandBuffer::setDepthFunc(DepthFunc func) {
+    if (valid())
+        be->cmdSetDepthFunc(id, func);
+}
+
+void CommandBuffer::setColorMask(bool enable) {
+    if (valid())
+        be->cmdSetColorMask(id, enable);
+}
+
+void CommandBuffer::setBlendFunc(BlendFunc func) {
+    if (valid())
+        be->cmdSetBlendFunc(id, func);
+}
+
+void CommandBuffer::blitFramebuffer(const Framebuffer& src,
+                                    const Framebuffer& dst,
+                                    bool               color,
+                                    bool               depth) {
+    if (valid() && src.valid() && dst.valid())
+        be->cmdBlitFramebuffer(
+            id, { src.id, src.width, src.height, dst.id, dst.width, dst.height, color, depth });
+}
+
 void CommandBuffer::bindTexture(uint32_t                   slot,
                                 const Texture2D&           t,
                                 std::optional<std::string> uniformName) {
@@ -293,6 +448,20 @@ void CommandBuffer::bindTextureCube(uint32_t                   slot,
         be->cmdBindTextureCube(id, slot, t.id, uniformName);
 }
 
+void CommandBuffer::bindTextureBuffer(uint32_t                   slot,
+                                      const TextureBuffer&       t,
+                                      std::optional<std::string> uniformName) {
+    if (valid() && t.valid())
+        be->cmdBindTextureBuffer(id, slot, t.id, uniformName);
+}
+
+void CommandBuffer::bindTextureArray(uint32_t                   slot,
+                                     const Texture2DArray&      t,
+                                     std::optional<std::string> uniformName) {
+    if (valid() && t.valid())
+        be->cmdBindTextureArray(id, slot, t.id, uniformName);
+}
+
 void CommandBuffer::drawIndexed(uint32_t      elemCount,
                                 bool          index16,
                                 uint32_t      indexOffset,
@@ -301,6 +470,15 @@ void CommandBuffer::drawIndexed(uint32_t      elemCount,
         be->cmdDrawIndexed(id, elemCount, index16, indexOffset, primitive);
 }
 
+void CommandBuffer::drawIndexedInstanced(uint32_t      elemCount,
+                                         bool          index16,
+                                         uint32_t      instanceCount,
+                                         uint32_t      indexOffset,
+                                         PrimitiveType primitive) {
+    if (valid() && instanceCount > 0)
+        be->cmdDrawIndexedInstanced(id, elemCount, index16, instanceCount, indexOffset, primitive);
+}
+
 void CommandBuffer::bindFramebuffer(const Framebuffer& fb) {
     if (valid() && fb.valid())
         be->cmdBindFramebuffer(id, fb.id, fb.width, fb.height);
@@ -344,6 +522,16 @@ void CommandBuffer::enableScissor(bool enable) {
         be->cmdEnableScissor(id, enable);
 }
 
+void CommandBuffer::pushDebugGroup(const char* name) {
+    if (valid())
+        be->cmdPushDebugGroup(id, name);
+}
+
+void CommandBuffer::popDebugGroup() {
+    if (valid())
+        be->cmdPopDebugGroup(id);
+}
+
 void CommandBuffer::release() {
     id = 0;
     be = nullptr;
@@ -362,6 +550,11 @@ void CommandBuffer::updateIndexBuffer(const IndexBuffer& ib,
         be->cmdUpdateIndexBuffer(id, ib.id, data, count, index16);
 }
 
+void CommandBuffer::updateTextureBuffer(const TextureBuffer& tb, const void* data, uint32_t size) {
+    if (valid() && tb.valid())
+        be->cmdUpdateTextureBuffer(id, tb.id, data, size);
+}
+
 void CommandBuffer::setShaderUniformMat4(const Shader& shader, const char* name, const float* m16) {
     if (valid() && shader.valid())
         be->cmdSetShaderUniformMat4(id, shader.id, name, m16);
@@ -408,4 +601,45 @@ void CommandBuffer::setDepthMask(bool enable) {
         be->cmdSetDepthMask(id, enable);
 }
 
+void CommandBuffer::updateStorageBuffer(const StorageBuffer& sb,
+                                        const void*          data,
+                                        uint32_t             size,
+                                        uint32_t             offset) {
+    if (valid() && sb.valid())
+        be->cmdUpdateStorageBuffer(id, sb.id, data, size, offset);
+}
+
+void CommandBuffer::bindStorageBuffer(uint32_t slot, const StorageBuffer& sb) {
+    if (valid() && sb.valid())
+        be->cmdBindStorageBuffer(id, slot, sb.id);
+}
+
+void CommandBuffer::bindImageTexture(
+    uint32_t unit, const Texture2D& t, ImageAccess access, ImageFormat format, uint32_t level) {
+    if (valid() && t.valid())
+        be->cmdBindImageTexture(id, unit, t.id, access, format, level);
+}
+
+void CommandBuffer::dispatch(uint32_t x, uint32_t y, uint32_t z) {
+    if (valid())
+        be->cmdDispatch(id, x, y, z);
+}
+
+void CommandBuffer::memoryBarrier(BarrierBits barriers) {
+    if (valid())
+        be->cmdMemoryBarrier(id, barriers);
+}
+
+PixelReadback CommandBuffer::readPixelsAsync(const Framebuffer& fb,
+                                             uint32_t           x,
+                                             uint32_t           y,
+                                             uint32_t           w,
+                                             uint32_t           h,
+                                             PixelFormat        format,
+                                             uint32_t           attachment) {
+    if (valid() && fb.valid())
+        return be->cmdReadPixelsAsync(id, fb.id, x, y, w, h, format, attachment);
+    return {};
+}
+
 }
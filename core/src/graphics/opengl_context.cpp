@@ -3,10 +3,12 @@
 #include "corvus/log.hpp"
 #include "spdlog/fmt/bundled/format.h"
 #include <algorithm>
+#include <array>
 #include <cstring>
 #include <iomanip>
 #include <iostream>
 #include <optional>
+#include <ranges>
 #include <string>
 
 namespace Corvus::Graphics {
@@ -35,9 +37,11 @@ static uint32_t compileGL(uint32_t type, const char* src) {
     return sh;
 }
 
-static uint32_t linkProgram(uint32_t vs, uint32_t fs) {
+static uint32_t linkProgram(uint32_t vs, uint32_t fs, uint32_t gs = 0) {
     GLuint p = glCreateProgram();
     glAttachShader(p, vs);
+    if (gs)
+        glAttachShader(p, gs);
     glAttachShader(p, fs);
     glLinkProgram(p);
     GLint ok = GL_FALSE;
@@ -50,9 +54,149 @@ static uint32_t linkProgram(uint32_t vs, uint32_t fs) {
     }
     glDeleteShader(vs);
     glDeleteShader(fs);
+    if (gs)
+        glDeleteShader(gs);
     return p;
 }
 
+static uint32_t linkComputeProgram(uint32_t cs) {
+    GLuint p = glCreateProgram();
+    glAttachShader(p, cs);
+    glLinkProgram(p);
+    GLint ok = GL_FALSE;
+    glGetProgramiv(p, GL_LINK_STATUS, &ok);
+    if (!ok) {
+        char    log[2048];
+        GLsizei n = 0;
+        glGetProgramInfoLog(p, 2048, &n, log);
+        CORVUS_CORE_ERROR("COMPUTE PROGRAM LINK FAILED:\n{}", log);
+    }
+    glDeleteShader(cs);
+    return p;
+}
+
+static GLenum toGLImageAccess(ImageAccess access) {
+    switch (access) {
+        case ImageAccess::ReadOnly:
+            return GL_READ_ONLY;
+        case ImageAccess::WriteOnly:
+            return GL_WRITE_ONLY;
+        case ImageAccess::ReadWrite:
+        default:
+            return GL_READ_WRITE;
+    }
+}
+
+static GLenum toGLImageFormat(ImageFormat format) {
+    switch (format) {
+        case ImageFormat::RGBA16F:
+            return GL_RGBA16F;
+        case ImageFormat::RGBA32F:
+            return GL_RGBA32F;
+        case ImageFormat::R32F:
+            return GL_R32F;
+        case ImageFormat::R32UI:
+            return GL_R32UI;
+        case ImageFormat::RGBA8:
+        default:
+            return GL_RGBA8;
+    }
+}
+
+// Client format and type matching an ImageFormat, for allocating texture storage
+static void toGLPixelTransfer(ImageFormat format, GLenum& pixelFormat, GLenum& type) {
+    switch (format) {
+        case ImageFormat::RGBA16F:
+        case ImageFormat::RGBA32F:
+            pixelFormat = GL_RGBA;
+            type        = GL_FLOAT;
+            break;
+        case ImageFormat::R32F:
+            pixelFormat = GL_RED;
+            type        = GL_FLOAT;
+            break;
+        case ImageFormat::R32UI:
+            pixelFormat = GL_RED_INTEGER;
+            type        = GL_UNSIGNED_INT;
+            break;
+        case ImageFormat::RGBA8:
+        default:
+            pixelFormat = GL_RGBA;
+            type        = GL_UNSIGNED_BYTE;
+            break;
+    }
+}
+
+static uint32_t pixelFormatSize(PixelFormat format) {
+    switch (format) {
+        case PixelFormat::RGBA32F:
+            return 16;
+        case PixelFormat::RGBA8:
+        case PixelFormat::R32UI:
+        case PixelFormat::Depth32F:
+        default:
+            return 4;
+    }
+}
+
+static GLbitfield toGLBarrierBits(BarrierBits barriers) {
+    const auto bits = static_cast<uint32_t>(barriers);
+    if (barriers == BarrierBits::All)
+        return GL_ALL_BARRIER_BITS;
+
+    GLbitfield mask = 0;
+    if (bits & static_cast<uint32_t>(BarrierBits::VertexAttribArray))
+        mask |= GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT;
+    if (bits & static_cast<uint32_t>(BarrierBits::ElementArray))
+        mask |= GL_ELEMENT_ARRAY_BARRIER_BIT;
+    if (bits & static_cast<uint32_t>(BarrierBits::Uniform))
+        mask |= GL_UNIFORM_BARRIER_BIT;
+    if (bits & static_cast<uint32_t>(BarrierBits::TextureFetch))
+        mask |= GL_TEXTURE_FETCH_BARRIER_BIT;
+    if (bits & static_cast<uint32_t>(BarrierBits::ShaderImageAccess))
+        mask |= GL_SHADER_IMAGE_ACCESS_BARRIER_BIT;
+    if (bits & static_cast<uint32_t>(BarrierBits::Command))
+        mask |= GL_COMMAND_BARRIER_BIT;
+    if (bits & static_cast<uint32_t>(BarrierBits::BufferUpdate))
+        mask |= GL_BUFFER_UPDATE_BARRIER_BIT;
+    if (bits & static_cast<uint32_t>(BarrierBits::Framebuffer))
+        mask |= GL_FRAMEBUFFER_BARRIER_BIT;
+    if (bits & static_cast<uint32_t>(BarrierBits::ShaderStorage))
+        mask |= GL_SHADER_STORAGE_BARRIER_BIT;
+    return mask;
+}
+
+static bool hasDebugMarkers() { return GLAD_GL_KHR_debug || GLAD_GL_VERSION_4_3; }
+
+#ifdef CORVUS_DEBUG
+static void APIENTRY glDebugCallback(GLenum        source,
+                                     GLenum        type,
+                                     GLuint        id,
+                                     GLenum        severity,
+                                     GLsizei       length,
+                                     const GLchar* message,
+                                     const void*   userParam) {
+    // Our own debug groups echo back through the callback, ignore them
+    if (type == GL_DEBUG_TYPE_PUSH_GROUP || type == GL_DEBUG_TYPE_POP_GROUP)
+        return;
+
+    switch (severity) {
+        case GL_DEBUG_SEVERITY_HIGH:
+            CORVUS_CORE_ERROR("GL [0x{:x}]: {}", id, message);
+            break;
+        case GL_DEBUG_SEVERITY_MEDIUM:
+            CORVUS_CORE_WARN("GL [0x{:x}]: {}", id, message);
+            break;
+        case GL_DEBUG_SEVERITY_LOW:
+            CORVUS_CORE_INFO("GL [0x{:x}]: {}", id, message);
+            break;
+        default:
+            CORVUS_CORE_TRACE("GL [0x{:x}] (source 0x{:x}): {}", id, source, message);
+            break;
+    }
+}
+#endif
+
 // VBO, Creation and destruction only (updates via command buffer)
 VertexBuffer OpenGLBackend::vbCreate(const void* data, uint32_t size) {
     GLuint id = 0;
@@ -166,19 +310,124 @@ Shader OpenGLBackend::shaderCreate(const std::string& vs, const std::string& fs)
     return h;
 }
 
+Shader OpenGLBackend::shaderCreateGeometry(const std::string& vs,
+                                           const std::string& gs,
+                                           const std::string& fs) {
+    uint32_t v = compileGL(GL_VERTEX_SHADER, vs.c_str());
+    uint32_t g = compileGL(GL_GEOMETRY_SHADER, gs.c_str());
+    uint32_t f = compileGL(GL_FRAGMENT_SHADER, fs.c_str());
+    Shader   h;
+    h.id = linkProgram(v, f, g);
+    h.be = this;
+    return h;
+}
+
+Shader OpenGLBackend::shaderCreateCompute(const std::string& cs) {
+    Shader h;
+    if (!GLAD_GL_VERSION_4_3) {
+        CORVUS_CORE_ERROR("Compute shaders require OpenGL 4.3");
+        return h;
+    }
+
+    uint32_t c = compileGL(GL_COMPUTE_SHADER, cs.c_str());
+    h.id       = linkComputeProgram(c);
+    h.be       = this;
+    return h;
+}
+
 void OpenGLBackend::shaderDestroy(uint32_t id) {
     if (id)
         glDeleteProgram(id);
 }
 
+// Buffer texture, creation and destruction only (updates via command buffer)
+TextureBuffer OpenGLBackend::texBufferCreate(ImageFormat format, const void* data, uint32_t size) {
+    GLuint buffer = 0;
+    glGenBuffers(1, &buffer);
+    glBindBuffer(GL_TEXTURE_BUFFER, buffer);
+    glBufferData(GL_TEXTURE_BUFFER, size, data, GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_TEXTURE_BUFFER, 0);
+
+    GLuint id = 0;
+    glGenTextures(1, &id);
+    glBindTexture(GL_TEXTURE_BUFFER, id);
+    glTexBuffer(GL_TEXTURE_BUFFER, toGLImageFormat(format), buffer);
+    glBindTexture(GL_TEXTURE_BUFFER, 0);
+
+    textureBufferStorage_[id] = buffer;
+
+    TextureBuffer h;
+    h.id        = id;
+    h.be        = this;
+    h.sizeBytes = size;
+    h.format    = format;
+    return h;
+}
+
+void OpenGLBackend::texBufferDestroy(uint32_t id) {
+    if (!id)
+        return;
+
+    if (auto it = textureBufferStorage_.find(id); it != textureBufferStorage_.end()) {
+        glDeleteBuffers(1, &it->second);
+        textureBufferStorage_.erase(it);
+    }
+    glDeleteTextures(1, &id);
+}
+
+// Storage buffer, creation, readback and destruction (updates via command buffer)
+StorageBuffer OpenGLBackend::sbCreate(const void* data, uint32_t size) {
+    StorageBuffer h;
+    if (!GLAD_GL_VERSION_4_3) {
+        CORVUS_CORE_ERROR("Storage buffers require OpenGL 4.3");
+        return h;
+    }
+
+    GLuint id = 0;
+    glGenBuffers(1, &id);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, id);
+    glBufferData(GL_SHADER_STORAGE_BUFFER, size, data, GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+    h.id        = id;
+    h.be        = this;
+    h.sizeBytes = size;
+    return h;
+}
+
+void OpenGLBackend::sbGetData(uint32_t id, void* out, uint32_t size, uint32_t offset) {
+    if (!id || !out)
+        return;
+
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, id);
+    glGetBufferSubData(GL_SHADER_STORAGE_BUFFER, offset, size, out);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+}
+
+void OpenGLBackend::sbDestroy(uint32_t id) {
+    if (id)
+        glDeleteBuffers(1, &id);
+}
+
 // Texture2D
-Texture2D OpenGLBackend::tex2DCreate(uint32_t w, uint32_t h) {
+Texture2D OpenGLBackend::tex2DCreate(uint32_t w, uint32_t h, ImageFormat format) {
+    GLenum pixelFormat = GL_RGBA;
+    GLenum type        = GL_UNSIGNED_BYTE;
+    toGLPixelTransfer(format, pixelFormat, type);
+
+    // Float and integer targets hold data rather than colors, never filter them
+    const GLint filter = format == ImageFormat::RGBA8 ? GL_LINEAR : GL_NEAREST;
+
     GLuint id = 0;
     glGenTextures(1, &id);
     glBindTexture(GL_TEXTURE_2D, id);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, w, h, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexImage2D(
+        GL_TEXTURE_2D, 0, toGLImageFormat(format), w, h, 0, pixelFormat, type, nullptr);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, filter);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, filter);
+    if (format != ImageFormat::RGBA8) {
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    }
     Texture2D t;
     t.id     = id;
     t.be     = this;
@@ -279,6 +528,43 @@ void OpenGLBackend::texCubeDestroy(uint32_t id) {
     glDeleteTextures(1, &tex);
 }
 
+// Texture2DArray
+Texture2DArray OpenGLBackend::tex2DArrayCreateDepth(uint32_t w, uint32_t h, uint32_t layers) {
+    GLuint id = 0;
+    glGenTextures(1, &id);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, id);
+    glTexImage3D(GL_TEXTURE_2D_ARRAY,
+                 0,
+                 GL_DEPTH_COMPONENT32F,
+                 w,
+                 h,
+                 layers,
+                 0,
+                 GL_DEPTH_COMPONENT,
+                 GL_FLOAT,
+                 nullptr);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_BORDER);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_BORDER);
+    GLfloat borderColor[] = { 1.0f, 1.0f, 1.0f, 1.0f };
+    glTexParameterfv(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_BORDER_COLOR, borderColor);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+
+    Texture2DArray t;
+    t.id     = id;
+    t.be     = this;
+    t.width  = w;
+    t.height = h;
+    t.layers = layers;
+    return t;
+}
+
+void OpenGLBackend::tex2DArrayDestroy(uint32_t id) {
+    if (id)
+        glDeleteTextures(1, &id);
+}
+
 // Command Buffer, Records and executes commands in order
 CommandBuffer OpenGLBackend::cmdCreate() {
     uint32_t id         = nextCmdBufferId_++;
@@ -329,6 +615,61 @@ void OpenGLBackend::cmdSetLineWidth(uint32_t cmdId, float width) {
     it->second.commands.push_back(cmd);
 }
 
+void OpenGLBackend::cmdSetClipDistances(uint32_t cmdId, uint32_t count) {
+    auto it = commandBuffers_.find(cmdId);
+    if (it == commandBuffers_.end() || !it->second.recording)
+        return;
+
+    Command cmd;
+    cmd.type = Command::Type::SetClipDistances;
+    cmd.data = Command::ClipDistanceData { count };
+    it->second.commands.push_back(cmd);
+}
+
+void OpenGLBackend::cmdSetDepthFunc(uint32_t cmdId, DepthFunc func) {
+    auto it = commandBuffers_.find(cmdId);
+    if (it == commandBuffers_.end() || !it->second.recording)
+        return;
+
+    Command cmd;
+    cmd.type = Command::Type::SetDepthFunc;
+    cmd.data = Command::DepthFuncData { func };
+    it->second.commands.push_back(cmd);
+}
+
+void OpenGLBackend::cmdSetColorMask(uint32_t cmdId, bool enable) {
+    auto it = commandBuffers_.find(cmdId);
+    if (it == commandBuffers_.end() || !it->second.recording)
+        return;
+
+    Command cmd;
+    cmd.type = Command::Type::SetColorMask;
+    cmd.data = Command::StateData { enable };
+    it->second.commands.push_back(cmd);
+}
+
+void OpenGLBackend::cmdSetBlendFunc(uint32_t cmdId, BlendFunc func) {
+    auto it = commandBuffers_.find(cmdId);
+    if (it == commandBuffers_.end() || !it->second.recording)
+        return;
+
+    Command cmd;
+    cmd.type = Command::Type::SetBlendFunc;
+    cmd.data = Command::BlendFuncData { func };
+    it->second.commands.push_back(cmd);
+}
+
+void OpenGLBackend::cmdBlitFramebuffer(uint32_t cmdId, const Command::BlitFramebufferData& blit) {
+    auto it = commandBuffers_.find(cmdId);
+    if (it == commandBuffers_.end() || !it->second.recording)
+        return;
+
+    Command cmd;
+    cmd.type = Command::Type::BlitFramebuffer;
+    cmd.data = blit;
+    it->second.commands.push_back(cmd);
+}
+
 void OpenGLBackend::cmdSetShader(uint32_t id, uint32_t shaderId) {
     auto it = commandBuffers_.find(id);
     if (it == commandBuffers_.end() || !it->second.recording)
@@ -379,6 +720,34 @@ void OpenGLBackend::cmdBindTextureCube(uint32_t                   id,
     it->second.commands.push_back(cmd);
 }
 
+void OpenGLBackend::cmdBindTextureBuffer(uint32_t                   id,
+                                         uint32_t                   slot,
+                                         uint32_t                   texID,
+                                         std::optional<std::string> uniformName) {
+    auto it = commandBuffers_.find(id);
+    if (it == commandBuffers_.end() || !it->second.recording)
+        return;
+
+    Command cmd;
+    cmd.type = Command::Type::BindTextureBuffer;
+    cmd.data = Command::TextureData { slot, texID, uniformName };
+    it->second.commands.push_back(cmd);
+}
+
+void OpenGLBackend::cmdBindTextureArray(uint32_t                   id,
+                                        uint32_t                   slot,
+                                        uint32_t                   texID,
+                                        std::optional<std::string> uniformName) {
+    auto it = commandBuffers_.find(id);
+    if (it == commandBuffers_.end() || !it->second.recording)
+        return;
+
+    Command cmd;
+    cmd.type = Command::Type::BindTextureArray;
+    cmd.data = Command::TextureData { slot, texID, uniformName };
+    it->second.commands.push_back(cmd);
+}
+
 void OpenGLBackend::cmdDrawIndexed(
     uint32_t id, uint32_t elemCount, bool index16, uint32_t indexOffset, PrimitiveType primitive) {
     auto it = commandBuffers_.find(id);
@@ -391,6 +760,23 @@ void OpenGLBackend::cmdDrawIndexed(
     it->second.commands.push_back(cmd);
 }
 
+void OpenGLBackend::cmdDrawIndexedInstanced(uint32_t      id,
+                                            uint32_t      elemCount,
+                                            bool          index16,
+                                            uint32_t      instanceCount,
+                                            uint32_t      indexOffset,
+                                            PrimitiveType primitive) {
+    auto it = commandBuffers_.find(id);
+    if (it == commandBuffers_.end() || !it->second.recording)
+        return;
+
+    Command cmd;
+    cmd.type = Command::Type::DrawIndexed;
+    cmd.data
+        = Command::DrawIndexedData { elemCount, index16, indexOffset, primitive, instanceCount };
+    it->second.commands.push_back(cmd);
+}
+
 void OpenGLBackend::cmdBindFramebuffer(uint32_t cmdID,
                                        uint32_t fbID,
                                        uint32_t width,
@@ -539,6 +925,26 @@ void OpenGLBackend::cmdUpdateIndexBuffer(
     it->second.commands.push_back(std::move(cmd));
 }
 
+void OpenGLBackend::cmdUpdateTextureBuffer(uint32_t    cmdID,
+                                           uint32_t    texID,
+                                           const void* data,
+                                           uint32_t    size) {
+    auto it = commandBuffers_.find(cmdID);
+    if (it == commandBuffers_.end() || !it->second.recording)
+        return;
+
+    Command cmd;
+    cmd.type = Command::Type::UpdateTextureBuffer;
+
+    Command::UpdateTextureBufferData bufData;
+    bufData.texId = texID;
+    bufData.data.resize(size);
+    std::memcpy(bufData.data.data(), data, size);
+
+    cmd.data = std::move(bufData);
+    it->second.commands.push_back(std::move(cmd));
+}
+
 // Shader uniforms (deferred)
 void OpenGLBackend::cmdSetShaderUniformMat4(uint32_t     cmdID,
                                             uint32_t     shaderID,
@@ -648,6 +1054,224 @@ void OpenGLBackend::cmdSetShaderUniformVec2(uint32_t     cmdID,
     it->second.commands.push_back(std::move(cmd));
 }
 
+// Compute (deferred)
+void OpenGLBackend::cmdUpdateStorageBuffer(
+    uint32_t cmdID, uint32_t sbID, const void* data, uint32_t size, uint32_t offset) {
+    auto it = commandBuffers_.find(cmdID);
+    if (it == commandBuffers_.end() || !it->second.recording)
+        return;
+
+    Command cmd;
+    cmd.type = Command::Type::UpdateStorageBuffer;
+
+    Command::UpdateStorageBufferData bufData;
+    bufData.sbId   = sbID;
+    bufData.offset = offset;
+    bufData.data.resize(size);
+    std::memcpy(bufData.data.data(), data, size);
+
+    cmd.data = std::move(bufData);
+    it->second.commands.push_back(std::move(cmd));
+}
+
+void OpenGLBackend::cmdBindStorageBuffer(uint32_t cmdID, uint32_t slot, uint32_t sbID) {
+    auto it = commandBuffers_.find(cmdID);
+    if (it == commandBuffers_.end() || !it->second.recording)
+        return;
+
+    Command cmd;
+    cmd.type = Command::Type::BindStorageBuffer;
+    cmd.data = Command::BindStorageBufferData { slot, sbID };
+    it->second.commands.push_back(cmd);
+}
+
+void OpenGLBackend::cmdBindImageTexture(uint32_t    cmdID,
+                                        uint32_t    unit,
+                                        uint32_t    texID,
+                                        ImageAccess access,
+                                        ImageFormat format,
+                                        uint32_t    level) {
+    auto it = commandBuffers_.find(cmdID);
+    if (it == commandBuffers_.end() || !it->second.recording)
+        return;
+
+    Command cmd;
+    cmd.type = Command::Type::BindImageTexture;
+    cmd.data = Command::BindImageTextureData { unit, texID, level, access, format };
+    it->second.commands.push_back(cmd);
+}
+
+void OpenGLBackend::cmdDispatch(uint32_t cmdID, uint32_t x, uint32_t y, uint32_t z) {
+    auto it = commandBuffers_.find(cmdID);
+    if (it == commandBuffers_.end() || !it->second.recording)
+        return;
+
+    Command cmd;
+    cmd.type = Command::Type::Dispatch;
+    cmd.data = Command::DispatchData { x, y, z };
+    it->second.commands.push_back(cmd);
+}
+
+void OpenGLBackend::cmdMemoryBarrier(uint32_t cmdID, BarrierBits barriers) {
+    auto it = commandBuffers_.find(cmdID);
+    if (it == commandBuffers_.end() || !it->second.recording)
+        return;
+
+    Command cmd;
+    cmd.type = Command::Type::MemoryBarrier;
+    cmd.data = Command::MemoryBarrierData { barriers };
+    it->second.commands.push_back(cmd);
+}
+
+// Asynchronous readback
+PixelReadback OpenGLBackend::cmdReadPixelsAsync(uint32_t    cmdID,
+                                                uint32_t    fbID,
+                                                uint32_t    x,
+                                                uint32_t    y,
+                                                uint32_t    w,
+                                                uint32_t    h,
+                                                PixelFormat format,
+                                                uint32_t    attachment) {
+    PixelReadback rb;
+    auto          it = commandBuffers_.find(cmdID);
+    if (it == commandBuffers_.end() || !it->second.recording || w == 0 || h == 0)
+        return rb;
+
+    ReadbackData data;
+    data.sizeBytes = w * h * pixelFormatSize(format);
+    glGenBuffers(1, &data.pbo);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, data.pbo);
+    glBufferData(GL_PIXEL_PACK_BUFFER, data.sizeBytes, nullptr, GL_STREAM_READ);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    const uint32_t id = nextReadbackId_++;
+    readbacks_[id]    = std::move(data);
+
+    Command cmd;
+    cmd.type = Command::Type::ReadPixels;
+    cmd.data = Command::ReadPixelsData { id, fbID, x, y, w, h, format, attachment };
+    it->second.commands.push_back(cmd);
+
+    rb.id     = id;
+    rb.be     = this;
+    rb.width  = w;
+    rb.height = h;
+    rb.format = format;
+    return rb;
+}
+
+bool OpenGLBackend::readbackReady(uint32_t id) const {
+    auto it = readbacks_.find(id);
+    return it != readbacks_.end() && it->second.ready;
+}
+
+bool OpenGLBackend::readbackGetData(uint32_t id, std::vector<uint8_t>& out) const {
+    auto it = readbacks_.find(id);
+    if (it == readbacks_.end() || !it->second.ready)
+        return false;
+
+    out = it->second.pixels;
+    return true;
+}
+
+void OpenGLBackend::readbackDestroy(uint32_t id) {
+    auto it = readbacks_.find(id);
+    if (it == readbacks_.end())
+        return;
+
+    if (it->second.fence)
+        glDeleteSync(it->second.fence);
+    if (it->second.pbo)
+        glDeleteBuffers(1, &it->second.pbo);
+    readbacks_.erase(it);
+}
+
+void OpenGLBackend::pollReadbacks() {
+    for (auto& rb : readbacks_ | std::views::values) {
+        if (rb.ready || !rb.fence)
+            continue;
+
+        const GLenum status = glClientWaitSync(rb.fence, 0, 0);
+        if (status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED)
+            continue;
+
+        glDeleteSync(rb.fence);
+        rb.fence = nullptr;
+
+        rb.pixels.resize(rb.sizeBytes);
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, rb.pbo);
+        if (const void* mapped
+            = glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, rb.sizeBytes, GL_MAP_READ_BIT)) {
+            std::memcpy(rb.pixels.data(), mapped, rb.sizeBytes);
+            glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+        } else {
+            CORVUS_CORE_WARN("Failed to map pixel pack buffer for readback");
+        }
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+        // Pixels are on the CPU now, the staging buffer is no longer needed
+        glDeleteBuffers(1, &rb.pbo);
+        rb.pbo   = 0;
+        rb.ready = true;
+    }
+}
+
+// Debug markers
+void OpenGLBackend::cmdPushDebugGroup(uint32_t cmdID, const char* name) {
+    auto it = commandBuffers_.find(cmdID);
+    if (it == commandBuffers_.end() || !it->second.recording)
+        return;
+
+    Command cmd;
+    cmd.type = Command::Type::PushDebugGroup;
+    cmd.data = Command::DebugGroupData { name ? name : "" };
+    it->second.commands.push_back(std::move(cmd));
+}
+
+void OpenGLBackend::cmdPopDebugGroup(uint32_t cmdID) {
+    auto it = commandBuffers_.find(cmdID);
+    if (it == commandBuffers_.end() || !it->second.recording)
+        return;
+
+    Command cmd;
+    cmd.type = Command::Type::PopDebugGroup;
+    cmd.data = std::monostate {};
+    it->second.commands.push_back(cmd);
+}
+
+void OpenGLBackend::setObjectLabel(ResourceType type, uint32_t id, const char* label) {
+    if (!id || !label || !hasDebugMarkers())
+        return;
+
+    GLenum identifier;
+    switch (type) {
+        case ResourceType::VBO:
+        case ResourceType::IBO:
+        case ResourceType::SSBO:
+            identifier = GL_BUFFER;
+            break;
+        case ResourceType::VAO:
+            identifier = GL_VERTEX_ARRAY;
+            break;
+        case ResourceType::Shader:
+            identifier = GL_PROGRAM;
+            break;
+        case ResourceType::Tex2D:
+        case ResourceType::TexCube:
+        case ResourceType::TexBuffer:
+        case ResourceType::Tex2DArray:
+            identifier = GL_TEXTURE;
+            break;
+        case ResourceType::FBO:
+            identifier = GL_FRAMEBUFFER;
+            break;
+        default:
+            return;
+    }
+
+    glObjectLabel(identifier, id, -1, label);
+}
+
 // Execute all recorded commands
 void OpenGLBackend::executeCommand(const Command& cmd) {
     switch (cmd.type) {
@@ -663,6 +1287,80 @@ void OpenGLBackend::executeCommand(const Command& cmd) {
             break;
         }
 
+        case Command::Type::SetClipDistances: {
+            // GL guarantees at least 8 user clip distances
+            auto& d = std::get<Command::ClipDistanceData>(cmd.data);
+            for (uint32_t i = 0; i < 8; ++i) {
+                if (i < d.count)
+                    glEnable(GL_CLIP_DISTANCE0 + i);
+                else
+                    glDisable(GL_CLIP_DISTANCE0 + i);
+            }
+            break;
+        }
+        case Command::Type::SetDepthFunc: {
+            switch (std::get<Command::DepthFuncData>(cmd.data).func) {
+                case DepthFunc::Less:
+                    glDepthFunc(GL_LESS);
+                    break;
+                case DepthFunc::LessEqual:
+                    glDepthFunc(GL_LEQUAL);
+                    break;
+                case DepthFunc::Equal:
+                    glDepthFunc(GL_EQUAL);
+                    break;
+                case DepthFunc::Always:
+                    glDepthFunc(GL_ALWAYS);
+                    break;
+            }
+            break;
+        }
+        case Command::Type::SetColorMask: {
+            auto&           state = std::get<Command::StateData>(cmd.data);
+            const GLboolean mask  = state.enable ? GL_TRUE : GL_FALSE;
+            glColorMask(mask, mask, mask, mask);
+            break;
+        }
+
+        case Command::Type::SetBlendFunc: {
+            switch (std::get<Command::BlendFuncData>(cmd.data).func) {
+                case BlendFunc::Alpha:
+                    glBlendFuncSeparate(
+                        GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA, GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+                    break;
+                case BlendFunc::WeightedAccumulate:
+                    glBlendFuncSeparate(GL_ONE, GL_ONE, GL_ZERO, GL_ONE_MINUS_SRC_ALPHA);
+                    break;
+            }
+            break;
+        }
+
+        case Command::Type::BlitFramebuffer: {
+            auto&      blit = std::get<Command::BlitFramebufferData>(cmd.data);
+            GLbitfield mask = 0;
+            if (blit.color)
+                mask |= GL_COLOR_BUFFER_BIT;
+            if (blit.depth)
+                mask |= GL_DEPTH_BUFFER_BIT;
+
+            // Depth can only be copied with nearest filtering
+            glBindFramebuffer(GL_READ_FRAMEBUFFER, blit.srcFb);
+            glBindFramebuffer(GL_DRAW_FRAMEBUFFER, blit.dstFb);
+            glBlitFramebuffer(0,
+                              0,
+                              static_cast<GLint>(blit.srcWidth),
+                              static_cast<GLint>(blit.srcHeight),
+                              0,
+                              0,
+                              static_cast<GLint>(blit.dstWidth),
+                              static_cast<GLint>(blit.dstHeight),
+                              mask,
+                              GL_NEAREST);
+            glBindFramebuffer(GL_FRAMEBUFFER, blit.dstFb);
+            applyDrawBuffers(blit.dstFb);
+            break;
+        }
+
         case Command::Type::SetShader: {
             auto& shader = std::get<Command::ShaderData>(cmd.data);
             glUseProgram(shader.shaderId);
@@ -725,6 +1423,40 @@ void OpenGLBackend::executeCommand(const Command& cmd) {
             break;
         }
 
+        case Command::Type::BindTextureBuffer: {
+            auto& tex = std::get<Command::TextureData>(cmd.data);
+            glActiveTexture(GL_TEXTURE0 + tex.slot);
+            glBindTexture(GL_TEXTURE_BUFFER, tex.texId);
+
+            if (tex.uniformName && !tex.uniformName->empty()) {
+                GLint currentProgram = 0;
+                glGetIntegerv(GL_CURRENT_PROGRAM, &currentProgram);
+                if (currentProgram != 0) {
+                    GLint loc = glGetUniformLocation(currentProgram, tex.uniformName->c_str());
+                    if (loc >= 0)
+                        glUniform1i(loc, tex.slot);
+                }
+            }
+            break;
+        }
+
+        case Command::Type::BindTextureArray: {
+            auto& tex = std::get<Command::TextureData>(cmd.data);
+            glActiveTexture(GL_TEXTURE0 + tex.slot);
+            glBindTexture(GL_TEXTURE_2D_ARRAY, tex.texId);
+
+            if (tex.uniformName && !tex.uniformName->empty()) {
+                GLint currentProgram = 0;
+                glGetIntegerv(GL_CURRENT_PROGRAM, &currentProgram);
+                if (currentProgram != 0) {
+                    GLint loc = glGetUniformLocation(currentProgram, tex.uniformName->c_str());
+                    if (loc >= 0)
+                        glUniform1i(loc, tex.slot);
+                }
+            }
+            break;
+        }
+
         case Command::Type::DrawIndexed: {
             auto&  draw = std::get<Command::DrawIndexedData>(cmd.data);
             GLenum glPrimitive;
@@ -748,10 +1480,12 @@ void OpenGLBackend::executeCommand(const Command& cmd) {
 
             const void* offset
                 = (void*)(draw.offset * (draw.index16 ? sizeof(GLushort) : sizeof(GLuint)));
-            glDrawElements(glPrimitive,
-                           draw.elemCount,
-                           draw.index16 ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT,
-                           offset);
+            const GLenum indexType = draw.index16 ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+            if (draw.instanceCount > 1)
+                glDrawElementsInstanced(
+                    glPrimitive, draw.elemCount, indexType, offset, draw.instanceCount);
+            else
+                glDrawElements(glPrimitive, draw.elemCount, indexType, offset);
 
             GLenum err = glGetError();
             if (err != GL_NO_ERROR) {
@@ -764,9 +1498,7 @@ void OpenGLBackend::executeCommand(const Command& cmd) {
         case Command::Type::BindFramebuffer: {
             auto& fb = std::get<Command::FramebufferData>(cmd.data);
             glBindFramebuffer(GL_FRAMEBUFFER, fb.fbId);
-
-            GLenum drawBuffer = GL_COLOR_ATTACHMENT0;
-            glDrawBuffers(1, &drawBuffer);
+            applyDrawBuffers(fb.fbId);
             break;
         }
 
@@ -792,8 +1524,6 @@ void OpenGLBackend::executeCommand(const Command& cmd) {
             if (state.enable) {
                 glEnable(GL_BLEND);
                 glBlendEquation(GL_FUNC_ADD);
-                glBlendFuncSeparate(
-                    GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA, GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
             } else {
                 glDisable(GL_BLEND);
             }
@@ -918,6 +1648,136 @@ void OpenGLBackend::executeCommand(const Command& cmd) {
             glDepthMask(state.enable ? GL_TRUE : GL_FALSE);
             break;
         }
+        case Command::Type::UpdateStorageBuffer: {
+            auto& buf = std::get<Command::UpdateStorageBufferData>(cmd.data);
+            glBindBuffer(GL_SHADER_STORAGE_BUFFER, buf.sbId);
+
+            GLint64 allocated = 0;
+            glGetBufferParameteri64v(GL_SHADER_STORAGE_BUFFER, GL_BUFFER_SIZE, &allocated);
+            const GLint64 end = GLint64(buf.offset) + GLint64(buf.data.size());
+            if (end > allocated) {
+                // glBufferData drops the old store, the bytes before the write go through a
+                // scratch buffer. Anything from the offset on is overwritten anyway.
+                const GLint64 kept    = std::min(allocated, GLint64(buf.offset));
+                GLuint        scratch = 0;
+                if (kept > 0) {
+                    glGenBuffers(1, &scratch);
+                    glBindBuffer(GL_COPY_WRITE_BUFFER, scratch);
+                    glBufferData(GL_COPY_WRITE_BUFFER, kept, nullptr, GL_STREAM_COPY);
+                    glCopyBufferSubData(GL_SHADER_STORAGE_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, kept);
+                }
+
+                glBufferData(GL_SHADER_STORAGE_BUFFER, end, nullptr, GL_DYNAMIC_DRAW);
+
+                if (scratch) {
+                    glCopyBufferSubData(GL_COPY_WRITE_BUFFER, GL_SHADER_STORAGE_BUFFER, 0, 0, kept);
+                    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+                    glDeleteBuffers(1, &scratch);
+                }
+            }
+
+            glBufferSubData(GL_SHADER_STORAGE_BUFFER, buf.offset, buf.data.size(), buf.data.data());
+            glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+            break;
+        }
+        case Command::Type::BindStorageBuffer: {
+            auto& bind = std::get<Command::BindStorageBufferData>(cmd.data);
+            glBindBufferBase(GL_SHADER_STORAGE_BUFFER, bind.slot, bind.sbId);
+            break;
+        }
+        case Command::Type::BindImageTexture: {
+            auto& img = std::get<Command::BindImageTextureData>(cmd.data);
+            glBindImageTexture(img.unit,
+                               img.texId,
+                               img.level,
+                               GL_FALSE,
+                               0,
+                               toGLImageAccess(img.access),
+                               toGLImageFormat(img.format));
+            break;
+        }
+        case Command::Type::Dispatch: {
+            auto& dispatch = std::get<Command::DispatchData>(cmd.data);
+            glDispatchCompute(dispatch.x, dispatch.y, dispatch.z);
+
+            GLenum err = glGetError();
+            if (err != GL_NO_ERROR) {
+                CORVUS_CORE_ERROR("OpenGL error after Dispatch: 0x{:x}", err);
+            }
+            break;
+        }
+        case Command::Type::MemoryBarrier: {
+            auto& barrier = std::get<Command::MemoryBarrierData>(cmd.data);
+            glMemoryBarrier(toGLBarrierBits(barrier.barriers));
+            break;
+        }
+        case Command::Type::ReadPixels: {
+            auto& read = std::get<Command::ReadPixelsData>(cmd.data);
+            auto  it   = readbacks_.find(read.readbackId);
+            if (it == readbacks_.end() || !it->second.pbo)
+                break;
+
+            GLenum glFormat = GL_RGBA, glType = GL_UNSIGNED_BYTE;
+            switch (read.format) {
+                case PixelFormat::RGBA32F:
+                    glType = GL_FLOAT;
+                    break;
+                case PixelFormat::R32UI:
+                    glFormat = GL_RED_INTEGER;
+                    glType   = GL_UNSIGNED_INT;
+                    break;
+                case PixelFormat::Depth32F:
+                    glFormat = GL_DEPTH_COMPONENT;
+                    glType   = GL_FLOAT;
+                    break;
+                case PixelFormat::RGBA8:
+                default:
+                    break;
+            }
+
+            GLint prevReadFb = 0;
+            glGetIntegerv(GL_READ_FRAMEBUFFER_BINDING, &prevReadFb);
+            glBindFramebuffer(GL_READ_FRAMEBUFFER, read.fbId);
+            if (read.format != PixelFormat::Depth32F)
+                glReadBuffer(GL_COLOR_ATTACHMENT0 + read.attachment);
+
+            glPixelStorei(GL_PACK_ALIGNMENT, 1);
+            glBindBuffer(GL_PIXEL_PACK_BUFFER, it->second.pbo);
+            glReadPixels(read.x, read.y, read.w, read.h, glFormat, glType, nullptr);
+            glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+            glBindFramebuffer(GL_READ_FRAMEBUFFER, prevReadFb);
+
+            it->second.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+
+            GLenum err = glGetError();
+            if (err != GL_NO_ERROR) {
+                CORVUS_CORE_ERROR("OpenGL error after ReadPixels: 0x{:x}", err);
+            }
+            break;
+        }
+        case Command::Type::PushDebugGroup: {
+            auto& group = std::get<Command::DebugGroupData>(cmd.data);
+            if (hasDebugMarkers())
+                glPushDebugGroup(GL_DEBUG_SOURCE_APPLICATION, 0, -1, group.name.c_str());
+            break;
+        }
+        case Command::Type::PopDebugGroup: {
+            if (hasDebugMarkers())
+                glPopDebugGroup();
+            break;
+        }
+        case Command::Type::UpdateTextureBuffer: {
+            auto& buf = std::get<Command::UpdateTextureBufferData>(cmd.data);
+            auto  it  = textureBufferStorage_.find(buf.texId);
+            if (it == textureBufferStorage_.end())
+                break;
+
+            // Orphan the old storage, the texture view follows the buffer object
+            glBindBuffer(GL_TEXTURE_BUFFER, it->second);
+            glBufferData(GL_TEXTURE_BUFFER, buf.data.size(), buf.data.data(), GL_DYNAMIC_DRAW);
+            glBindBuffer(GL_TEXTURE_BUFFER, 0);
+            break;
+        }
     }
 }
 
@@ -966,8 +1826,29 @@ void OpenGLBackend::fbAttachTexture2D(uint32_t fbID, uint32_t texID, uint32_t at
     glFramebufferTexture2D(
         GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0 + attachment, GL_TEXTURE_2D, texID, 0);
 
-    const GLenum buf = GL_COLOR_ATTACHMENT0 + attachment;
-    glDrawBuffers(1, &buf);
+    if (texID)
+        fbColorAttachments_[fbID] |= 1u << attachment;
+    else
+        fbColorAttachments_[fbID] &= ~(1u << attachment);
+    applyDrawBuffers(fbID);
+}
+
+void OpenGLBackend::applyDrawBuffers(uint32_t fbID) const {
+    // Framebuffers without tracked color attachments keep drawing to attachment 0
+    auto it = fbColorAttachments_.find(fbID);
+    if (it == fbColorAttachments_.end() || it->second == 0) {
+        const GLenum buf = GL_COLOR_ATTACHMENT0;
+        glDrawBuffers(1, &buf);
+        return;
+    }
+
+    // Fragment output location N writes attachment N, unattached slots in between get GL_NONE.
+    // GL guarantees at least 8 draw buffers
+    std::array<GLenum, 8> buffers {};
+    GLsizei               count = 0;
+    for (uint32_t i = 0; i < buffers.size() && (it->second >> i) != 0; ++i)
+        buffers[count++] = (it->second & (1u << i)) ? GL_COLOR_ATTACHMENT0 + i : GL_NONE;
+    glDrawBuffers(count, buffers.data());
 }
 
 void OpenGLBackend::fbAttachDepthTexture(uint32_t fbID, uint32_t texID) {
@@ -980,9 +1861,8 @@ void OpenGLBackend::fbAttachDepthTexture(uint32_t fbID, uint32_t texID) {
     glBindFramebuffer(GL_FRAMEBUFFER, fbID);
     glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, texID, 0);
 
-    // Ensure we're drawing to color 0 if there's exactly one color attachment
-    static const GLenum buf = GL_COLOR_ATTACHMENT0;
-    glDrawBuffers(1, &buf);
+    // Keep drawing to every attached color target
+    applyDrawBuffers(fbID);
 
     GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
     if (status != GL_FRAMEBUFFER_COMPLETE) {
@@ -999,9 +1879,57 @@ void OpenGLBackend::fbAttachTextureCubeFace(uint32_t fbID, uint32_t texID, int f
         GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_CUBE_MAP_POSITIVE_X + faceIndex, texID, 0);
 }
 
+void OpenGLBackend::fbAttachDepthTextureLayer(uint32_t fbID, uint32_t texID, uint32_t layer) {
+    if (!fbID || !texID)
+        return;
+
+    GLint prevFb = 0;
+    glGetIntegerv(GL_FRAMEBUFFER_BINDING, &prevFb);
+
+    glBindFramebuffer(GL_FRAMEBUFFER, fbID);
+    glFramebufferTextureLayer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, texID, 0, layer);
+
+    // Depth only, nothing to draw into
+    glDrawBuffer(GL_NONE);
+    glReadBuffer(GL_NONE);
+
+    GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+    if (status != GL_FRAMEBUFFER_COMPLETE) {
+        std::cerr << "[OpenGLBackend] FBO incomplete after depth layer attach: 0x" << std::hex
+                  << status << std::dec << "\n";
+    }
+
+    glBindFramebuffer(GL_FRAMEBUFFER, prevFb);
+}
+
+void OpenGLBackend::fbAttachDepthTextureCube(uint32_t fbID, uint32_t texID) {
+    if (!fbID || !texID)
+        return;
+
+    GLint prevFb = 0;
+    glGetIntegerv(GL_FRAMEBUFFER_BINDING, &prevFb);
+
+    // Layered attachment, the geometry shader routes each primitive to a face via gl_Layer
+    glBindFramebuffer(GL_FRAMEBUFFER, fbID);
+    glFramebufferTexture(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, texID, 0);
+
+    glDrawBuffer(GL_NONE);
+    glReadBuffer(GL_NONE);
+
+    GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+    if (status != GL_FRAMEBUFFER_COMPLETE) {
+        std::cerr << "[OpenGLBackend] FBO incomplete after cube depth attach: 0x" << std::hex
+                  << status << std::dec << "\n";
+    }
+
+    glBindFramebuffer(GL_FRAMEBUFFER, prevFb);
+}
+
 void OpenGLBackend::fbDestroy(uint32_t fbID) {
-    if (fbID)
+    if (fbID) {
         glDeleteFramebuffers(1, &fbID);
+        fbColorAttachments_.erase(fbID);
+    }
 }
 
 // OpenGL Context
@@ -1016,8 +1944,16 @@ bool OpenGLContext::initialize(Window& window) {
     }
     backend = std::make_unique<OpenGLBackend>();
     CORVUS_CORE_INFO("OpenGL: {}", reinterpret_cast<const char*>(glGetString(GL_VERSION)));
+#ifdef CORVUS_DEBUG
+    if (hasDebugMarkers()) {
+        glEnable(GL_DEBUG_OUTPUT);
+        glEnable(GL_DEBUG_OUTPUT_SYNCHRONOUS);
+        glDebugMessageCallback(glDebugCallback, nullptr);
+        CORVUS_CORE_INFO("OpenGL debug output enabled");
+    }
+#endif
     glEnable(GL_BLEND);
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    glBlendFuncSeparate(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA, GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
     glEnable(GL_DEPTH_TEST);
     return true;
 }
@@ -1041,6 +1977,7 @@ void OpenGLBackend::clearCommandBuffers() {
 }
 
 void OpenGLContext::beginFrame() {
+    backend->pollReadbacks();
     backend->performDeferredDeletes();
     backend->clearPendingSubmissions();
     backend->clearCommandBuffers();
@@ -1097,8 +2034,19 @@ Shader OpenGLContext::createShader(const std::string& vs, const std::string& fs)
     return h;
 }
 
+Shader
+OpenGLContext::createShader(const std::string& vs, const std::string& gs, const std::string& fs) {
+    auto h = backend->shaderCreateGeometry(vs, gs, fs);
+    attachBackend(h);
+    return h;
+}
+
 Texture2D OpenGLContext::createTexture2D(uint32_t w, uint32_t h) {
-    auto t2d = backend->tex2DCreate(w, h);
+    return createTexture2D(w, h, ImageFormat::RGBA8);
+}
+
+Texture2D OpenGLContext::createTexture2D(uint32_t w, uint32_t h, ImageFormat format) {
+    auto t2d = backend->tex2DCreate(w, h, format);
     attachBackend(t2d);
     return t2d;
 }
@@ -1109,6 +2057,12 @@ Texture2D OpenGLContext::createDepthTexture(uint32_t w, uint32_t h) {
     return tex;
 }
 
+Texture2DArray OpenGLContext::createDepthTextureArray(uint32_t w, uint32_t h, uint32_t layers) {
+    auto tex = backend->tex2DArrayCreateDepth(w, h, layers);
+    attachBackend(tex);
+    return tex;
+}
+
 TextureCube OpenGLContext::createTextureCube(uint32_t resolution) {
     TextureCube tex = backend->texCubeCreate(resolution);
     tex.be          = backend.get();
@@ -1127,6 +2081,27 @@ Framebuffer OpenGLContext::createFramebuffer(uint32_t width, uint32_t height) {
     return h;
 }
 
+Shader OpenGLContext::createComputeShader(const std::string& cs) {
+    auto h = backend->shaderCreateCompute(cs);
+    if (h.id)
+        attachBackend(h);
+    return h;
+}
+
+TextureBuffer
+OpenGLContext::createTextureBuffer(ImageFormat format, const void* data, uint32_t size) {
+    auto h = backend->texBufferCreate(format, data, size);
+    attachBackend(h);
+    return h;
+}
+
+StorageBuffer OpenGLContext::createStorageBuffer(const void* data, uint32_t size) {
+    auto h = backend->sbCreate(data, size);
+    if (h.id)
+        attachBackend(h);
+    return h;
+}
+
 void OpenGLBackend::cmdSetDepthMask(uint32_t id, bool enable) {
     auto it = commandBuffers_.find(id);
     if (it == commandBuffers_.end() || !it->second.recording)
@@ -1176,6 +2151,18 @@ void OpenGLBackend::destroyNow(const ResourceType type, const uint32_t id) {
         case ResourceType::FBO:
             fbDestroy(id);
             break;
+        case ResourceType::SSBO:
+            sbDestroy(id);
+            break;
+        case ResourceType::Readback:
+            readbackDestroy(id);
+            break;
+        case ResourceType::TexBuffer:
+            texBufferDestroy(id);
+            break;
+        case ResourceType::Tex2DArray:
+            tex2DArrayDestroy(id);
+            break;
     }
 }
 }
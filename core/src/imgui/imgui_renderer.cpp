@@ -104,6 +104,10 @@ bool ImGuiRenderer::initialize(Graphics::GraphicsContext& ctx) {
     ibo = context->createIndexBuffer(nullptr, 0, true);
     vao.addVertexBuffer(vbo, layout);
     vao.setIndexBuffer(ibo);
+    CORVUS_GPU_LABEL(shader, "ImGui Shader");
+    CORVUS_GPU_LABEL(vao, "ImGui VAO");
+    CORVUS_GPU_LABEL(vbo, "ImGui VBO");
+    CORVUS_GPU_LABEL(ibo, "ImGui IBO");
 
     // Upload font texture
     const ImGuiIO& io     = ImGui::GetIO();
@@ -113,6 +117,7 @@ bool ImGuiRenderer::initialize(Graphics::GraphicsContext& ctx) {
 
     fontTexture = context->createTexture2D(w, h);
     fontTexture.setData(pixels, w * h * 4);
+    CORVUS_GPU_LABEL(fontTexture, "ImGui Font Atlas");
     io.Fonts->TexID = static_cast<ImTextureID>(fontTexture.getNativeHandle());
 
     CORVUS_CORE_INFO("ImGui initialized (font texture: {}x{})", w, h);
@@ -171,6 +176,7 @@ void ImGuiRenderer::renderDrawData(ImDrawData* drawData) {
     // Create a command buffer for all ImGui rendering
     auto cmd = context->createCommandBuffer();
     cmd.begin();
+    CORVUS_GPU_PUSH_GROUP(cmd, "ImGui");
 
     cmd.unbindFramebuffer();
 
@@ -269,6 +275,7 @@ void ImGuiRenderer::renderDrawData(ImDrawData* drawData) {
 
     // Disable scissor test
     cmd.enableScissor(false);
+    CORVUS_GPU_POP_GROUP(cmd);
 
     // Submit all recorded commands
     cmd.end();
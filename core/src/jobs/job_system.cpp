@@ -0,0 +1,168 @@
+#include "corvus/jobs/job_system.hpp"
+
+#include "corvus/log.hpp"
+
+namespace Corvus::Core {
+
+namespace {
+    // Deque of the calling thread in the scheduler that owns it
+    thread_local const JobSystem* currentSystem = nullptr;
+    thread_local uint32_t         currentQueue  = 0;
+}
+
+JobSystem& JobSystem::get() {
+    static JobSystem instance(std::max(std::thread::hardware_concurrency(), 2u) - 1);
+    return instance;
+}
+
+JobSystem::JobSystem(const uint32_t workerCount) : mainThread_(std::this_thread::get_id()) {
+    for (uint32_t i = 0; i <= workerCount; ++i)
+        queues_.push_back(std::make_unique<WorkQueue>());
+
+    currentSystem = this;
+    currentQueue  = 0;
+
+    workers_.reserve(workerCount);
+    for (uint32_t i = 1; i <= workerCount; ++i)
+        workers_.emplace_back(&JobSystem::workerLoop, this, i);
+
+    CORVUS_CORE_INFO("JobSystem started with {} workers", workerCount);
+}
+
+JobSystem::~JobSystem() {
+    {
+        std::lock_guard lock(sleepMutex_);
+        running_ = false;
+    }
+    wake_.notify_all();
+
+    for (auto& worker : workers_) {
+        if (worker.joinable())
+            worker.join();
+    }
+}
+
+uint32_t JobSystem::callerQueue() {
+    if (currentSystem == this)
+        return currentQueue;
+
+    // Threads outside the pool spread their jobs over the workers
+    if (workers_.empty())
+        return 0;
+    return 1 + nextQueue_.fetch_add(1, std::memory_order_relaxed) % getWorkerCount();
+}
+
+void JobSystem::run(JobCounter& counter, Job job) {
+    counter.pending_.fetch_add(1, std::memory_order_relaxed);
+
+    WorkQueue& queue = *queues_[callerQueue()];
+    {
+        std::lock_guard lock(queue.mutex);
+        queue.jobs.push_back({ std::move(job), &counter });
+    }
+    queued_.fetch_add(1, std::memory_order_release);
+
+    // Taking the lock orders this against a worker between its check and its sleep
+    { std::lock_guard lock(sleepMutex_); }
+    wake_.notify_one();
+}
+
+void JobSystem::runOnMainThread(JobCounter& counter, Job job) {
+    counter.pending_.fetch_add(1, std::memory_order_relaxed);
+
+    std::lock_guard lock(mainThreadQueue_.mutex);
+    mainThreadQueue_.jobs.push_back({ std::move(job), &counter });
+}
+
+void JobSystem::wait(JobCounter& counter) {
+    const uint32_t queueIndex = callerQueue();
+    const bool     mainThread = isMainThread();
+
+    while (!counter.done()) {
+        if (mainThread && tryRunMainThreadOne())
+            continue;
+        if (tryRunOne(queueIndex))
+            continue;
+
+        // Whatever is left is running on another thread
+        std::this_thread::yield();
+    }
+}
+
+void JobSystem::pumpMainThread() {
+    // Jobs queued by the ones run here wait for the next pump
+    std::deque<Entry> jobs;
+    {
+        std::lock_guard lock(mainThreadQueue_.mutex);
+        jobs.swap(mainThreadQueue_.jobs);
+    }
+
+    for (auto& entry : jobs)
+        execute(entry);
+}
+
+void JobSystem::workerLoop(const uint32_t queueIndex) {
+    currentSystem = this;
+    currentQueue  = queueIndex;
+
+    while (running_.load(std::memory_order_acquire)) {
+        if (tryRunOne(queueIndex))
+            continue;
+
+        std::unique_lock lock(sleepMutex_);
+        wake_.wait(lock, [this] {
+            return queued_.load(std::memory_order_acquire) > 0
+                || !running_.load(std::memory_order_acquire);
+        });
+    }
+}
+
+bool JobSystem::tryRunOne(const uint32_t queueIndex) {
+    Entry      entry;
+    bool       found = false;
+    const auto count = static_cast<uint32_t>(queues_.size());
+
+    for (uint32_t i = 0; i < count && !found; ++i) {
+        WorkQueue&      queue = *queues_[(queueIndex + i) % count];
+        std::lock_guard lock(queue.mutex);
+        if (queue.jobs.empty())
+            continue;
+
+        if (i == 0) {
+            entry = std::move(queue.jobs.back());
+            queue.jobs.pop_back();
+        } else {
+            entry = std::move(queue.jobs.front());
+            queue.jobs.pop_front();
+        }
+        found = true;
+    }
+
+    if (!found)
+        return false;
+
+    queued_.fetch_sub(1, std::memory_order_relaxed);
+    execute(entry);
+    return true;
+}
+
+bool JobSystem::tryRunMainThreadOne() {
+    Entry entry;
+    {
+        std::lock_guard lock(mainThreadQueue_.mutex);
+        if (mainThreadQueue_.jobs.empty())
+            return false;
+        entry = std::move(mainThreadQueue_.jobs.front());
+        mainThreadQueue_.jobs.pop_front();
+    }
+
+    execute(entry);
+    return true;
+}
+
+void JobSystem::execute(Entry& entry) {
+    entry.job();
+    entry.counter->pending_.fetch_sub(1, std::memory_order_release);
+}
+
+}
@@ -0,0 +1,109 @@
+#include "corvus/jobs/system_scheduler.hpp"
+
+#include "corvus/jobs/job_system.hpp"
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <utility>
+
+namespace Corvus::Core {
+
+namespace {
+    // Registries with a concurrent stage running and the changes deferred until it ends
+    struct RunningStage {
+        const entt::registry*                                           registry;
+        std::vector<std::pair<entt::entity, SystemScheduler::ChangeFn>> deferred;
+    };
+
+    std::mutex                runningMutex;
+    std::vector<RunningStage> running;
+    std::atomic<uint32_t>     runningCount { 0 }; // Skips the lock while no stage runs at all
+
+    bool overlaps(const std::vector<entt::id_type>& a, const std::vector<entt::id_type>& b) {
+        return std::any_of(a.begin(), a.end(), [&b](const entt::id_type id) {
+            return std::find(b.begin(), b.end(), id) != b.end();
+        });
+    }
+}
+
+void SystemScheduler::schedule(System system) {
+    // One stage after the latest system it conflicts with, so conflicting systems keep their order
+    size_t stage = 0;
+    for (size_t i = 0; i < stages_.size(); ++i) {
+        for (const uint32_t index : stages_[i]) {
+            const System& other = systems_[index];
+            if (overlaps(system.writes, other.writes) || overlaps(system.writes, other.reads)
+                || overlaps(system.reads, other.writes))
+                stage = i + 1;
+        }
+    }
+
+    if (stage == stages_.size())
+        stages_.emplace_back();
+    stages_[stage].push_back(static_cast<uint32_t>(systems_.size()));
+    systems_.push_back(std::move(system));
+}
+
+void SystemScheduler::run(entt::registry& registry, const double deltaTime) {
+    // Pools are created on first use, which is not safe from several threads at once
+    for (auto& system : systems_)
+        system.assure(registry);
+
+    auto& jobs = JobSystem::get();
+    for (const auto& stage : stages_) {
+        if (stage.size() == 1) {
+            systems_[stage.front()].run(registry, deltaTime);
+            continue;
+        }
+
+        {
+            std::lock_guard lock(runningMutex);
+            running.push_back({ &registry, {} });
+            runningCount.fetch_add(1, std::memory_order_release);
+        }
+
+        JobCounter counter;
+        for (const uint32_t index : stage)
+            jobs.run(counter, [this, index, &registry, deltaTime] {
+                systems_[index].run(registry, deltaTime);
+            });
+        jobs.wait(counter);
+
+        std::vector<std::pair<entt::entity, ChangeFn>> deferred;
+        {
+            std::lock_guard lock(runningMutex);
+            const auto it = std::find_if(running.begin(), running.end(), [&](const auto& other) {
+                return other.registry == &registry;
+            });
+            deferred = std::move(it->deferred);
+            running.erase(it);
+            runningCount.fetch_sub(1, std::memory_order_release);
+        }
+
+        // Nothing else touches the registry between stages
+        for (const auto& [entity, change] : deferred)
+            change(registry, entity);
+    }
+}
+
+void SystemScheduler::deferChange(entt::registry&    registry,
+                                  const entt::entity entity,
+                                  const ChangeFn     change) {
+    if (runningCount.load(std::memory_order_acquire) > 0) {
+        std::lock_guard lock(runningMutex);
+        for (auto& stage : running) {
+            if (stage.registry == &registry) {
+                stage.deferred.emplace_back(entity, change);
+                return;
+            }
+        }
+    }
+    change(registry, entity);
+}
+
+void SystemScheduler::clear() {
+    systems_.clear();
+    stages_.clear();
+}
+
+}
@@ -0,0 +1,104 @@
+#include "corvus/layers/gamelayer.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <glm/gtx/quaternion.hpp>
+
+namespace Corvus::Core {
+
+using Components::TransformComponent;
+
+namespace {
+    // Frame time banked at most, so a debugger break does not turn into minutes of catching up
+    constexpr double MAX_FRAME_TIME = 0.25;
+
+    bool samePose(const TransformComponent& a, const TransformComponent& b) {
+        return a.position == b.position && a.rotation == b.rotation && a.scale == b.scale;
+    }
+}
+
+GameLayer::GameLayer(Application& application, Scene& scene, const double ticksPerSecond)
+    : Layer("GameLayer"), application_(application), scene_(scene) {
+    setTickRate(ticksPerSecond);
+}
+
+void GameLayer::setTickRate(const double ticksPerSecond) {
+    fixedDelta_ = 1.0 / std::max(ticksPerSecond, 1.0);
+}
+
+void GameLayer::onUpdate(const double deltaTime) {
+    accumulator_ += std::min(deltaTime, MAX_FRAME_TIME);
+
+    uint32_t ticks = 0;
+    while (accumulator_ >= fixedDelta_) {
+        if (ticks == maxTicksPerFrame_) {
+            accumulator_ = std::fmod(accumulator_, fixedDelta_);
+            break;
+        }
+
+        tick();
+        accumulator_ -= fixedDelta_;
+        ++ticks;
+    }
+
+    alpha_ = static_cast<float>(accumulator_ / fixedDelta_);
+
+    auto* graphics = application_.getGraphics();
+    if (!graphics)
+        return;
+
+    int width, height;
+    application_.getWindow()->getFramebufferSize(width, height);
+    const float aspect = height > 0 ? static_cast<float>(width) / static_cast<float>(height) : 0.0f;
+    if (aspect > 0.0f && aspect != camera_.getAspectRatio()
+        && camera_.getProjectionType() == Renderer::ProjectionType::Perspective)
+        camera_.setPerspective(
+            camera_.getFOV(), aspect, camera_.getNearPlane(), camera_.getFarPlane());
+
+    interpolateTransforms();
+    scene_.render(*graphics, camera_);
+    restoreTransforms();
+}
+
+void GameLayer::tick() {
+    auto view = scene_.registry.view<TransformComponent>();
+
+    previous_.clear();
+    previous_.reserve(view.size());
+    for (const auto entity : view)
+        previous_.push_back({ entity, view.get<TransformComponent>(entity) });
+
+    systems_.run(scene_.registry, fixedDelta_);
+    ++tickCount_;
+}
+
+void GameLayer::interpolateTransforms() {
+    auto& registry = scene_.registry;
+
+    interpolated_.clear();
+    for (const auto& [entity, previous] : previous_) {
+        if (!registry.valid(entity))
+            continue;
+
+        auto* transform = registry.try_get<TransformComponent>(entity);
+        if (!transform || samePose(previous, *transform))
+            continue;
+
+        interpolated_.push_back({ entity, *transform });
+        transform->position = glm::mix(previous.position, transform->position, alpha_);
+        transform->rotation = glm::slerp(previous.rotation, transform->rotation, alpha_);
+        transform->scale    = glm::mix(previous.scale, transform->scale, alpha_);
+        registry.patch<TransformComponent>(entity);
+    }
+}
+
+void GameLayer::restoreTransforms() {
+    // Patched again so an entity that stops moving is redrawn at its simulated pose
+    auto& registry = scene_.registry;
+    for (const auto& [entity, simulated] : interpolated_) {
+        registry.get<TransformComponent>(entity) = simulated;
+        registry.patch<TransformComponent>(entity);
+    }
+}
+
+}
@@ -0,0 +1,276 @@
+#include "corvus/renderer/batch_transform.hpp"
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#define CORVUS_TRANSFORM_AVX
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define CORVUS_TRANSFORM_SSE
+#endif
+
+namespace Corvus::Renderer {
+
+void TransformSoA::clear() {
+    positionX.clear();
+    positionY.clear();
+    positionZ.clear();
+    rotationX.clear();
+    rotationY.clear();
+    rotationZ.clear();
+    rotationW.clear();
+    scaleX.clear();
+    scaleY.clear();
+    scaleZ.clear();
+}
+
+void TransformSoA::reserve(const size_t count) {
+    positionX.reserve(count);
+    positionY.reserve(count);
+    positionZ.reserve(count);
+    rotationX.reserve(count);
+    rotationY.reserve(count);
+    rotationZ.reserve(count);
+    rotationW.reserve(count);
+    scaleX.reserve(count);
+    scaleY.reserve(count);
+    scaleZ.reserve(count);
+}
+
+void TransformSoA::push(const glm::vec3& position,
+                        const glm::quat& rotation,
+                        const glm::vec3& scale) {
+    positionX.push_back(position.x);
+    positionY.push_back(position.y);
+    positionZ.push_back(position.z);
+    rotationX.push_back(rotation.x);
+    rotationY.push_back(rotation.y);
+    rotationZ.push_back(rotation.z);
+    rotationW.push_back(rotation.w);
+    scaleX.push_back(scale.x);
+    scaleY.push_back(scale.y);
+    scaleZ.push_back(scale.z);
+}
+
+namespace {
+    // Relative to the squared scale, how far the axes may be from equal length and orthogonal
+    // for the scale to count as uniform
+    constexpr float UNIFORM_EPSILON = 1e-4f;
+
+#if defined(CORVUS_TRANSFORM_AVX)
+    constexpr size_t LANES     = 8;
+    constexpr int    ALL_LANES = 0xFF;
+    using Lane                 = __m256;
+
+    Lane load(const float* p) { return _mm256_loadu_ps(p); }
+    void store(float* p, const Lane v) { _mm256_storeu_ps(p, v); }
+    Lane splat(const float v) { return _mm256_set1_ps(v); }
+    Lane add(const Lane a, const Lane b) { return _mm256_add_ps(a, b); }
+    Lane sub(const Lane a, const Lane b) { return _mm256_sub_ps(a, b); }
+    Lane mul(const Lane a, const Lane b) { return _mm256_mul_ps(a, b); }
+    Lane div(const Lane a, const Lane b) { return _mm256_div_ps(a, b); }
+    Lane absolute(const Lane a) { return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), a); }
+    int  lessMask(const Lane a, const Lane b) {
+        return _mm256_movemask_ps(_mm256_cmp_ps(a, b, _CMP_LT_OQ));
+    }
+#elif defined(CORVUS_TRANSFORM_SSE)
+    constexpr size_t LANES     = 4;
+    constexpr int    ALL_LANES = 0xF;
+    using Lane                 = __m128;
+
+    Lane load(const float* p) { return _mm_loadu_ps(p); }
+    void store(float* p, const Lane v) { _mm_storeu_ps(p, v); }
+    Lane splat(const float v) { return _mm_set1_ps(v); }
+    Lane add(const Lane a, const Lane b) { return _mm_add_ps(a, b); }
+    Lane sub(const Lane a, const Lane b) { return _mm_sub_ps(a, b); }
+    Lane mul(const Lane a, const Lane b) { return _mm_mul_ps(a, b); }
+    Lane div(const Lane a, const Lane b) { return _mm_div_ps(a, b); }
+    Lane absolute(const Lane a) { return _mm_andnot_ps(_mm_set1_ps(-0.0f), a); }
+    int  lessMask(const Lane a, const Lane b) { return _mm_movemask_ps(_mm_cmplt_ps(a, b)); }
+#endif
+
+#if defined(CORVUS_TRANSFORM_AVX) || defined(CORVUS_TRANSFORM_SSE)
+    Lane dot(const Lane ax,
+             const Lane ay,
+             const Lane az,
+             const Lane bx,
+             const Lane by,
+             const Lane bz) {
+        return add(add(mul(ax, bx), mul(ay, by)), mul(az, bz));
+    }
+
+    // Rotation columns from the quaternions, scaled per axis, as in glm::toMat4
+    void composeLanes(const TransformSoA& transforms, const size_t i, glm::mat4* out) {
+        const Lane x = load(&transforms.rotationX[i]);
+        const Lane y = load(&transforms.rotationY[i]);
+        const Lane z = load(&transforms.rotationZ[i]);
+        const Lane w = load(&transforms.rotationW[i]);
+
+        const Lane one = splat(1.0f);
+        const Lane two = splat(2.0f);
+        const Lane xx  = mul(x, x);
+        const Lane yy  = mul(y, y);
+        const Lane zz  = mul(z, z);
+        const Lane xy  = mul(x, y);
+        const Lane xz  = mul(x, z);
+        const Lane yz  = mul(y, z);
+        const Lane wx  = mul(w, x);
+        const Lane wy  = mul(w, y);
+        const Lane wz  = mul(w, z);
+
+        const Lane sx = load(&transforms.scaleX[i]);
+        const Lane sy = load(&transforms.scaleY[i]);
+        const Lane sz = load(&transforms.scaleZ[i]);
+
+        alignas(32) float m[9][LANES];
+        store(m[0], mul(sub(one, mul(two, add(yy, zz))), sx));
+        store(m[1], mul(mul(two, add(xy, wz)), sx));
+        store(m[2], mul(mul(two, sub(xz, wy)), sx));
+        store(m[3], mul(mul(two, sub(xy, wz)), sy));
+        store(m[4], mul(sub(one, mul(two, add(xx, zz))), sy));
+        store(m[5], mul(mul(two, add(yz, wx)), sy));
+        store(m[6], mul(mul(two, add(xz, wy)), sz));
+        store(m[7], mul(mul(two, sub(yz, wx)), sz));
+        store(m[8], mul(sub(one, mul(two, add(xx, yy))), sz));
+
+        for (size_t k = 0; k < LANES; ++k) {
+            out[i + k] = glm::mat4(glm::vec4(m[0][k], m[1][k], m[2][k], 0.0f),
+                                   glm::vec4(m[3][k], m[4][k], m[5][k], 0.0f),
+                                   glm::vec4(m[6][k], m[7][k], m[8][k], 0.0f),
+                                   glm::vec4(transforms.positionX[i + k],
+                                             transforms.positionY[i + k],
+                                             transforms.positionZ[i + k],
+                                             1.0f));
+        }
+    }
+
+    void normalLanes(const glm::mat4* models, glm::mat3* out) {
+        alignas(32) float c[9][LANES];
+        for (size_t k = 0; k < LANES; ++k) {
+            for (int column = 0; column < 3; ++column) {
+                for (int row = 0; row < 3; ++row)
+                    c[column * 3 + row][k] = models[k][column][row];
+            }
+        }
+
+        const Lane ax = load(c[0]), ay = load(c[1]), az = load(c[2]);
+        const Lane bx = load(c[3]), by = load(c[4]), bz = load(c[5]);
+        const Lane cx = load(c[6]), cy = load(c[7]), cz = load(c[8]);
+
+        const Lane aa        = dot(ax, ay, az, ax, ay, az);
+        const Lane tolerance = mul(aa, splat(UNIFORM_EPSILON));
+        const int  uniform   = lessMask(absolute(sub(aa, dot(bx, by, bz, bx, by, bz))), tolerance)
+            & lessMask(absolute(sub(aa, dot(cx, cy, cz, cx, cy, cz))), tolerance)
+            & lessMask(absolute(dot(ax, ay, az, bx, by, bz)), tolerance)
+            & lessMask(absolute(dot(bx, by, bz, cx, cy, cz)), tolerance)
+            & lessMask(absolute(dot(cx, cy, cz, ax, ay, az)), tolerance);
+
+        alignas(32) float n[9][LANES];
+        if (uniform == ALL_LANES) {
+            // Rotation times s, its inverse transpose is the same matrix over s squared
+            const Lane inv = div(splat(1.0f), aa);
+            store(n[0], mul(ax, inv));
+            store(n[1], mul(ay, inv));
+            store(n[2], mul(az, inv));
+            store(n[3], mul(bx, inv));
+            store(n[4], mul(by, inv));
+            store(n[5], mul(bz, inv));
+            store(n[6], mul(cx, inv));
+            store(n[7], mul(cy, inv));
+            store(n[8], mul(cz, inv));
+        } else {
+            // Columns of the inverse transpose are the cross products of the other two over det
+            const Lane n0x = sub(mul(by, cz), mul(bz, cy));
+            const Lane n0y = sub(mul(bz, cx), mul(bx, cz));
+            const Lane n0z = sub(mul(bx, cy), mul(by, cx));
+            const Lane inv = div(splat(1.0f), dot(ax, ay, az, n0x, n0y, n0z));
+            store(n[0], mul(n0x, inv));
+            store(n[1], mul(n0y, inv));
+            store(n[2], mul(n0z, inv));
+            store(n[3], mul(sub(mul(cy, az), mul(cz, ay)), inv));
+            store(n[4], mul(sub(mul(cz, ax), mul(cx, az)), inv));
+            store(n[5], mul(sub(mul(cx, ay), mul(cy, ax)), inv));
+            store(n[6], mul(sub(mul(ay, bz), mul(az, by)), inv));
+            store(n[7], mul(sub(mul(az, bx), mul(ax, bz)), inv));
+            store(n[8], mul(sub(mul(ax, by), mul(ay, bx)), inv));
+        }
+
+        for (size_t k = 0; k < LANES; ++k) {
+            out[k] = glm::mat3(glm::vec3(n[0][k], n[1][k], n[2][k]),
+                               glm::vec3(n[3][k], n[4][k], n[5][k]),
+                               glm::vec3(n[6][k], n[7][k], n[8][k]));
+        }
+    }
+#endif
+}
+
+glm::mat4 composeMatrix(const glm::vec3& position,
+                        const glm::quat& rotation,
+                        const glm::vec3& scale) {
+    const float xx = rotation.x * rotation.x;
+    const float yy = rotation.y * rotation.y;
+    const float zz = rotation.z * rotation.z;
+    const float xy = rotation.x * rotation.y;
+    const float xz = rotation.x * rotation.z;
+    const float yz = rotation.y * rotation.z;
+    const float wx = rotation.w * rotation.x;
+    const float wy = rotation.w * rotation.y;
+    const float wz = rotation.w * rotation.z;
+
+    return glm::mat4(
+        glm::vec4(1.0f - 2.0f * (yy + zz), 2.0f * (xy + wz), 2.0f * (xz - wy), 0.0f) * scale.x,
+        glm::vec4(2.0f * (xy - wz), 1.0f - 2.0f * (xx + zz), 2.0f * (yz + wx), 0.0f) * scale.y,
+        glm::vec4(2.0f * (xz + wy), 2.0f * (yz - wx), 1.0f - 2.0f * (xx + yy), 0.0f) * scale.z,
+        glm::vec4(position, 1.0f));
+}
+
+void composeMatrices(const TransformSoA& transforms,
+                     const size_t        first,
+                     const size_t        last,
+                     glm::mat4*          out) {
+    size_t i = first;
+
+#if defined(CORVUS_TRANSFORM_AVX) || defined(CORVUS_TRANSFORM_SSE)
+    for (; i + LANES <= last; i += LANES)
+        composeLanes(transforms, i, out);
+#endif
+
+    for (; i < last; ++i) {
+        out[i] = composeMatrix(
+            glm::vec3(transforms.positionX[i], transforms.positionY[i], transforms.positionZ[i]),
+            glm::quat(transforms.rotationW[i],
+                      transforms.rotationX[i],
+                      transforms.rotationY[i],
+                      transforms.rotationZ[i]),
+            glm::vec3(transforms.scaleX[i], transforms.scaleY[i], transforms.scaleZ[i]));
+    }
+}
+
+glm::mat3 normalMatrix(const glm::mat4& model) {
+    const glm::vec3 a(model[0]);
+    const glm::vec3 b(model[1]);
+    const glm::vec3 c(model[2]);
+
+    const float aa        = glm::dot(a, a);
+    const float tolerance = aa * UNIFORM_EPSILON;
+    if (glm::abs(aa - glm::dot(b, b)) < tolerance && glm::abs(aa - glm::dot(c, c)) < tolerance
+        && glm::abs(glm::dot(a, b)) < tolerance && glm::abs(glm::dot(b, c)) < tolerance
+        && glm::abs(glm::dot(c, a)) < tolerance)
+        return glm::mat3(a, b, c) * (1.0f / aa);
+
+    const glm::vec3 n0 = glm::cross(b, c);
+    return glm::mat3(n0, glm::cross(c, a), glm::cross(a, b)) * (1.0f / glm::dot(a, n0));
+}
+
+void normalMatrices(const glm::mat4* models, const size_t count, glm::mat3* out) {
+    size_t i = 0;
+
+#if defined(CORVUS_TRANSFORM_AVX) || defined(CORVUS_TRANSFORM_SSE)
+    for (; i + LANES <= count; i += LANES)
+        normalLanes(models + i, out + i);
+#endif
+
+    for (; i < count; ++i)
+        out[i] = normalMatrix(models[i]);
+}
+
+}
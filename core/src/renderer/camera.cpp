@@ -135,33 +135,39 @@ void Camera::updateProjectionMatrix() const {
     }
 }
 
-void Camera::updateFrustum() const {
-    glm::mat4 vp = getViewProjectionMatrix();
+Camera::Frustum Camera::Frustum::fromMatrix(const glm::mat4& vp) {
+    Frustum result {};
 
     // Extract frustum planes
     for (int i = 0; i < 6; ++i) {
         const int   row  = i / 2;
         const float sign = (i % 2 == 0) ? 1.0f : -1.0f;
 
-        frustum.planes[i] = glm::vec4(vp[0][3] + sign * vp[0][row],
-                                      vp[1][3] + sign * vp[1][row],
-                                      vp[2][3] + sign * vp[2][row],
-                                      vp[3][3] + sign * vp[3][row]);
+        result.planes[i] = glm::vec4(vp[0][3] + sign * vp[0][row],
+                                     vp[1][3] + sign * vp[1][row],
+                                     vp[2][3] + sign * vp[2][row],
+                                     vp[3][3] + sign * vp[3][row]);
 
-        const float length = glm::length(glm::vec3(frustum.planes[i]));
-        frustum.planes[i] /= length;
+        const float length = glm::length(glm::vec3(result.planes[i]));
+        result.planes[i] /= length;
     }
+
+    return result;
 }
 
+void Camera::updateFrustum() const { frustum = Frustum::fromMatrix(getViewProjectionMatrix()); }
+
 void Camera::setTarget(const glm::vec3& target) {
-    this->target    = target;
-    this->useLookAt = true;
-    this->viewDirty = true;
+    this->target       = target;
+    this->useLookAt    = true;
+    this->viewDirty    = true;
+    this->frustumDirty = true;
 }
 
 void Camera::setUp(const glm::vec3& up) {
-    this->up        = up;
-    this->viewDirty = true;
+    this->up           = up;
+    this->viewDirty    = true;
+    this->frustumDirty = true;
 }
 
 }
@@ -0,0 +1,194 @@
+#include "corvus/renderer/culling.hpp"
+
+#include "corvus/jobs/job_system.hpp"
+#include <atomic>
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#define CORVUS_CULL_AVX
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define CORVUS_CULL_SSE
+#endif
+
+namespace Corvus::Renderer {
+
+void SphereBoundsSoA::clear() {
+    centerX.clear();
+    centerY.clear();
+    centerZ.clear();
+    radius.clear();
+}
+
+void SphereBoundsSoA::reserve(const size_t count) {
+    centerX.reserve(count);
+    centerY.reserve(count);
+    centerZ.reserve(count);
+    radius.reserve(count);
+}
+
+void SphereBoundsSoA::push(const glm::vec3& center, const float r) {
+    centerX.push_back(center.x);
+    centerY.push_back(center.y);
+    centerZ.push_back(center.z);
+    radius.push_back(r);
+}
+
+namespace {
+    // Spheres per job, a multiple of the widest SIMD step so only the last range has a tail
+    constexpr size_t CULL_GRAIN = 8192;
+
+    uint32_t cullRange(const Camera::Frustum& frustum,
+                       const SphereBoundsSoA& bounds,
+                       const size_t           first,
+                       const size_t           last,
+                       uint8_t*               visible) {
+        const float* cx = bounds.centerX.data();
+        const float* cy = bounds.centerY.data();
+        const float* cz = bounds.centerZ.data();
+        const float* cr = bounds.radius.data();
+
+        uint32_t visibleCount = 0;
+        size_t   i            = first;
+
+#if defined(CORVUS_CULL_AVX)
+        __m256 px[6], py[6], pz[6], pw[6];
+        for (int p = 0; p < 6; ++p) {
+            px[p] = _mm256_set1_ps(frustum.planes[p].x);
+            py[p] = _mm256_set1_ps(frustum.planes[p].y);
+            pz[p] = _mm256_set1_ps(frustum.planes[p].z);
+            pw[p] = _mm256_set1_ps(frustum.planes[p].w);
+        }
+
+        for (; i + 8 <= last; i += 8) {
+            const __m256 x    = _mm256_loadu_ps(cx + i);
+            const __m256 y    = _mm256_loadu_ps(cy + i);
+            const __m256 z    = _mm256_loadu_ps(cz + i);
+            const __m256 negR = _mm256_sub_ps(_mm256_setzero_ps(), _mm256_loadu_ps(cr + i));
+
+            __m256 inside = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+            for (int p = 0; p < 6; ++p) {
+                __m256 d = _mm256_add_ps(_mm256_mul_ps(px[p], x), pw[p]);
+                d        = _mm256_add_ps(d, _mm256_mul_ps(py[p], y));
+                d        = _mm256_add_ps(d, _mm256_mul_ps(pz[p], z));
+                inside   = _mm256_and_ps(inside, _mm256_cmp_ps(d, negR, _CMP_GE_OQ));
+            }
+
+            const int mask = _mm256_movemask_ps(inside);
+            for (int k = 0; k < 8; ++k) {
+                const uint8_t v = static_cast<uint8_t>((mask >> k) & 1);
+                visible[i + k]  = v;
+                visibleCount += v;
+            }
+        }
+#elif defined(CORVUS_CULL_SSE)
+        __m128 px[6], py[6], pz[6], pw[6];
+        for (int p = 0; p < 6; ++p) {
+            px[p] = _mm_set1_ps(frustum.planes[p].x);
+            py[p] = _mm_set1_ps(frustum.planes[p].y);
+            pz[p] = _mm_set1_ps(frustum.planes[p].z);
+            pw[p] = _mm_set1_ps(frustum.planes[p].w);
+        }
+
+        for (; i + 4 <= last; i += 4) {
+            const __m128 x    = _mm_loadu_ps(cx + i);
+            const __m128 y    = _mm_loadu_ps(cy + i);
+            const __m128 z    = _mm_loadu_ps(cz + i);
+            const __m128 negR = _mm_sub_ps(_mm_setzero_ps(), _mm_loadu_ps(cr + i));
+
+            __m128 inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+            for (int p = 0; p < 6; ++p) {
+                __m128 d = _mm_add_ps(_mm_mul_ps(px[p], x), pw[p]);
+                d        = _mm_add_ps(d, _mm_mul_ps(py[p], y));
+                d        = _mm_add_ps(d, _mm_mul_ps(pz[p], z));
+                inside   = _mm_and_ps(inside, _mm_cmpge_ps(d, negR));
+            }
+
+            const int mask = _mm_movemask_ps(inside);
+            for (int k = 0; k < 4; ++k) {
+                const uint8_t v = static_cast<uint8_t>((mask >> k) & 1);
+                visible[i + k]  = v;
+                visibleCount += v;
+            }
+        }
+#endif
+
+        // Scalar tail, and the whole range on targets without SSE
+        for (; i < last; ++i) {
+            bool inside = true;
+            for (int p = 0; p < 6 && inside; ++p) {
+                const glm::vec4& plane = frustum.planes[p];
+                const float      d = plane.x * cx[i] + plane.y * cy[i] + plane.z * cz[i] + plane.w;
+                inside             = d >= -cr[i];
+            }
+            visible[i] = inside ? 1 : 0;
+            visibleCount += inside ? 1 : 0;
+        }
+
+        return visibleCount;
+    }
+
+    uint32_t cullRange(const glm::vec3&       center,
+                       const float            radius,
+                       const SphereBoundsSoA& bounds,
+                       const size_t           first,
+                       const size_t           last,
+                       uint8_t*               visible) {
+        const float* cx = bounds.centerX.data();
+        const float* cy = bounds.centerY.data();
+        const float* cz = bounds.centerZ.data();
+        const float* cr = bounds.radius.data();
+
+        // Branch free so the compiler can vectorize it without hand written paths
+        uint32_t visibleCount = 0;
+        for (size_t i = first; i < last; ++i) {
+            const float   dx    = cx[i] - center.x;
+            const float   dy    = cy[i] - center.y;
+            const float   dz    = cz[i] - center.z;
+            const float   reach = cr[i] + radius;
+            const uint8_t v     = (dx * dx + dy * dy + dz * dz) <= reach * reach ? 1 : 0;
+            visible[i]    = v;
+            visibleCount += v;
+        }
+
+        return visibleCount;
+    }
+}
+
+uint32_t cullSpheres(const Camera::Frustum& frustum,
+                     const SphereBoundsSoA& bounds,
+                     std::vector<uint8_t>&  visible) {
+    return cullSpheres(frustum, bounds, visible, Core::JobSystem::get());
+}
+
+uint32_t cullSpheres(const Camera::Frustum& frustum,
+                     const SphereBoundsSoA& bounds,
+                     std::vector<uint8_t>&  visible,
+                     Core::JobSystem&       jobs) {
+    visible.resize(bounds.size());
+
+    // Ranges write disjoint parts of visible, only the count is shared
+    std::atomic<uint32_t> visibleCount { 0 };
+    jobs.parallelFor(0, bounds.size(), CULL_GRAIN, [&](const size_t first, const size_t last) {
+        visibleCount.fetch_add(cullRange(frustum, bounds, first, last, visible.data()),
+                               std::memory_order_relaxed);
+    });
+    return visibleCount.load(std::memory_order_relaxed);
+}
+
+uint32_t cullSpheres(const glm::vec3&       center,
+                     float                  radius,
+                     const SphereBoundsSoA& bounds,
+                     std::vector<uint8_t>&  visible) {
+    visible.resize(bounds.size());
+
+    std::atomic<uint32_t> visibleCount { 0 };
+    Core::JobSystem::get().parallelFor(
+        0, bounds.size(), CULL_GRAIN, [&](const size_t first, const size_t last) {
+            visibleCount.fetch_add(cullRange(center, radius, bounds, first, last, visible.data()),
+                                   std::memory_order_relaxed);
+        });
+    return visibleCount.load(std::memory_order_relaxed);
+}
+
+}
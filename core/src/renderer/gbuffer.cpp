@@ -0,0 +1,41 @@
+#include "corvus/renderer/gbuffer.hpp"
+
+namespace Corvus::Renderer {
+
+void GBuffer::resize(Graphics::GraphicsContext& ctx, const uint32_t w, const uint32_t h) {
+    if (initialized && width == w && height == h) {
+        return;
+    }
+
+    cleanup();
+    width  = w;
+    height = h;
+
+    albedo      = ctx.createTexture2D(w, h, Graphics::ImageFormat::RGBA8);
+    normal      = ctx.createTexture2D(w, h, Graphics::ImageFormat::RGBA16F);
+    depth       = ctx.createDepthTexture(w, h);
+    framebuffer = ctx.createFramebuffer(w, h);
+    framebuffer.attachTexture2D(albedo, 0);
+    framebuffer.attachTexture2D(normal, 1);
+    framebuffer.attachDepthTexture(depth);
+    CORVUS_GPU_LABEL(albedo, "GBuffer Albedo");
+    CORVUS_GPU_LABEL(normal, "GBuffer Normal");
+    CORVUS_GPU_LABEL(depth, "GBuffer Depth");
+    CORVUS_GPU_LABEL(framebuffer, "GBuffer FBO");
+
+    initialized = true;
+}
+
+void GBuffer::cleanup() {
+    if (initialized) {
+        framebuffer.release();
+        depth.release();
+        normal.release();
+        albedo.release();
+        initialized = false;
+        width       = 0;
+        height      = 0;
+    }
+}
+
+}
@@ -1,57 +1,69 @@
 #include "corvus/renderer/lighting.hpp"
 #include "corvus/log.hpp"
-#include "glm/gtc/epsilon.hpp"
 #include <algorithm>
+#include <cmath>
 #include <glm/gtc/matrix_transform.hpp>
+#include <limits>
+#include <string>
 
 namespace Corvus::Renderer {
 
-// ShadowMap
-void ShadowMap::initialize(Graphics::GraphicsContext& ctx, const uint32_t res) {
-    if (initialized && resolution == res) {
-        return;
-    }
-
-    cleanup();
-    resolution = res;
-
-    depthTexture = ctx.createDepthTexture(res, res);
-    framebuffer  = ctx.createFramebuffer(res, res);
-    framebuffer.attachDepthTexture(depthTexture);
-
-    initialized = true;
-}
-
-void ShadowMap::cleanup() {
-    if (initialized) {
-        framebuffer.release();
-        depthTexture.release();
-        initialized = false;
-        resolution  = 0;
+namespace {
+    // Uniform array element names, built once so per-draw uniform setup does not allocate
+    template <size_t N>
+    std::array<std::string, N> indexedUniformNames(const char* base) {
+        std::array<std::string, N> names;
+        for (size_t i = 0; i < N; ++i)
+            names[i] = std::string(base) + "[" + std::to_string(i) + "]";
+        return names;
+    }
+
+    // Recover the view space depth range from a perspective or orthographic projection
+    void depthRangeFromProjection(const glm::mat4& proj, float& nearPlane, float& farPlane) {
+        if (proj[2][3] != 0.0f) {
+            nearPlane = proj[3][2] / (proj[2][2] - 1.0f);
+            farPlane  = proj[3][2] / (proj[2][2] + 1.0f);
+        } else {
+            nearPlane = (proj[3][2] + 1.0f) / proj[2][2];
+            farPlane  = (proj[3][2] - 1.0f) / proj[2][2];
+        }
     }
 }
 
-// CubemapShadow
-void CubemapShadow::initialize(Graphics::GraphicsContext& ctx, uint32_t res) {
-    if (initialized && resolution == res) {
+// CascadedShadowMap
+void CascadedShadowMap::initialize(Graphics::GraphicsContext& ctx,
+                                   const uint32_t             res,
+                                   const uint32_t             cascades) {
+    if (initialized && resolution == res && cascadeCount == cascades) {
         return;
     }
 
     cleanup();
-    resolution = res;
+    resolution   = res;
+    cascadeCount = cascades;
+
+    depthArray = ctx.createDepthTextureArray(res, res, cascades);
+    CORVUS_GPU_LABEL(depthArray, "Cascaded Shadow Depth");
 
-    depthCubemap = ctx.createTextureCube(res);
-    framebuffer  = ctx.createFramebuffer(res, res);
+    // One framebuffer per layer, attachments are applied immediately rather than recorded
+    for (uint32_t i = 0; i < cascades; ++i) {
+        framebuffers[i] = ctx.createFramebuffer(res, res);
+        framebuffers[i].attachDepthTextureLayer(depthArray, i);
+        CORVUS_GPU_LABEL(framebuffers[i], "Cascade FBO");
+    }
 
+    casterHashes.fill(0);
     initialized = true;
 }
 
-void CubemapShadow::cleanup() {
+void CascadedShadowMap::cleanup() {
     if (initialized) {
-        framebuffer.release();
-        depthCubemap.release();
-        initialized = false;
-        resolution  = 0;
+        for (uint32_t i = 0; i < cascadeCount; ++i)
+            framebuffers[i].release();
+        depthArray.release();
+        initialized  = false;
+        cascadeCount = 0;
+        resolution   = 0;
     }
 }
 
@@ -60,36 +72,81 @@ LightingSystem::~LightingSystem() { shutdown(); }
 
 LightingSystem::LightingSystem(LightingSystem&& other) noexcept
     : initialized_(other.initialized_), context_(other.context_), lights_(std::move(other.lights_)),
-      ambientColor_(other.ambientColor_), shadowMaps_(std::move(other.shadowMaps_)),
-      cubemapShadows_(std::move(other.cubemapShadows_)),
+      ambientColor_(other.ambientColor_), shadowAtlas_(std::move(other.shadowAtlas_)),
+      shadowSlots_(std::move(other.shadowSlots_)), cascades_(other.cascades_),
+      cascadesActive_(other.cascadesActive_), emptyCascades_(std::move(other.emptyCascades_)),
+      shadowDataBuffer_(std::move(other.shadowDataBuffer_)),
+      shadowDataTexels_(std::move(other.shadowDataTexels_)),
       shadowShader_(std::move(other.shadowShader_)),
       shadowShaderInitialized_(other.shadowShaderInitialized_),
-      shadowBiases_(std::move(other.shadowBiases_)),
-      shadowStrengths_(std::move(other.shadowStrengths_)) {
-
-    other.initialized_             = false;
-    other.context_                 = nullptr;
-    other.shadowShaderInitialized_ = false;
+      pointShadowShader_(std::move(other.pointShadowShader_)),
+      pointShadowShaderInitialized_(other.pointShadowShaderInitialized_),
+      clusterLightBuffer_(std::move(other.clusterLightBuffer_)),
+      clusterGridBuffer_(std::move(other.clusterGridBuffer_)),
+      clusterIndexBuffer_(std::move(other.clusterIndexBuffer_)), clusterNear_(other.clusterNear_),
+      clusterLogScale_(other.clusterLogScale_),
+      clusterLightTexels_(std::move(other.clusterLightTexels_)),
+      clusterGridTexels_(std::move(other.clusterGridTexels_)),
+      clusterIndices_(std::move(other.clusterIndices_)),
+      clusterRanges_(std::move(other.clusterRanges_)) {
+
+    other.initialized_                  = false;
+    other.context_                      = nullptr;
+    other.shadowShaderInitialized_      = false;
+    other.pointShadowShader_            = {};
+    other.pointShadowShaderInitialized_ = false;
+    other.clusterLightBuffer_           = {};
+    other.clusterGridBuffer_            = {};
+    other.clusterIndexBuffer_           = {};
+    other.shadowDataBuffer_             = {};
+    other.shadowAtlas_                  = {};
+    other.cascades_                     = {};
+    other.cascadesActive_               = false;
+    other.emptyCascades_                = {};
 }
 
 LightingSystem& LightingSystem::operator=(LightingSystem&& other) noexcept {
     if (this != &other) {
         shutdown();
 
-        initialized_             = other.initialized_;
-        context_                 = other.context_;
-        lights_                  = std::move(other.lights_);
-        ambientColor_            = other.ambientColor_;
-        shadowMaps_              = std::move(other.shadowMaps_);
-        cubemapShadows_          = std::move(other.cubemapShadows_);
-        shadowShader_            = std::move(other.shadowShader_);
-        shadowShaderInitialized_ = other.shadowShaderInitialized_;
-        shadowBiases_            = std::move(other.shadowBiases_);
-        shadowStrengths_         = std::move(other.shadowStrengths_);
-
-        other.initialized_             = false;
-        other.context_                 = nullptr;
-        other.shadowShaderInitialized_ = false;
+        initialized_                  = other.initialized_;
+        context_                      = other.context_;
+        lights_                       = std::move(other.lights_);
+        ambientColor_                 = other.ambientColor_;
+        shadowAtlas_                  = std::move(other.shadowAtlas_);
+        shadowSlots_                  = std::move(other.shadowSlots_);
+        cascades_                     = other.cascades_;
+        cascadesActive_               = other.cascadesActive_;
+        emptyCascades_                = std::move(other.emptyCascades_);
+        shadowDataBuffer_             = std::move(other.shadowDataBuffer_);
+        shadowDataTexels_             = std::move(other.shadowDataTexels_);
+        shadowShader_                 = std::move(other.shadowShader_);
+        shadowShaderInitialized_      = other.shadowShaderInitialized_;
+        pointShadowShader_            = std::move(other.pointShadowShader_);
+        pointShadowShaderInitialized_ = other.pointShadowShaderInitialized_;
+        clusterLightBuffer_           = std::move(other.clusterLightBuffer_);
+        clusterGridBuffer_            = std::move(other.clusterGridBuffer_);
+        clusterIndexBuffer_           = std::move(other.clusterIndexBuffer_);
+        clusterNear_                  = other.clusterNear_;
+        clusterLogScale_              = other.clusterLogScale_;
+        clusterLightTexels_           = std::move(other.clusterLightTexels_);
+        clusterGridTexels_            = std::move(other.clusterGridTexels_);
+        clusterIndices_               = std::move(other.clusterIndices_);
+        clusterRanges_                = std::move(other.clusterRanges_);
+
+        other.initialized_                  = false;
+        other.context_                      = nullptr;
+        other.shadowShaderInitialized_      = false;
+        other.pointShadowShader_            = {};
+        other.pointShadowShaderInitialized_ = false;
+        other.clusterLightBuffer_           = {};
+        other.clusterGridBuffer_            = {};
+        other.clusterIndexBuffer_           = {};
+        other.shadowDataBuffer_             = {};
+        other.shadowAtlas_                  = {};
+        other.cascades_                     = {};
+        other.cascadesActive_               = false;
+        other.emptyCascades_                = {};
     }
     return *this;
 }
@@ -107,18 +164,12 @@ void LightingSystem::initialize(Graphics::GraphicsContext& ctx) {
 
 void LightingSystem::clear() {
     lights_.clear();
-    shadowBiases_.clear();
-    shadowStrengths_.clear();
+    shadowSlots_.clear();
+    cascadesActive_ = false;
 }
 
 void LightingSystem::addLight(const Light& light) { lights_.push_back(light); }
 
-void LightingSystem::setShadowProperties(const std::vector<float>& biases,
-                                         const std::vector<float>& strengths) {
-    shadowBiases_    = biases;
-    shadowStrengths_ = strengths;
-}
-
 glm::vec3 LightingSystem::normalizeColor(const glm::vec3& color) {
     if (color.r > 1.0f || color.g > 1.0f || color.b > 1.0f) {
         return color / 255.0f;
@@ -164,105 +215,58 @@ const Light* LightingSystem::getPrimaryDirectionalLight() const {
     return nullptr;
 }
 
-LightingSystem::CulledLights LightingSystem::cullLightsForObject(const glm::vec3& position,
-                                                                 float            radius) const {
-
-    CulledLights result;
-
-    struct LightDistance {
-        const Light* light;
-        float        distance;
-    };
-
-    // Point lights
-    std::vector<LightDistance> pointLights;
-    for (const auto& light : lights_) {
-        if (light.type != LightType::Point)
-            continue;
-
-        float dist = glm::distance(position, light.position);
-        if (dist <= light.range + radius) {
-            pointLights.push_back({ &light, dist });
-        }
-    }
-
-    // Sort by distance
-    std::sort(
-        pointLights.begin(), pointLights.end(), [](const LightDistance& a, const LightDistance& b) {
-            return a.distance < b.distance;
-        });
-
-    // Take closest MAX_LIGHTS
-    for (size_t i = 0; i < pointLights.size() && i < MAX_LIGHTS; ++i) {
-        result.pointLights.push_back(pointLights[i].light);
-    }
-
-    // Spot lights
-    std::vector<LightDistance> spotLights;
-    for (const auto& light : lights_) {
-        if (light.type != LightType::Spot)
-            continue;
-
-        float dist = glm::distance(position, light.position);
-        if (dist <= light.range + radius) {
-            spotLights.push_back({ &light, dist });
-        }
+void LightingSystem::prepareShadowMaps(Graphics::GraphicsContext& ctx) {
+    if (!initialized_) {
+        initialize(ctx);
     }
 
-    std::sort(
-        spotLights.begin(), spotLights.end(), [](const LightDistance& a, const LightDistance& b) {
-            return a.distance < b.distance;
-        });
-
-    // Take closest remaining slots
-    size_t remaining = MAX_LIGHTS - result.pointLights.size();
-    for (size_t i = 0; i < spotLights.size() && i < remaining; ++i) {
-        result.spotLights.push_back(spotLights[i].light);
+    // Only the primary directional light is shaded, so only it gets cascades
+    const Light* primary = getPrimaryDirectionalLight();
+    if (primary && primary->castShadows) {
+        cascades_.initialize(
+            ctx,
+            primary->shadowMapResolution,
+            std::clamp(primary->cascadeCount, 1u, CascadedShadowMap::MAX_CASCADES));
     }
 
-    return result;
-}
-
-ShadowMap& LightingSystem::getShadowMap(size_t index) {
-    while (index >= shadowMaps_.size()) {
-        shadowMaps_.emplace_back();
-    }
-    return shadowMaps_[index];
-}
+    shadowAtlas_.initialize(ctx, SHADOW_ATLAS_SIZE);
 
-CubemapShadow& LightingSystem::getCubemapShadow(size_t index) {
-    while (index >= cubemapShadows_.size()) {
-        cubemapShadows_.emplace_back();
-    }
-    return cubemapShadows_[index];
-}
+    // Lights without an entity are keyed by index, stable only while the light list is
+    auto shadowKey = [](const Light& light, size_t index) {
+        uint64_t id = light.id != std::numeric_limits<uint32_t>::max() ? light.id
+                                                                        : (1ull << 32) | index;
+        return (id << 2) | static_cast<uint64_t>(light.type);
+    };
+    auto tileCount = [](const Light& light) { return light.type == LightType::Point ? 6u : 1u; };
+    auto wantsTiles = [](const Light& light) {
+        return light.castShadows && light.type != LightType::Directional;
+    };
 
-void LightingSystem::prepareShadowMaps(Graphics::GraphicsContext& ctx) {
-    if (!initialized_) {
-        initialize(ctx);
+    // Keep last frame's tiles for lights that still want them, then free the rest before new
+    // lights allocate so they can reuse that space
+    shadowAtlas_.beginFrame();
+    for (size_t i = 0; i < lights_.size(); ++i) {
+        if (wantsTiles(lights_[i]))
+            shadowAtlas_.retain(
+                shadowKey(lights_[i], i), tileCount(lights_[i]), lights_[i].shadowMapResolution);
     }
+    shadowAtlas_.releaseUnretained();
 
-    // Clear old shadow maps if light configuration changed
-    size_t neededShadowMaps = 0;
-    size_t neededCubemaps   = 0;
+    shadowSlots_.assign(lights_.size(), nullptr);
+    for (size_t i = 0; i < lights_.size(); ++i) {
+        const Light& light = lights_[i];
+        if (!wantsTiles(light))
+            continue;
 
-    for (const auto& light : lights_) {
-        if (!light.castShadows)
+        // Without room even at the minimum tile size the light renders unshadowed
+        ShadowAtlasSlot* slot = shadowAtlas_.acquire(
+            shadowKey(light, i), tileCount(light), light.shadowMapResolution);
+        if (!slot)
             continue;
 
-        if (light.type == LightType::Directional || light.type == LightType::Spot) {
-            if (neededShadowMaps < MAX_SHADOW_MAPS) {
-                auto& shadowMap = getShadowMap(neededShadowMaps);
-                shadowMap.initialize(ctx, light.shadowMapResolution);
-                neededShadowMaps++;
-            }
-        } else if (light.type == LightType::Point) {
-            if (neededCubemaps < MAX_POINT_SHADOWS) {
-                auto& cubemap = getCubemapShadow(neededCubemaps);
-                cubemap.initialize(ctx, light.shadowMapResolution);
-                neededCubemaps++;
-            }
-        }
+        if (light.type == LightType::Spot)
+            slot->lightSpaceMatrix = calculateSpotLightMatrix(light);
+        shadowSlots_[i] = slot;
     }
 }
 
@@ -275,6 +279,9 @@ Graphics::Shader& LightingSystem::getShadowShader() {
             
             uniform mat4 u_LightSpaceMatrix;
             uniform mat4 u_Model;
+
+            // Also the depth pre-pass, must match default_lit.vert for the lit pass' equal test
+            invariant gl_Position;
             
             void main() {
                 gl_Position = u_LightSpaceMatrix * u_Model * vec4(vertexPosition, 1.0);
@@ -293,6 +300,7 @@ Graphics::Shader& LightingSystem::getShadowShader() {
         shadowShaderInitialized_ = shadowShader_.valid();
 
         if (shadowShaderInitialized_) {
+            CORVUS_GPU_LABEL(shadowShader_, "Shadow Depth Shader");
             CORVUS_CORE_INFO("Shadow shader created successfully");
         } else {
             CORVUS_CORE_ERROR("Failed to create shadow shader");
@@ -302,22 +310,161 @@ Graphics::Shader& LightingSystem::getShadowShader() {
     return shadowShader_;
 }
 
-glm::mat4 LightingSystem::calculateDirectionalLightMatrix(const Light&     light,
-                                                          const glm::vec3& sceneCenter) {
+Graphics::Shader& LightingSystem::getPointShadowShader() {
+    if (!pointShadowShaderInitialized_ && context_) {
+        std::string vertexShader = R"(
+            #version 330 core
+            layout(location = 0) in vec3 vertexPosition;
+
+            uniform mat4 u_Model;
 
-    glm::vec3 lightDir = glm::normalize(light.direction);
-    glm::vec3 lightPos = sceneCenter - lightDir * (light.shadowDistance * 0.5f);
+            void main() {
+                gl_Position = u_Model * vec4(vertexPosition, 1.0);
+            }
+        )";
+
+        // Replicates each triangle to the cube faces whose frustum the caster touches. Faces are
+        // atlas tiles, so the face's clip space is squeezed into its tile (u_FaceRects holds NDC
+        // center and scale) and clip distances keep it from spilling into neighbours
+        std::string geometryShader = R"(
+            #version 330 core
+            layout(triangles) in;
+            layout(triangle_strip, max_vertices = 18) out;
+
+            uniform mat4 u_ShadowMatrices[6];
+            uniform vec4 u_FaceRects[6];
+            uniform int  u_FaceMask;
+
+            out vec3 worldPos;
+
+            void main() {
+                for (int face = 0; face < 6; ++face) {
+                    if ((u_FaceMask & (1 << face)) == 0)
+                        continue;
+
+                    for (int i = 0; i < 3; ++i) {
+                        vec4 clipPos = u_ShadowMatrices[face] * gl_in[i].gl_Position;
+
+                        gl_ClipDistance[0] = clipPos.w + clipPos.x;
+                        gl_ClipDistance[1] = clipPos.w - clipPos.x;
+                        gl_ClipDistance[2] = clipPos.w + clipPos.y;
+                        gl_ClipDistance[3] = clipPos.w - clipPos.y;
+
+                        worldPos    = gl_in[i].gl_Position.xyz;
+                        gl_Position = vec4(clipPos.xy * u_FaceRects[face].zw
+                                               + u_FaceRects[face].xy * clipPos.w,
+                                           clipPos.zw);
+                        EmitVertex();
+                    }
+                    EndPrimitive();
+                }
+            }
+        )";
+
+        // Linear distance so the lit shader can compare against length(fragPos - lightPos)
+        std::string fragmentShader = R"(
+            #version 330 core
+            in vec3 worldPos;
+
+            uniform vec3  u_LightPos;
+            uniform float u_FarPlane;
+
+            void main() {
+                gl_FragDepth = length(worldPos - u_LightPos) / u_FarPlane;
+            }
+        )";
+
+        pointShadowShader_ = context_->createShader(vertexShader, geometryShader, fragmentShader);
+        pointShadowShaderInitialized_ = pointShadowShader_.valid();
 
+        if (pointShadowShaderInitialized_) {
+            CORVUS_GPU_LABEL(pointShadowShader_, "Point Shadow Shader");
+        } else {
+            CORVUS_CORE_ERROR("Failed to create point shadow shader");
+        }
+    }
+
+    return pointShadowShader_;
+}
+
+void LightingSystem::calculateCascades(const Light&     light,
+                                       const glm::mat4& view,
+                                       const glm::mat4& proj) {
+    if (!cascades_.initialized)
+        return;
+
+    float nearPlane, farPlane;
+    depthRangeFromProjection(proj, nearPlane, farPlane);
+    nearPlane              = std::max(nearPlane, 0.01f);
+    farPlane               = std::max(farPlane, nearPlane * 2.0f);
+    const float shadowFar  = std::clamp(light.shadowDistance, nearPlane * 2.0f, farPlane);
+    const float depthRange = farPlane - nearPlane;
+
+    // World space frustum corners, [0, 4) on the near plane and [4, 8) on the far plane
+    std::array<glm::vec3, 8> corners;
+    glm::mat4                invViewProj = glm::inverse(proj * view);
+    for (int i = 0; i < 8; ++i) {
+        glm::vec4 corner = invViewProj
+            * glm::vec4((i & 1) ? 1.0f : -1.0f,
+                        (i & 2) ? 1.0f : -1.0f,
+                        (i & 4) ? 1.0f : -1.0f,
+                        1.0f);
+        corners[i] = glm::vec3(corner) / corner.w;
+    }
+
+    glm::vec3 lightDir = glm::normalize(light.direction);
     glm::vec3 up = (std::abs(glm::dot(lightDir, glm::vec3(0, 1, 0))) > 0.99f) ? glm::vec3(1, 0, 0)
                                                                               : glm::vec3(0, 1, 0);
 
-    glm::mat4 view = glm::lookAt(lightPos, sceneCenter, up);
+    const float halfResolution = static_cast<float>(cascades_.resolution) * 0.5f;
+    const float count          = static_cast<float>(cascades_.cascadeCount);
+
+    float splitNear = nearPlane;
+    for (uint32_t c = 0; c < cascades_.cascadeCount; ++c) {
+        // Practical split scheme, blends logarithmic and uniform splits
+        float p           = static_cast<float>(c + 1) / count;
+        float logSplit    = nearPlane * std::pow(shadowFar / nearPlane, p);
+        float linearSplit = nearPlane + (shadowFar - nearPlane) * p;
+        float splitFar    = glm::mix(linearSplit, logSplit, light.cascadeSplitLambda);
+
+        // Depth is linear along each corner ray, so slice the rays by view distance
+        float     t0 = (splitNear - nearPlane) / depthRange;
+        float     t1 = (splitFar - nearPlane) / depthRange;
+        glm::vec3 slice[8];
+        glm::vec3 center(0.0f);
+        for (int i = 0; i < 4; ++i) {
+            glm::vec3 ray = corners[i + 4] - corners[i];
+            slice[i]      = corners[i] + ray * t0;
+            slice[i + 4]  = corners[i] + ray * t1;
+            center += slice[i] + slice[i + 4];
+        }
+        center /= 8.0f;
 
-    float     half = light.shadowDistance * 0.5f;
-    glm::mat4 proj
-        = glm::ortho(-half, half, -half, half, light.shadowNearPlane, light.shadowFarPlane);
+        // Bounding sphere keeps the cascade size constant while the camera rotates
+        float radius = 0.0f;
+        for (const auto& corner : slice)
+            radius = std::max(radius, glm::length(corner - center));
+        radius = std::ceil(radius * 16.0f) / 16.0f;
 
-    return proj * view;
+        glm::mat4 lightView = glm::lookAt(center - lightDir * radius, center, up);
+        glm::mat4 lightProj
+            = glm::ortho(-radius, radius, -radius, radius, -light.shadowFarPlane, radius * 2.0f);
+
+        // Snap the projection to whole shadow texels so edges do not shimmer as the camera moves
+        glm::vec4 origin = lightProj * lightView * glm::vec4(0.0f, 0.0f, 0.0f, 1.0f);
+        glm::vec2 texel  = glm::vec2(origin) * halfResolution;
+        glm::vec2 offset = (glm::round(texel) - texel) / halfResolution;
+        lightProj[3][0] += offset.x;
+        lightProj[3][1] += offset.y;
+
+        cascades_.lightSpaceMatrices[c] = lightProj * lightView;
+        cascades_.splitDepths[c]        = splitFar;
+        splitNear                       = splitFar;
+    }
+
+    cascades_.bias     = light.shadowBias;
+    cascades_.strength = light.shadowStrength;
+    cascadesActive_    = true;
 }
 
 glm::mat4 LightingSystem::calculateSpotLightMatrix(const Light& light) {
@@ -355,12 +502,177 @@ std::array<glm::mat4, 6> LightingSystem::calculatePointLightMatrices(const glm::
     return matrices;
 }
 
+void LightingSystem::ensureClusterBuffers() {
+    if (clusterGridBuffer_.valid() || !context_)
+        return;
+
+    using Graphics::ImageFormat;
+    clusterLightBuffer_
+        = context_->createTextureBuffer(ImageFormat::RGBA32F, nullptr, sizeof(glm::vec4) * 4);
+    clusterGridBuffer_ = context_->createTextureBuffer(
+        ImageFormat::R32UI, nullptr, CLUSTER_COUNT * 2 * sizeof(uint32_t));
+    clusterIndexBuffer_
+        = context_->createTextureBuffer(ImageFormat::R32UI, nullptr, sizeof(uint32_t));
+    shadowDataBuffer_
+        = context_->createTextureBuffer(ImageFormat::RGBA32F, nullptr, sizeof(glm::vec4) * 7);
+
+    CORVUS_GPU_LABEL(clusterLightBuffer_, "Cluster Lights");
+    CORVUS_GPU_LABEL(clusterGridBuffer_, "Cluster Grid");
+    CORVUS_GPU_LABEL(clusterIndexBuffer_, "Cluster Light Indices");
+    CORVUS_GPU_LABEL(shadowDataBuffer_, "Shadow Data");
+}
+
+void LightingSystem::buildClusters(Graphics::CommandBuffer& cmd,
+                                   const glm::mat4&         view,
+                                   const glm::mat4&         proj) {
+    ensureClusterBuffers();
+    if (!clusterGridBuffer_.valid())
+        return;
+
+    float nearPlane, farPlane;
+    depthRangeFromProjection(proj, nearPlane, farPlane);
+
+    clusterNear_     = std::max(nearPlane, 0.01f);
+    farPlane         = std::max(farPlane, clusterNear_ * 2.0f);
+    clusterLogScale_ = static_cast<float>(CLUSTER_Z) / std::log(farPlane / clusterNear_);
+
+    auto sliceOf = [this](float depth) {
+        float slice = std::floor(std::log(depth / clusterNear_) * clusterLogScale_);
+        return static_cast<uint32_t>(std::clamp(slice, 0.0f, static_cast<float>(CLUSTER_Z - 1)));
+    };
+    auto tileOf = [](float ndc, uint32_t count) {
+        float tile = std::floor((ndc * 0.5f + 0.5f) * static_cast<float>(count));
+        return static_cast<uint32_t>(std::clamp(tile, 0.0f, static_cast<float>(count - 1)));
+    };
+
+    clusterLightTexels_.clear();
+    clusterRanges_.clear();
+    clusterGridTexels_.assign(CLUSTER_COUNT * 2, 0);
+    shadowDataTexels_.clear();
+
+    for (size_t lightIndex = 0; lightIndex < lights_.size(); ++lightIndex) {
+        const Light& light = lights_[lightIndex];
+        if (light.type == LightType::Directional)
+            continue;
+
+        glm::vec3 viewPos = glm::vec3(view * glm::vec4(light.position, 1.0f));
+        float     radius  = light.range;
+        float     depth   = -viewPos.z;
+        if (depth + radius < clusterNear_ || depth - radius > farPlane)
+            continue;
+
+        // Screen bounds of the view space box around the light, clamped in front of the near plane
+        glm::vec2 ndcMin(std::numeric_limits<float>::max());
+        glm::vec2 ndcMax(std::numeric_limits<float>::lowest());
+        for (int corner = 0; corner < 8; ++corner) {
+            glm::vec3 p = viewPos
+                + glm::vec3((corner & 1) ? radius : -radius,
+                            (corner & 2) ? radius : -radius,
+                            (corner & 4) ? radius : -radius);
+            p.z = std::min(p.z, -clusterNear_);
+
+            glm::vec4 clip = proj * glm::vec4(p, 1.0f);
+            glm::vec2 ndc  = glm::vec2(clip) / clip.w;
+            ndcMin         = glm::min(ndcMin, ndc);
+            ndcMax         = glm::max(ndcMax, ndc);
+        }
+
+        if (ndcMax.x < -1.0f || ndcMin.x > 1.0f || ndcMax.y < -1.0f || ndcMin.y > 1.0f)
+            continue;
+
+        ClusterRange range;
+        range.light = static_cast<uint32_t>(clusterLightTexels_.size() / 4);
+        range.minX  = tileOf(ndcMin.x, CLUSTER_X);
+        range.maxX  = tileOf(ndcMax.x, CLUSTER_X);
+        range.minY  = tileOf(ndcMin.y, CLUSTER_Y);
+        range.maxY  = tileOf(ndcMax.y, CLUSTER_Y);
+        range.minZ  = sliceOf(std::max(depth - radius, clusterNear_));
+        range.maxZ  = sliceOf(std::min(depth + radius, farPlane));
+        clusterRanges_.push_back(range);
+
+        // Shadow data layout must match calculateSpotLightShadow/calculatePointLightShadow:
+        // spot is the light matrix, tile rect and (bias, strength), point is six face tile rects
+        // and the far plane
+        bool  spot         = light.type == LightType::Spot;
+        float shadowOffset = -1.0f;
+        if (const ShadowAtlasSlot* slot = getShadowSlot(lightIndex)) {
+            shadowOffset = static_cast<float>(shadowDataTexels_.size());
+            if (spot) {
+                for (int column = 0; column < 4; ++column)
+                    shadowDataTexels_.push_back(slot->lightSpaceMatrix[column]);
+                shadowDataTexels_.push_back(shadowAtlas_.uvRect(slot->tiles[0]));
+                shadowDataTexels_.emplace_back(light.shadowBias, light.shadowStrength, 0.0f, 0.0f);
+            } else {
+                for (uint32_t face = 0; face < 6; ++face)
+                    shadowDataTexels_.push_back(shadowAtlas_.uvRect(slot->tiles[face]));
+                shadowDataTexels_.emplace_back(light.range, 0.0f, 0.0f, 0.0f);
+            }
+        }
+
+        // Layout must match the cluster light fetch in default_lit.frag
+        glm::vec3 color = normalizeColor(light.color) * light.intensity;
+        glm::vec3 dir   = spot ? glm::normalize(light.direction) : glm::vec3(0.0f);
+        clusterLightTexels_.emplace_back(light.position, light.range);
+        clusterLightTexels_.emplace_back(color, spot ? 1.0f : 0.0f);
+        clusterLightTexels_.emplace_back(dir, std::cos(glm::radians(light.innerCutoff)));
+        clusterLightTexels_.emplace_back(
+            std::cos(glm::radians(light.outerCutoff)), shadowOffset, 0.0f, 0.0f);
+
+        for (uint32_t z = range.minZ; z <= range.maxZ; ++z)
+            for (uint32_t y = range.minY; y <= range.maxY; ++y)
+                for (uint32_t x = range.minX; x <= range.maxX; ++x)
+                    clusterGridTexels_[(x + CLUSTER_X * (y + CLUSTER_Y * z)) * 2 + 1]++;
+    }
+
+    // Counts to offsets, then scatter light indices into each cluster's range
+    uint32_t offset = 0;
+    for (uint32_t c = 0; c < CLUSTER_COUNT; ++c) {
+        clusterGridTexels_[c * 2] = offset;
+        offset += clusterGridTexels_[c * 2 + 1];
+        clusterGridTexels_[c * 2 + 1] = 0;
+    }
+
+    clusterIndices_.resize(offset);
+    for (const auto& range : clusterRanges_) {
+        for (uint32_t z = range.minZ; z <= range.maxZ; ++z) {
+            for (uint32_t y = range.minY; y <= range.maxY; ++y) {
+                for (uint32_t x = range.minX; x <= range.maxX; ++x) {
+                    uint32_t  cluster = (x + CLUSTER_X * (y + CLUSTER_Y * z)) * 2;
+                    uint32_t& count   = clusterGridTexels_[cluster + 1];
+                    clusterIndices_[clusterGridTexels_[cluster] + count++] = range.light;
+                }
+            }
+        }
+    }
+
+    // Empty clusters never reference the light and index buffers, leave them as they were
+    clusterGridBuffer_.setData(cmd,
+                               clusterGridTexels_.data(),
+                               static_cast<uint32_t>(clusterGridTexels_.size() * sizeof(uint32_t)));
+    if (!clusterLightTexels_.empty())
+        clusterLightBuffer_.setData(
+            cmd,
+            clusterLightTexels_.data(),
+            static_cast<uint32_t>(clusterLightTexels_.size() * sizeof(glm::vec4)));
+    if (!clusterIndices_.empty())
+        clusterIndexBuffer_.setData(
+            cmd,
+            clusterIndices_.data(),
+            static_cast<uint32_t>(clusterIndices_.size() * sizeof(uint32_t)));
+    if (!shadowDataTexels_.empty())
+        shadowDataBuffer_.setData(
+            cmd,
+            shadowDataTexels_.data(),
+            static_cast<uint32_t>(shadowDataTexels_.size() * sizeof(glm::vec4)));
+}
+
 void LightingSystem::applyLightingUniforms(Graphics::CommandBuffer& cmd,
                                            Graphics::Shader&        shader,
-                                           const glm::vec3&         objectPosition,
-                                           float                    objectRadius,
                                            const glm::vec3&         cameraPosition) {
 
+    static const auto cascadeMatrixNames
+        = indexedUniformNames<CascadedShadowMap::MAX_CASCADES>("u_CascadeMatrices");
+
     // Ambient color - normalize to 0-1 range
     shader.setVec3(cmd, "u_AmbientColor", normalizeColor(ambientColor_));
 
@@ -379,146 +691,75 @@ void LightingSystem::applyLightingUniforms(Graphics::CommandBuffer& cmd,
         shader.setVec3(cmd, "u_DirLightColor", glm::vec3(0.0f));
     }
 
-    // Cull lights for this object
-    auto culled = cullLightsForObject(objectPosition, objectRadius);
-
-    // Point lights
-    shader.setInt(cmd, "u_PointLightCount", static_cast<int>(culled.pointLights.size()));
-    for (size_t i = 0; i < culled.pointLights.size() && i < MAX_LIGHTS; ++i) {
-        const auto* light = culled.pointLights[i];
-
-        std::string base = "u_PointLights[" + std::to_string(i) + "].";
-        shader.setVec3(cmd, (base + "position").c_str(), light->position);
-        // Normalize color before multiplying by intensity
-        shader.setVec3(
-            cmd, (base + "color").c_str(), normalizeColor(light->color) * light->intensity);
-        shader.setFloat(cmd, (base + "range").c_str(), light->range);
-    }
-
-    // Spot lights
-    shader.setInt(cmd, "u_SpotLightCount", static_cast<int>(culled.spotLights.size()));
-    for (size_t i = 0; i < culled.spotLights.size() && i < MAX_LIGHTS; ++i) {
-        const auto* light = culled.spotLights[i];
-
-        std::string base = "u_SpotLights[" + std::to_string(i) + "].";
-        shader.setVec3(cmd, (base + "position").c_str(), light->position);
-        shader.setVec3(cmd, (base + "direction").c_str(), glm::normalize(light->direction));
-        shader.setVec3(
-            cmd, (base + "color").c_str(), normalizeColor(light->color) * light->intensity);
-        shader.setFloat(cmd, (base + "range").c_str(), light->range);
-        shader.setFloat(
-            cmd, (base + "innerCutoff").c_str(), std::cos(glm::radians(light->innerCutoff)));
-        shader.setFloat(
-            cmd, (base + "outerCutoff").c_str(), std::cos(glm::radians(light->outerCutoff)));
-    }
-
-    for (size_t i = 0; i < culled.spotLights.size() && i < MAX_LIGHTS; ++i) {
-        const auto* light       = culled.spotLights[i];
-        int         shadowIndex = -1;
-
-        for (const auto& fullLight : lights_) {
-            if (fullLight.type == LightType::Spot
-                && glm::all(glm::epsilonEqual(fullLight.position, light->position, 0.0001f))) {
-                shadowIndex = fullLight.shadowMapIndex;
-                break;
-            }
-        }
-
-        std::string uniformName = "u_SpotLightShadowIndices[" + std::to_string(i) + "]";
-        shader.setInt(cmd, uniformName.c_str(), shadowIndex);
-    }
-
-    shader.setInt(cmd, "u_PointLightShadowCount", static_cast<int>(cubemapShadows_.size()));
-    for (size_t i = 0; i < cubemapShadows_.size() && i < MAX_POINT_SHADOWS; ++i) {
-        // Find which light this shadow belongs to (you may need to track this when rendering
-        // shadows)
-        const auto&  shadow = cubemapShadows_[i];
-        const Light* light  = nullptr;
-
-        // Find first matching point light (simple fallback)
-        for (const auto& l : lights_) {
-            if (l.type == LightType::Point && l.castShadows) {
-                light = &l;
-                break;
-            }
-        }
-
-        if (light) {
-            shader.setVec3(cmd,
-                           ("u_PointLightShadowPositions[" + std::to_string(i) + "]").c_str(),
-                           light->position);
-            shader.setFloat(cmd,
-                            ("u_PointLightShadowFarPlanes[" + std::to_string(i) + "]").c_str(),
-                            light->range);
-            shader.setInt(cmd, ("u_PointLightShadowIndices[" + std::to_string(i) + "]").c_str(), i);
-        }
-    }
-
-    // Shadow uniforms with proper bias and strength
-    size_t validShadows = 0;
-    for (size_t i = 0; i < shadowMaps_.size() && i < MAX_SHADOW_MAPS; ++i) {
-        if (shadowMaps_[i].initialized) {
-            std::string matrixName = "u_LightSpaceMatrices[" + std::to_string(validShadows) + "]";
-            shader.setMat4(cmd, matrixName.c_str(), shadowMaps_[i].lightSpaceMatrix);
-
-            // Set bias and strength from stored values
-            if (validShadows < shadowBiases_.size()) {
-                std::string biasName = "u_ShadowBias[" + std::to_string(validShadows) + "]";
-                shader.setFloat(cmd, biasName.c_str(), shadowBiases_[validShadows]);
-            }
-
-            if (validShadows < shadowStrengths_.size()) {
-                std::string strengthName = "u_ShadowStrength[" + std::to_string(validShadows) + "]";
-                shader.setFloat(cmd, strengthName.c_str(), shadowStrengths_[validShadows]);
-            }
+    // Point and spot lights are looked up per fragment from the cluster buffers
+    shader.setVec3(cmd, "u_ClusterDims", glm::vec3(CLUSTER_X, CLUSTER_Y, CLUSTER_Z));
+    shader.setFloat(cmd, "u_ClusterNear", clusterNear_);
+    shader.setFloat(cmd, "u_ClusterLogScale", clusterLogScale_);
 
-            validShadows++;
+    // Directional light cascades, selected per fragment by view depth
+    uint32_t cascadeCount = cascadesActive_ ? cascades_.cascadeCount : 0;
+    shader.setInt(cmd, "u_CascadeCount", static_cast<int>(cascadeCount));
+    if (cascadeCount > 0) {
+        glm::vec4 splits(0.0f);
+        for (uint32_t i = 0; i < cascadeCount; ++i) {
+            shader.setMat4(cmd, cascadeMatrixNames[i].c_str(), cascades_.lightSpaceMatrices[i]);
+            splits[i] = cascades_.splitDepths[i];
         }
+        shader.setVec4(cmd, "u_CascadeSplits", splits);
+        shader.setFloat(cmd, "u_CascadeBias", cascades_.bias);
+        shader.setFloat(cmd, "u_CascadeStrength", cascades_.strength);
     }
-    shader.setInt(cmd, "u_ShadowMapCount", static_cast<int>(validShadows));
 }
 
 void LightingSystem::bindShadowTextures(Graphics::CommandBuffer& cmd) {
-    uint32_t textureSlot = 3; // Reserve 0-2 for material textures
-
-    // Directional & spot shadow maps
-    for (size_t i = 0; i < shadowMaps_.size() && i < MAX_SHADOW_MAPS; ++i) {
-        if (shadowMaps_[i].initialized) {
-            std::string uniformName = "u_ShadowMaps[" + std::to_string(i) + "]";
-            cmd.bindTexture(textureSlot, shadowMaps_[i].depthTexture, uniformName.c_str());
-            textureSlot++;
+    // Left unbound the array sampler stays on unit 0 next to the material's sampler2D, and two
+    // sampler types on one unit make the draw invalid even though u_CascadeCount is 0
+    if (cascades_.initialized) {
+        cmd.bindTextureArray(CASCADE_TEXTURE_SLOT, cascades_.depthArray, "u_CascadeShadowMap");
+    } else if (context_) {
+        if (!emptyCascades_.valid()) {
+            emptyCascades_ = context_->createDepthTextureArray(1, 1, 1);
+            CORVUS_GPU_LABEL(emptyCascades_, "Empty Cascades");
         }
+        cmd.bindTextureArray(CASCADE_TEXTURE_SLOT, emptyCascades_, "u_CascadeShadowMap");
     }
 
-    // Point light cubemap shadows
-    for (size_t i = 0; i < cubemapShadows_.size() && i < MAX_POINT_SHADOWS; ++i) {
-        if (cubemapShadows_[i].initialized) {
-            std::string uniformName = "u_PointLightShadowMaps[" + std::to_string(i) + "]";
-            cmd.bindTextureCube(textureSlot, cubemapShadows_[i].depthCubemap, uniformName);
-            textureSlot++;
-        }
-    }
+    if (shadowAtlas_.initialized)
+        cmd.bindTexture(SHADOW_ATLAS_TEXTURE_SLOT, shadowAtlas_.depthTexture, "u_ShadowAtlas");
+    if (shadowDataBuffer_.valid())
+        cmd.bindTextureBuffer(SHADOW_DATA_TEXTURE_SLOT, shadowDataBuffer_, "u_ShadowData");
+}
+
+void LightingSystem::bindClusterTextures(Graphics::CommandBuffer& cmd) {
+    cmd.bindTextureBuffer(CLUSTER_TEXTURE_SLOT, clusterLightBuffer_, "u_ClusterLights");
+    cmd.bindTextureBuffer(CLUSTER_TEXTURE_SLOT + 1, clusterGridBuffer_, "u_ClusterGrid");
+    cmd.bindTextureBuffer(CLUSTER_TEXTURE_SLOT + 2, clusterIndexBuffer_, "u_ClusterIndices");
 }
 
 void LightingSystem::shutdown() {
-    for (auto& sm : shadowMaps_) {
-        sm.cleanup();
-    }
-    shadowMaps_.clear();
+    shadowAtlas_.cleanup();
+    shadowSlots_.clear();
 
-    for (auto& cm : cubemapShadows_) {
-        cm.cleanup();
-    }
-    cubemapShadows_.clear();
+    cascades_.cleanup();
+    cascadesActive_ = false;
+    emptyCascades_.release();
 
     if (shadowShaderInitialized_) {
         shadowShader_.release();
         shadowShaderInitialized_ = false;
     }
 
+    if (pointShadowShaderInitialized_) {
+        pointShadowShader_.release();
+        pointShadowShaderInitialized_ = false;
+    }
+
+    clusterLightBuffer_.release();
+    clusterGridBuffer_.release();
+    clusterIndexBuffer_.release();
+    shadowDataBuffer_.release();
+
     lights_.clear();
-    shadowBiases_.clear();
-    shadowStrengths_.clear();
     initialized_ = false;
     context_     = nullptr;
 }
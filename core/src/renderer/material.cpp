@@ -41,9 +41,11 @@ void Material::setShader(const Shader& shader, bool releaseOld) {
 
 void Material::setRenderState(const RenderState& state) { renderState = state; }
 
-void Material::bind(CommandBuffer& cmd) {
+void Material::bind(CommandBuffer& cmd) { bind(cmd, shader); }
+
+void Material::bind(CommandBuffer& cmd, Shader& variant) {
     // Bind shader
-    cmd.setShader(shader);
+    cmd.setShader(variant);
 
     // Set render state
     cmd.setDepthTest(renderState.depthTest);
@@ -57,17 +59,17 @@ void Material::bind(CommandBuffer& cmd) {
             [&]<typename T0>(T0&& arg) {
                 using T = std::decay_t<T0>;
                 if constexpr (std::is_same_v<T, int>) {
-                    shader.setInt(cmd, name.c_str(), arg);
+                    variant.setInt(cmd, name.c_str(), arg);
                 } else if constexpr (std::is_same_v<T, float>) {
-                    shader.setFloat(cmd, name.c_str(), arg);
+                    variant.setFloat(cmd, name.c_str(), arg);
                 } else if constexpr (std::is_same_v<T, glm::vec2>) {
-                    shader.setVec2(cmd, name.c_str(), arg);
+                    variant.setVec2(cmd, name.c_str(), arg);
                 } else if constexpr (std::is_same_v<T, glm::vec3>) {
-                    shader.setVec3(cmd, name.c_str(), arg);
+                    variant.setVec3(cmd, name.c_str(), arg);
                 } else if constexpr (std::is_same_v<T, glm::vec4>) {
-                    shader.setVec4(cmd, name.c_str(), arg);
+                    variant.setVec4(cmd, name.c_str(), arg);
                 } else if constexpr (std::is_same_v<T, glm::mat4>) {
-                    shader.setMat4(cmd, name.c_str(), arg);
+                    variant.setMat4(cmd, name.c_str(), arg);
                 }
             },
             value);
@@ -5,6 +5,22 @@
 
 namespace Corvus::Renderer {
 
+namespace {
+    std::string readShaderSource(const char* path) {
+        auto bytes = Core::StaticResourceFile::create(path)->readAllBytes();
+        return std::string(bytes.begin(), bytes.end());
+    }
+
+    // Enable a variant's #ifdef blocks, the define has to come after the #version line
+    std::string withDefine(const std::string& source, const char* define) {
+        const size_t lineEnd = source.find('\n');
+        if (lineEnd == std::string::npos)
+            return source;
+        return source.substr(0, lineEnd + 1) + "#define " + define + "\n"
+            + source.substr(lineEnd + 1);
+    }
+}
+
 MaterialRenderer::MaterialRenderer(Graphics::GraphicsContext& ctx) : context(ctx) {
     initializeDefaults();
 }
@@ -12,6 +28,9 @@ MaterialRenderer::MaterialRenderer(Graphics::GraphicsContext& ctx) : context(ctx
 MaterialRenderer::~MaterialRenderer() {
     if (defaultsInitialized) {
         defaultShader.release();
+        for (auto& variant : defaultVariants)
+            variant.release();
+        deferredLightingShader.release();
         defaultTexture.release();
     }
 }
@@ -21,25 +40,62 @@ void MaterialRenderer::initializeDefaults() {
         return;
 
     // Load default shader
-    auto vsBytes
-        = Core::StaticResourceFile::create("engine/shaders/default_lit.vert")->readAllBytes();
-    auto fsBytes
-        = Core::StaticResourceFile::create("engine/shaders/default_lit.frag")->readAllBytes();
-    const std::string vsSrc(vsBytes.begin(), vsBytes.end());
-    const std::string fsSrc(fsBytes.begin(), fsBytes.end());
+    const std::string vsSrc = readShaderSource("engine/shaders/default_lit.vert");
+    const std::string fsSrc = readShaderSource("engine/shaders/default_lit.frag");
 
     defaultShader = context.createShader(vsSrc, fsSrc);
 
     if (defaultShader.valid()) {
+        CORVUS_GPU_LABEL(defaultShader, "Default Lit Shader");
         CORVUS_CORE_INFO("Loaded default shader");
     } else {
         CORVUS_CORE_ERROR("Failed to load default shader");
     }
 
+    // Same fragment stage, transforms come from the instance buffer
+    const std::string instancedSrc = readShaderSource("engine/shaders/default_lit_instanced.vert");
+    const std::string gbufferSrc   = withDefine(fsSrc, "GBUFFER_PASS");
+    const std::string weightedSrc  = withDefine(fsSrc, "WEIGHTED_BLENDED");
+
+    const auto createVariant = [&](ShaderVariant      variant,
+                                   const std::string& vs,
+                                   const std::string& fs,
+                                   const char*        label) {
+        Shader& shader = defaultVariants[static_cast<size_t>(variant)];
+        shader         = context.createShader(vs, fs);
+        CORVUS_GPU_LABEL(shader, label);
+        return shader.valid();
+    };
+
+    bool variantsValid = createVariant(
+        ShaderVariant::Instanced, instancedSrc, fsSrc, "Default Lit Instanced Shader");
+    variantsValid &= createVariant(
+        ShaderVariant::GBuffer, vsSrc, gbufferSrc, "Default Lit GBuffer Shader");
+    variantsValid &= createVariant(ShaderVariant::GBufferInstanced,
+                                   instancedSrc,
+                                   gbufferSrc,
+                                   "Default Lit GBuffer Instanced Shader");
+    variantsValid &= createVariant(
+        ShaderVariant::WeightedBlended, vsSrc, weightedSrc, "Default Lit Weighted Blended Shader");
+    variantsValid &= createVariant(ShaderVariant::WeightedBlendedInstanced,
+                                   instancedSrc,
+                                   weightedSrc,
+                                   "Default Lit Weighted Blended Instanced Shader");
+
+    const std::string fullscreenSrc = readShaderSource("engine/shaders/fullscreen.vert");
+    deferredLightingShader
+        = context.createShader(fullscreenSrc, withDefine(fsSrc, "DEFERRED_LIGHTING"));
+    CORVUS_GPU_LABEL(deferredLightingShader, "Deferred Lighting Shader");
+
+    if (!variantsValid || !deferredLightingShader.valid()) {
+        CORVUS_CORE_ERROR("Failed to load default shader variants");
+    }
+
     // Create 1x1 white texture
     defaultTexture             = context.createTexture2D(1, 1);
     constexpr uint8_t pixel[4] = { 255, 255, 255, 255 };
     defaultTexture.setData(pixel, sizeof(pixel));
+    CORVUS_GPU_LABEL(defaultTexture, "Default White Texture");
 
     CORVUS_CORE_INFO("Created default white texture");
 
@@ -58,6 +114,12 @@ Texture2D& MaterialRenderer::getDefaultTexture() {
     return defaultTexture;
 }
 
+Shader& MaterialRenderer::getDeferredLightingShader() {
+    if (!defaultsInitialized)
+        initializeDefaults();
+    return deferredLightingShader;
+}
+
 // Apply low-level Material
 Shader* MaterialRenderer::apply(Material& material, CommandBuffer& cmd) {
 
@@ -88,6 +150,29 @@ Shader* MaterialRenderer::apply(Material& material, CommandBuffer& cmd) {
     return shader;
 }
 
+Shader*
+MaterialRenderer::applyVariant(Material& material, CommandBuffer& cmd, ShaderVariant variant) {
+    if (!supportsVariant(material, variant))
+        return nullptr;
+
+    Shader& shader = defaultVariants[static_cast<size_t>(variant)];
+    material.bind(cmd, shader);
+
+    if (!material.getTextures().contains(0)) {
+        cmd.bindTexture(0, getDefaultTexture());
+    }
+
+    return &shader;
+}
+
+bool MaterialRenderer::supportsVariant(const Material& material, ShaderVariant variant) const {
+    return defaultVariants[static_cast<size_t>(variant)].valid() && usesDefaultShader(material);
+}
+
+bool MaterialRenderer::usesDefaultShader(const Material& material) const {
+    return defaultShader.valid() && material.getShaderId() == defaultShader.id;
+}
+
 // Convert MaterialAsset and apply
 Shader* MaterialRenderer::apply(const Core::MaterialAsset& materialAsset,
                                 CommandBuffer&             cmd,
@@ -70,8 +70,10 @@ Mesh Mesh::createFromVerticesColor(GraphicsContext&                ctx,
 
 void Mesh::updateVertices(CommandBuffer& cmd, const void* data, uint32_t size) {
     vbo.setData(cmd, data, size);
-    if (!vertices.empty() && size == vertices.size() * sizeof(Vertex))
+    if (!vertices.empty() && size == vertices.size() * sizeof(Vertex)) {
         std::memcpy(vertices.data(), data, size);
+        boundingRadius = -1.0f;
+    }
 }
 
 void Mesh::updateIndices(CommandBuffer& cmd, const void* data, uint32_t count, bool index16) {
@@ -89,13 +91,23 @@ void Mesh::draw(CommandBuffer& cmd, bool wireframe) const {
     cmd.drawIndexed(indexCount, index16, 0, prim);
 }
 
+void Mesh::drawInstanced(CommandBuffer& cmd, uint32_t instanceCount, bool wireframe) const {
+    cmd.setVertexArray(vao);
+    PrimitiveType prim = wireframe ? PrimitiveType::Lines : primitiveType;
+    cmd.drawIndexedInstanced(indexCount, index16, instanceCount, 0, prim);
+}
+
 float Mesh::getBoundingRadius() const {
     if (vertices.empty())
         return 0.0f;
+    if (boundingRadius >= 0.0f)
+        return boundingRadius;
+
     float maxDist2 = 0.0f;
     for (const auto& v : vertices)
         maxDist2 = std::max(maxDist2, glm::dot(v.position, v.position));
-    return std::sqrt(maxDist2);
+    boundingRadius = std::sqrt(maxDist2);
+    return boundingRadius;
 }
 
 glm::vec3 Mesh::getBoundingBoxMin() const {
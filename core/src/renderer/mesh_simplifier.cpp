@@ -0,0 +1,370 @@
+#include "corvus/renderer/mesh_simplifier.hpp"
+
+#include "corvus/jobs/job_system.hpp"
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <queue>
+#include <unordered_map>
+
+namespace Corvus::Renderer::MeshSimplifier {
+
+namespace {
+    // Symmetric 4x4 plane quadric, upper triangle row by row
+    struct Quadric {
+        std::array<double, 10> m {};
+
+        // Plane ax + by + cz + d = 0 with a unit normal
+        void addPlane(double a, double b, double c, double d) {
+            m[0] += a * a;
+            m[1] += a * b;
+            m[2] += a * c;
+            m[3] += a * d;
+            m[4] += b * b;
+            m[5] += b * c;
+            m[6] += b * d;
+            m[7] += c * c;
+            m[8] += c * d;
+            m[9] += d * d;
+        }
+
+        Quadric& operator+=(const Quadric& other) {
+            for (size_t i = 0; i < m.size(); ++i)
+                m[i] += other.m[i];
+            return *this;
+        }
+
+        // Sum of squared distances from the point to every accumulated plane
+        double error(const glm::vec3& point) const {
+            const double x = point.x, y = point.y, z = point.z;
+            return m[0] * x * x + 2.0 * m[1] * x * y + 2.0 * m[2] * x * z + 2.0 * m[3] * x
+                 + m[4] * y * y + 2.0 * m[5] * y * z + 2.0 * m[6] * y + m[7] * z * z
+                 + 2.0 * m[8] * z + m[9];
+        }
+    };
+
+    struct Collapse {
+        double   cost;
+        uint32_t from, to;
+        uint32_t fromVersion, toVersion;
+
+        bool operator>(const Collapse& other) const { return cost > other.cost; }
+    };
+
+    struct PositionHash {
+        size_t operator()(const glm::vec3& p) const {
+            uint32_t bits[3];
+            std::memcpy(bits, &p, sizeof(bits));
+            size_t hash = bits[0];
+            hash ^= bits[1] + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+            hash ^= bits[2] + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+            return hash;
+        }
+    };
+
+    uint64_t edgeKey(uint32_t a, uint32_t b) {
+        return (static_cast<uint64_t>(std::min(a, b)) << 32) | std::max(a, b);
+    }
+
+    float meshRadius(const std::vector<Vertex>& vertices) {
+        glm::vec3 boundsMin(std::numeric_limits<float>::max());
+        glm::vec3 boundsMax(std::numeric_limits<float>::lowest());
+        for (const auto& vertex : vertices) {
+            boundsMin = glm::min(boundsMin, vertex.position);
+            boundsMax = glm::max(boundsMax, vertex.position);
+        }
+        return vertices.empty() ? 0.0f : glm::distance(boundsMin, boundsMax) * 0.5f;
+    }
+}
+
+bool simplify(const std::vector<Vertex>&   vertices,
+              const std::vector<uint32_t>& indices,
+              size_t                       targetIndexCount,
+              float                        maxError,
+              std::vector<Vertex>&         outVertices,
+              std::vector<uint32_t>&       outIndices) {
+    outVertices.clear();
+    outIndices.clear();
+
+    const size_t triangleCount = indices.size() / 3;
+    if (triangleCount == 0 || indices.size() <= targetIndexCount)
+        return false;
+
+    // Weld vertices sharing a position into groups, the topology works on groups so attribute
+    // seams do not tear open
+    std::vector<uint32_t>                                 vertexGroup(vertices.size());
+    std::vector<glm::vec3>                                positions;
+    std::vector<std::vector<uint32_t>>                    groupVertices;
+    std::unordered_map<glm::vec3, uint32_t, PositionHash> groupOf;
+    for (uint32_t i = 0; i < vertices.size(); ++i) {
+        auto [it, inserted] = groupOf.try_emplace(vertices[i].position,
+                                                  static_cast<uint32_t>(positions.size()));
+        if (inserted) {
+            positions.push_back(vertices[i].position);
+            groupVertices.emplace_back();
+        }
+        vertexGroup[i] = it->second;
+        groupVertices[it->second].push_back(i);
+    }
+
+    const auto groupCount = static_cast<uint32_t>(positions.size());
+
+    std::vector<std::array<uint32_t, 3>>   triangles(triangleCount);
+    std::vector<uint8_t>                   triangleAlive(triangleCount, 1);
+    std::vector<std::vector<uint32_t>>     groupTriangles(groupCount);
+    std::vector<Quadric>                   quadrics(groupCount);
+    std::unordered_map<uint64_t, uint32_t> edgeUses;
+    size_t                                 aliveCount = 0;
+
+    for (uint32_t t = 0; t < triangleCount; ++t) {
+        auto& tri = triangles[t];
+        for (uint32_t k = 0; k < 3; ++k)
+            tri[k] = vertexGroup[indices[t * 3 + k]];
+
+        if (tri[0] == tri[1] || tri[1] == tri[2] || tri[0] == tri[2]) {
+            triangleAlive[t] = 0;
+            continue;
+        }
+        ++aliveCount;
+
+        const glm::vec3 normal = glm::cross(positions[tri[1]] - positions[tri[0]],
+                                            positions[tri[2]] - positions[tri[0]]);
+        const float     length = glm::length(normal);
+        Quadric         plane;
+        if (length > 0.0f) {
+            const glm::vec3 n = normal / length;
+            plane.addPlane(n.x, n.y, n.z, -glm::dot(n, positions[tri[0]]));
+        }
+
+        for (uint32_t k = 0; k < 3; ++k) {
+            quadrics[tri[k]] += plane;
+            groupTriangles[tri[k]].push_back(t);
+            edgeUses[edgeKey(tri[k], tri[(k + 1) % 3])]++;
+        }
+    }
+
+    // Moving a border or non-manifold vertex would shrink holes and silhouettes
+    std::vector<uint8_t> locked(groupCount, 0);
+    for (const auto& [key, uses] : edgeUses) {
+        if (uses != 2) {
+            locked[static_cast<uint32_t>(key >> 32)] = 1;
+            locked[static_cast<uint32_t>(key)]       = 1;
+        }
+    }
+
+    std::vector<uint32_t> version(groupCount, 0);
+    std::vector<uint8_t>  removed(groupCount, 0);
+    std::priority_queue<Collapse, std::vector<Collapse>, std::greater<>> queue;
+
+    const auto pushCollapse = [&](uint32_t from, uint32_t to) {
+        if (locked[from])
+            return;
+        Quadric combined = quadrics[from];
+        combined += quadrics[to];
+        queue.push({ combined.error(positions[to]), from, to, version[from], version[to] });
+    };
+
+    for (const auto& [key, uses] : edgeUses) {
+        const auto a = static_cast<uint32_t>(key >> 32);
+        const auto b = static_cast<uint32_t>(key);
+        pushCollapse(a, b);
+        pushCollapse(b, a);
+    }
+
+    const size_t targetTriangles = targetIndexCount / 3;
+    const double maxCost         = static_cast<double>(maxError) * maxError;
+    bool         changed         = false;
+
+    while (aliveCount > targetTriangles && !queue.empty()) {
+        const Collapse collapse = queue.top();
+        queue.pop();
+
+        const uint32_t from = collapse.from;
+        const uint32_t to   = collapse.to;
+        if (removed[from] || removed[to] || version[from] != collapse.fromVersion
+            || version[to] != collapse.toVersion)
+            continue;
+
+        // Cheapest remaining collapse is already too coarse
+        if (collapse.cost > maxCost)
+            break;
+
+        // Reject collapses that would fold a neighbouring triangle over
+        bool flips = false;
+        for (const uint32_t t : groupTriangles[from]) {
+            const auto& tri = triangles[t];
+            if (!triangleAlive[t] || tri[0] == to || tri[1] == to || tri[2] == to)
+                continue;
+
+            std::array<glm::vec3, 3> corners {};
+            for (uint32_t k = 0; k < 3; ++k)
+                corners[k] = positions[tri[k]];
+            const glm::vec3 before = glm::cross(corners[1] - corners[0], corners[2] - corners[0]);
+            for (uint32_t k = 0; k < 3; ++k) {
+                if (tri[k] == from)
+                    corners[k] = positions[to];
+            }
+            const glm::vec3 after = glm::cross(corners[1] - corners[0], corners[2] - corners[0]);
+
+            if (glm::dot(before, after) <= 0.2f * glm::length(before) * glm::length(after)) {
+                flips = true;
+                break;
+            }
+        }
+        if (flips)
+            continue;
+
+        removed[from] = 1;
+        quadrics[to] += quadrics[from];
+        ++version[to];
+        changed = true;
+
+        for (const uint32_t t : groupTriangles[from]) {
+            if (!triangleAlive[t])
+                continue;
+
+            auto& tri = triangles[t];
+            for (uint32_t k = 0; k < 3; ++k) {
+                if (tri[k] == from)
+                    tri[k] = to;
+            }
+
+            if (tri[0] == tri[1] || tri[1] == tri[2] || tri[0] == tri[2]) {
+                triangleAlive[t] = 0;
+                --aliveCount;
+            } else {
+                groupTriangles[to].push_back(t);
+            }
+        }
+        groupTriangles[from].clear();
+
+        // Edges around the merged vertex changed cost
+        for (const uint32_t t : groupTriangles[to]) {
+            if (!triangleAlive[t])
+                continue;
+            for (const uint32_t neighbour : triangles[t]) {
+                if (neighbour != to) {
+                    pushCollapse(to, neighbour);
+                    pushCollapse(neighbour, to);
+                }
+            }
+        }
+    }
+
+    if (!changed)
+        return false;
+
+    // Corners that moved take the vertex of their new position closest in normal and UV
+    std::vector<uint32_t> remap(vertices.size(), std::numeric_limits<uint32_t>::max());
+    for (uint32_t t = 0; t < triangleCount; ++t) {
+        if (!triangleAlive[t])
+            continue;
+
+        for (uint32_t k = 0; k < 3; ++k) {
+            const uint32_t original = indices[t * 3 + k];
+            uint32_t       chosen   = original;
+
+            if (vertexGroup[original] != triangles[t][k]) {
+                const Vertex& source = vertices[original];
+                float         best   = std::numeric_limits<float>::max();
+                for (const uint32_t candidate : groupVertices[triangles[t][k]]) {
+                    const Vertex&   target = vertices[candidate];
+                    const glm::vec3 dn     = target.normal - source.normal;
+                    const glm::vec2 duv    = target.texCoord - source.texCoord;
+                    const float     metric = glm::dot(dn, dn) + glm::dot(duv, duv);
+                    if (metric < best) {
+                        best   = metric;
+                        chosen = candidate;
+                    }
+                }
+            }
+
+            if (remap[chosen] == std::numeric_limits<uint32_t>::max()) {
+                remap[chosen] = static_cast<uint32_t>(outVertices.size());
+                outVertices.push_back(vertices[chosen]);
+            }
+            outIndices.push_back(remap[chosen]);
+        }
+    }
+
+    return true;
+}
+
+void generateLods(GraphicsContext& ctx, Model& model, const LodSettings& settings) {
+    model.clearLods();
+
+    const uint32_t   levels   = std::min(settings.levels, Model::MAX_LODS - 1);
+    float            coverage = settings.screenCoverage;
+    Core::JobSystem& jobs     = Core::JobSystem::get();
+
+    for (uint32_t level = 1; level <= levels; ++level) {
+        const auto& previous = model.getLodMeshes(level - 1);
+
+        // Meshes simplify on workers, the uploads wait for all of them on this thread. Handing them
+        // to the main thread instead would deadlock a call from a worker waiting on them.
+        std::vector<std::shared_ptr<Mesh>> reduced(previous.size());
+        std::vector<std::vector<Vertex>>   reducedVertices(previous.size());
+        std::vector<std::vector<uint32_t>> reducedIndices(previous.size());
+        Core::JobCounter                   counter;
+
+        for (size_t m = 0; m < previous.size(); ++m) {
+            const auto& mesh = previous[m];
+
+            // Only CPU side triangle lists can be simplified, anything else is kept as is
+            if (!mesh || !mesh->valid() || mesh->getPrimitiveType() != PrimitiveType::Triangles
+                || mesh->hasColors() || mesh->getIndices().size() != mesh->getIndexCount())
+                continue;
+
+            jobs.run(counter, [&, m] {
+                const auto&  vertices = previous[m]->getVertices();
+                const auto&  source   = previous[m]->getIndices();
+                const size_t target   = static_cast<size_t>(
+                    static_cast<float>(source.size() / 3) * settings.reduction) * 3;
+
+                if (!simplify(vertices,
+                              source,
+                              target,
+                              settings.maxError * meshRadius(vertices),
+                              reducedVertices[m],
+                              reducedIndices[m]))
+                    reducedIndices[m].clear();
+            });
+        }
+        jobs.wait(counter);
+
+        for (size_t m = 0; m < previous.size(); ++m) {
+            if (!reducedIndices[m].empty())
+                reduced[m] = std::make_shared<Mesh>(
+                    Mesh::createFromVertices(ctx, reducedVertices[m], reducedIndices[m]));
+        }
+
+        std::vector<std::shared_ptr<Mesh>> lodMeshes;
+        size_t                             previousIndices = 0;
+        size_t                             reducedCount    = 0;
+        for (size_t m = 0; m < previous.size(); ++m) {
+            if (!previous[m] || !previous[m]->valid())
+                continue;
+
+            const auto& mesh = reduced[m] ? reduced[m] : previous[m];
+            previousIndices += previous[m]->getIndexCount();
+            reducedCount += mesh->getIndexCount();
+            lodMeshes.push_back(mesh);
+        }
+
+        // Not worth a level if the error bound stopped it from removing much
+        if (reducedCount * 10 > previousIndices * 9) {
+            for (auto& mesh : reduced) {
+                if (mesh)
+                    mesh->release();
+            }
+            break;
+        }
+
+        model.addLod(std::move(lodMeshes), coverage);
+        coverage *= 0.5f;
+    }
+}
+
+}
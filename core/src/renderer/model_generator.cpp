@@ -180,4 +180,20 @@ Model createCylinder(Graphics::GraphicsContext& ctx, float radius, float height,
     return model;
 }
 
+Model createFullscreenTriangle(Graphics::GraphicsContext& ctx) {
+    Model model;
+
+    // Overshoots the screen so a single triangle covers it without a diagonal seam
+    const std::vector<Vertex> vertices = {
+        { { -1, -1, 0 }, { 0, 0, 1 }, { 0, 0 } },
+        { { 3, -1, 0 }, { 0, 0, 1 }, { 2, 0 } },
+        { { -1, 3, 0 }, { 0, 0, 1 }, { 0, 2 } },
+    };
+    std::vector<uint32_t> indices = { 0, 1, 2 };
+
+    auto mesh = Mesh::createFromVertices(ctx, vertices, indices);
+    model.addMesh(std::move(mesh));
+    return model;
+}
+
 }
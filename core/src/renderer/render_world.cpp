@@ -0,0 +1,455 @@
+#include "corvus/renderer/render_world.hpp"
+
+#include "corvus/jobs/job_system.hpp"
+#include <algorithm>
+#include <atomic>
+#include <utility>
+
+namespace Corvus::Renderer {
+
+namespace {
+    // Moved proxies per job, each only touches its own entries
+    constexpr size_t TRANSFORM_GRAIN = 1024;
+
+    void placeLight(Light& light, const Core::Components::WorldTransformComponent& transform) {
+        light.position  = transform.getPosition();
+        light.direction = glm::normalize(glm::vec3(transform.matrix * glm::vec4(0, 0, -1, 0)));
+    }
+
+    // Bounding radius is in mesh space, scale it to stay conservative
+    float scaledRadius(const float                                     localRadius,
+                       const Core::Components::WorldTransformComponent& transform) {
+        const glm::vec3 scale = transform.getScale();
+        return localRadius * std::max(scale.x, std::max(scale.y, scale.z));
+    }
+
+    void sortUnique(std::vector<entt::entity>& entities) {
+        std::sort(entities.begin(), entities.end());
+        entities.erase(std::unique(entities.begin(), entities.end()), entities.end());
+    }
+}
+
+RenderWorld::RenderWorld(GraphicsContext& context, MaterialRenderer& materialRenderer)
+    : context_(context), materialRenderer_(materialRenderer) { }
+
+RenderWorld::~RenderWorld() { detach(); }
+
+template <typename Component, auto OnUpdate>
+void RenderWorld::connect(entt::registry& registry) {
+    registry.on_construct<Component>().template connect<&RenderWorld::onChanged>(*this);
+    registry.on_update<Component>().template connect<OnUpdate>(*this);
+    registry.on_destroy<Component>().template connect<&RenderWorld::onChanged>(*this);
+}
+
+template <typename Component>
+void RenderWorld::disconnect(entt::registry& registry) {
+    registry.on_construct<Component>().disconnect(*this);
+    registry.on_update<Component>().disconnect(*this);
+    registry.on_destroy<Component>().disconnect(*this);
+}
+
+void RenderWorld::attach(entt::registry& registry) {
+    detach();
+    registry_ = &registry;
+
+    connect<Core::Components::MeshRendererComponent>(registry);
+    connect<Core::Components::LightComponent>(registry);
+    connect<Core::Components::DisabledTag>(registry);
+    connect<Core::Components::WorldTransformComponent, &RenderWorld::onMoved>(registry);
+
+    // Created up front so the pools are arranged once here, not on the first frame that reads them
+    meshGroup();
+    lightGroup();
+
+    markAllDirty();
+}
+
+void RenderWorld::detach() {
+    if (registry_) {
+        disconnect<Core::Components::MeshRendererComponent>(*registry_);
+        disconnect<Core::Components::LightComponent>(*registry_);
+        disconnect<Core::Components::DisabledTag>(*registry_);
+        disconnect<Core::Components::WorldTransformComponent>(*registry_);
+        registry_ = nullptr;
+    }
+
+    dirty_.clear();
+    moved_.clear();
+    awaiting_.clear();
+    meshes_.clear();
+    renderables_.clear();
+    renderableOwners_.clear();
+    staticMeshes_.clear();
+    staticOwners_.clear();
+    staticHoles_ = 0;
+    lightIndices_.clear();
+    lights_.clear();
+    lightOwners_.clear();
+    materialRefs_.clear();
+
+    // The next update drops the chunks of the old registry
+    staticChanged_ = true;
+}
+
+void RenderWorld::markAllDirty() {
+    if (!registry_)
+        return;
+
+    // Disabled entities only need visiting when they still own a proxy, which the loops below add
+    for (const auto entity : meshGroup())
+        dirty_.push_back(entity);
+    for (const auto entity : lightGroup())
+        dirty_.push_back(entity);
+    for (const auto& [entity, proxy] : meshes_)
+        dirty_.push_back(entity);
+    dirty_.insert(dirty_.end(), lightOwners_.begin(), lightOwners_.end());
+
+    staticChanged_ = true;
+}
+
+void RenderWorld::onChanged(entt::registry&, const entt::entity entity) {
+    std::lock_guard lock(observerMutex_);
+    dirty_.push_back(entity);
+}
+
+void RenderWorld::onMoved(entt::registry&, const entt::entity entity) {
+    std::lock_guard lock(observerMutex_);
+    moved_.push_back(entity);
+}
+
+void RenderWorld::update(Core::AssetManager* assetManager, StaticBatcher* staticBatcher) {
+    proxiesUpdated_ = 0;
+    staticUpdated_  = false;
+    if (!registry_)
+        return;
+
+    // Deleted or reloaded assets leave the proxies' model and material pointers stale, and the
+    // chunks built from reloaded models, so nothing below may touch them before this
+    if (assetManager && assetManager->getDataGeneration() != assetGeneration_) {
+        assetGeneration_ = assetManager->getDataGeneration();
+        if (staticBatcher)
+            staticBatcher->invalidate();
+        markAllDirty();
+    }
+
+    dirty_.insert(dirty_.end(), awaiting_.begin(), awaiting_.end());
+    awaiting_.clear();
+    sortUnique(dirty_);
+    sortUnique(moved_);
+
+    // Chunk renderables sit after the dynamic proxies, drop them while proxies come and go
+    bool appendChunks = !dirty_.empty() || staticChanged_;
+    if (appendChunks)
+        renderables_.resize(renderableOwners_.size());
+
+    for (const auto entity : dirty_) {
+        if (!refresh(entity, assetManager, staticBatcher != nullptr))
+            awaiting_.push_back(entity);
+    }
+    proxiesUpdated_ = static_cast<uint32_t>(dirty_.size());
+
+    // Fully refreshed entities already have their new transform
+    moved_.erase(std::remove_if(moved_.begin(),
+                                moved_.end(),
+                                [this](const entt::entity entity) {
+                                    return std::binary_search(dirty_.begin(), dirty_.end(), entity);
+                                }),
+                 moved_.end());
+    proxiesUpdated_ += static_cast<uint32_t>(moved_.size());
+
+    std::atomic<bool> staticMoved { false };
+    Core::JobSystem::get().parallelFor(
+        0, moved_.size(), TRANSFORM_GRAIN, [&](const size_t first, const size_t last) {
+            for (size_t i = first; i < last; ++i) {
+                if (refreshTransform(moved_[i]))
+                    staticMoved.store(true, std::memory_order_relaxed);
+            }
+        });
+    if (staticMoved.load(std::memory_order_relaxed))
+        staticChanged_ = true;
+
+    dirty_.clear();
+    moved_.clear();
+    compactStatic();
+
+    // Cheap for materials that were not edited, edited ones rebuild their runtime material here
+    if (assetManager) {
+        for (const auto& [asset, refs] : materialRefs_)
+            materialRenderer_.getMaterialFromAsset(*asset, assetManager);
+    }
+
+    if (staticChanged_ && staticBatcher) {
+        // Only chunks whose meshes were added, removed or edited get rebuilt
+        staticBatcher->update(staticMeshes_);
+        staticUpdated_ = true;
+        appendChunks   = true;
+    }
+    staticChanged_ = false;
+
+    if (appendChunks) {
+        renderables_.resize(renderableOwners_.size());
+        if (staticBatcher)
+            staticBatcher->appendRenderables(renderables_);
+    }
+}
+
+bool RenderWorld::refresh(const entt::entity  entity,
+                          Core::AssetManager* assetManager,
+                          const bool          batchStatic) {
+    using namespace Core::Components;
+
+    const bool alive = registry_->valid(entity);
+
+    if (auto lights = lightGroup(); alive && lights.contains(entity))
+        refreshLight(entity,
+                     &lights.get<LightComponent>(entity),
+                     &lights.get<WorldTransformComponent>(entity));
+    else
+        removeLight(entity);
+
+    auto meshes = meshGroup();
+    if (!alive || !meshes.contains(entity)) {
+        removeMesh(entity);
+        return true;
+    }
+
+    auto&       meshRenderer = meshes.get<MeshRendererComponent>(entity);
+    const auto& transform    = meshes.get<WorldTransformComponent>(entity);
+
+    auto*     model         = meshRenderer.getModel(assetManager, &context_);
+    auto*     materialAsset = meshRenderer.getMaterial(assetManager);
+    Material* material      = nullptr;
+    if (materialAsset)
+        material = materialRenderer_.getMaterialFromAsset(*materialAsset, assetManager);
+
+    // A handle naming an asset the manager could not load yet resolves to a fallback, keep
+    // retrying it instead of waiting for an edit
+    const bool loaded = (meshRenderer.primitiveType != Core::Components::PrimitiveType::Model
+                         || !meshRenderer.modelHandle.isValid()
+                         || meshRenderer.modelHandle.isLoaded())
+        && (!meshRenderer.materialHandle.isValid() || meshRenderer.materialHandle.isLoaded());
+
+    if (!model || !model->valid() || !material) {
+        removeMesh(entity);
+        return loaded;
+    }
+
+    const bool isStatic = batchStatic && meshRenderer.isStatic && !meshRenderer.renderWireframe
+        && StaticBatcher::canBatch(*model);
+
+    // Changing between static and dynamic moves the proxy to the other list
+    if (const auto it = meshes_.find(entity);
+        it != meshes_.end() && it->second.isStatic != isStatic)
+        removeMesh(entity);
+
+    auto [it, inserted] = meshes_.try_emplace(entity);
+    MeshProxy& proxy    = it->second;
+    proxy.isStatic      = isStatic;
+    proxy.localRadius   = meshRenderer.getBoundingRadius();
+
+    if (proxy.materialAsset != materialAsset) {
+        releaseMaterial(proxy.materialAsset);
+        retainMaterial(materialAsset);
+        proxy.materialAsset = materialAsset;
+    }
+
+    if (isStatic) {
+        const StaticMeshInstance instance { static_cast<uint32_t>(entity),
+                                            model,
+                                            material,
+                                            transform.matrix,
+                                            meshRenderer.castShadows };
+        if (inserted) {
+            proxy.index = static_cast<uint32_t>(staticMeshes_.size());
+            staticMeshes_.push_back(instance);
+            staticOwners_.push_back(entity);
+            staticChanged_ = true;
+        } else if (!(staticMeshes_[proxy.index] == instance)) {
+            staticMeshes_[proxy.index] = instance;
+            staticChanged_             = true;
+        }
+        return loaded;
+    }
+
+    if (inserted) {
+        proxy.index = static_cast<uint32_t>(renderableOwners_.size());
+        renderables_.emplace_back();
+        renderableOwners_.push_back(entity);
+    }
+
+    Renderable& renderable    = renderables_[proxy.index];
+    renderable.model          = model;
+    renderable.material       = material;
+    renderable.transform      = transform.matrix;
+    renderable.position       = transform.getPosition();
+    renderable.boundingRadius = scaledRadius(proxy.localRadius, transform);
+    renderable.wireframe      = meshRenderer.renderWireframe;
+    renderable.castShadows    = meshRenderer.castShadows;
+    renderable.enabled        = true;
+    renderable.id             = static_cast<uint64_t>(entity) + 1;
+    return loaded;
+}
+
+bool RenderWorld::refreshTransform(const entt::entity entity) {
+    // Runs on workers, only reads the registry and writes this entity's entries
+    const entt::registry& registry = std::as_const(*registry_);
+    if (!registry.valid(entity))
+        return false;
+
+    const auto* transform = registry.try_get<Core::Components::WorldTransformComponent>(entity);
+    if (!transform)
+        return false;
+
+    if (const auto it = lightIndices_.find(entity); it != lightIndices_.end())
+        placeLight(lights_[it->second], *transform);
+
+    const auto it = meshes_.find(entity);
+    if (it == meshes_.end())
+        return false;
+
+    const MeshProxy& proxy = it->second;
+    if (proxy.isStatic) {
+        if (staticMeshes_[proxy.index].transform == transform->matrix)
+            return false;
+        staticMeshes_[proxy.index].transform = transform->matrix;
+        return true;
+    }
+
+    Renderable& renderable    = renderables_[proxy.index];
+    renderable.transform      = transform->matrix;
+    renderable.position       = transform->getPosition();
+    renderable.boundingRadius = scaledRadius(proxy.localRadius, *transform);
+    return false;
+}
+
+void RenderWorld::refreshLight(const entt::entity                               entity,
+                               const Core::Components::LightComponent*          lightComp,
+                               const Core::Components::WorldTransformComponent* transform) {
+    if (!lightComp || !lightComp->enabled || !transform) {
+        removeLight(entity);
+        return;
+    }
+
+    auto [it, inserted] = lightIndices_.try_emplace(entity, static_cast<uint32_t>(lights_.size()));
+    if (inserted) {
+        lights_.emplace_back();
+        lightOwners_.push_back(entity);
+    }
+
+    // Convert ECS light component to renderer light
+    Light& light = lights_[it->second];
+
+    switch (lightComp->type) {
+        case Core::Components::LightType::Directional:
+            light.type = LightType::Directional;
+            break;
+        case Core::Components::LightType::Point:
+            light.type = LightType::Point;
+            break;
+        case Core::Components::LightType::Spot:
+            light.type = LightType::Spot;
+            break;
+    }
+
+    light.id                  = static_cast<uint32_t>(entity);
+    light.color               = glm::vec3(lightComp->color);
+    light.intensity           = lightComp->intensity;
+    light.range               = lightComp->range;
+    light.innerCutoff         = lightComp->innerCutoff;
+    light.outerCutoff         = lightComp->outerCutoff;
+    light.castShadows         = lightComp->castShadows;
+    light.shadowMapResolution = lightComp->shadowMapResolution;
+    light.shadowBias          = lightComp->shadowBias;
+    light.shadowStrength      = lightComp->shadowStrength;
+    light.shadowDistance      = lightComp->shadowDistance;
+    light.shadowNearPlane     = lightComp->shadowNearPlane;
+    light.shadowFarPlane      = lightComp->shadowFarPlane;
+    light.cascadeCount        = static_cast<uint32_t>(
+        std::clamp(lightComp->cascadeCount, 1, int(CascadedShadowMap::MAX_CASCADES)));
+    light.cascadeSplitLambda  = std::clamp(lightComp->cascadeSplitLambda, 0.0f, 1.0f);
+    placeLight(light, *transform);
+}
+
+void RenderWorld::removeMesh(const entt::entity entity) {
+    const auto it = meshes_.find(entity);
+    if (it == meshes_.end())
+        return;
+
+    const MeshProxy proxy = it->second;
+    meshes_.erase(it);
+    releaseMaterial(proxy.materialAsset);
+
+    if (proxy.isStatic) {
+        // Left as a hole until the end of the update, so removing many costs one pass
+        staticOwners_[proxy.index] = entt::null;
+        ++staticHoles_;
+        staticChanged_ = true;
+        return;
+    }
+
+    // Only called while the chunk renderables are dropped, so the last one is a proxy
+    const entt::entity last = renderableOwners_.back();
+    if (last != entity) {
+        renderables_[proxy.index]      = renderables_.back();
+        renderableOwners_[proxy.index] = last;
+        meshes_[last].index            = proxy.index;
+    }
+    renderables_.pop_back();
+    renderableOwners_.pop_back();
+}
+
+void RenderWorld::compactStatic() {
+    if (staticHoles_ == 0)
+        return;
+
+    // Keep the order, moving a mesh between chunks would make the batcher rebuild both
+    size_t kept = 0;
+    for (size_t i = 0; i < staticOwners_.size(); ++i) {
+        const entt::entity owner = staticOwners_[i];
+        if (owner == entt::null)
+            continue;
+
+        if (kept != i) {
+            staticMeshes_[kept]     = staticMeshes_[i];
+            staticOwners_[kept]     = owner;
+            meshes_.at(owner).index = static_cast<uint32_t>(kept);
+        }
+        ++kept;
+    }
+
+    staticMeshes_.resize(kept);
+    staticOwners_.resize(kept);
+    staticHoles_ = 0;
+}
+
+void RenderWorld::removeLight(const entt::entity entity) {
+    const auto it = lightIndices_.find(entity);
+    if (it == lightIndices_.end())
+        return;
+
+    const uint32_t index = it->second;
+    lightIndices_.erase(it);
+
+    const entt::entity last = lightOwners_.back();
+    if (last != entity) {
+        lights_[index]      = lights_.back();
+        lightOwners_[index] = last;
+        lightIndices_[last] = index;
+    }
+    lights_.pop_back();
+    lightOwners_.pop_back();
+}
+
+void RenderWorld::retainMaterial(const Core::MaterialAsset* asset) {
+    if (asset)
+        ++materialRefs_[asset];
+}
+
+void RenderWorld::releaseMaterial(const Core::MaterialAsset* asset) {
+    if (!asset)
+        return;
+    if (const auto it = materialRefs_.find(asset); it != materialRefs_.end() && --it->second == 0)
+        materialRefs_.erase(it);
+}
+
+}
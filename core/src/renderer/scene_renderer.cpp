@@ -3,21 +3,58 @@
 
 #include "corvus/application.hpp"
 #include "corvus/components/light.hpp"
+#include "corvus/files/static_resource_file.hpp"
+#include "corvus/jobs/job_system.hpp"
 #include "corvus/log.hpp"
+#include "corvus/renderer/batch_transform.hpp"
+#include "corvus/renderer/model_generator.hpp"
+#include <algorithm>
+#include <limits>
+#include <tuple>
 
 namespace Corvus::Renderer {
 
+namespace {
+    // Instances per job when streaming instance transforms
+    constexpr size_t INSTANCE_GRAIN = 2048;
+    // Instances gathered per normal matrix batch, a multiple of the widest SIMD step
+    constexpr size_t NORMAL_BATCH = 64;
+
+    // FNV-1a, used to tell whether a light's caster set changed since its shadow map was drawn
+    constexpr uint64_t HASH_SEED = 14695981039346656037ull;
+
+    uint64_t hashBytes(uint64_t hash, const void* data, size_t size) {
+        const auto* bytes = static_cast<const uint8_t*>(data);
+        for (size_t i = 0; i < size; ++i) {
+            hash ^= bytes[i];
+            hash *= 1099511628211ull;
+        }
+        return hash;
+    }
+}
+
 SceneRenderer::SceneRenderer(Graphics::GraphicsContext& context)
-    : context_(context), materialRenderer_(context) {
+    : context_(context), materialRenderer_(context), staticBatcher_(context),
+      renderWorld_(context, materialRenderer_) {
     // Initialize lighting system
     lighting_.initialize(context_);
 }
 
+SceneRenderer::~SceneRenderer() {
+    instanceBuffer_.release();
+    depthInstancedShader_.release();
+    gbuffer_.cleanup();
+    oitBuffer_.cleanup();
+    oitCompositeShader_.release();
+    fullscreenTriangle_.release();
+}
+
 void SceneRenderer::clear(const glm::vec4&             color,
                           bool                         clearDepth,
                           const Graphics::Framebuffer* targetFB) const {
     auto cmd = context_.createCommandBuffer();
     cmd.begin();
+    CORVUS_GPU_PUSH_GROUP(cmd, "Clear");
 
     if (targetFB && targetFB->valid()) {
         cmd.bindFramebuffer(*targetFB);
@@ -30,6 +67,7 @@ void SceneRenderer::clear(const glm::vec4&             color,
         cmd.unbindFramebuffer();
     }
 
+    CORVUS_GPU_POP_GROUP(cmd);
     cmd.end();
     cmd.submit();
 }
@@ -38,74 +76,327 @@ void SceneRenderer::render(const std::vector<Renderable>& renderables,
                            const glm::mat4&               view,
                            const glm::mat4&               proj,
                            const glm::vec3&               cameraPos,
-                           const Graphics::Framebuffer*   targetFB) {
+                           const Graphics::Framebuffer*   targetFB,
+                           bool                           depthPrePass,
+                           RenderPath                     path) {
+    render(renderables,
+           view,
+           proj,
+           cameraPos,
+           Camera::Frustum::fromMatrix(proj * view),
+           targetFB,
+           depthPrePass,
+           path);
+}
+
+void SceneRenderer::render(const std::vector<Renderable>& renderables,
+                           const glm::mat4&               view,
+                           const glm::mat4&               proj,
+                           const glm::vec3&               cameraPos,
+                           const Camera::Frustum&         frustum,
+                           const Graphics::Framebuffer*   targetFB,
+                           bool                           depthPrePass,
+                           RenderPath                     path) {
 
     stats_.reset();
+    buildCullBounds(renderables);
 
     // Render shadow maps if there are shadow-casting lights
-    renderShadowMaps(renderables);
+    renderShadowMaps(renderables, view, proj);
+
+    // Both need their own targets next to the frame's framebuffer
+    const bool hasTarget       = targetFB && targetFB->valid();
+    const bool deferred        = path == RenderPath::Deferred && hasTarget;
+    const bool weightedBlended = transparencyMode_ == TransparencyMode::WeightedBlended
+                              && hasTarget && getOITCompositeShader().valid();
+
+    // Reject everything outside the view before recording any uniforms
+    cullAgainst(frustum, visible_);
+    buildDrawBatches(renderables, view, proj, deferred, weightedBlended);
 
     auto cmd = context_.createCommandBuffer();
     cmd.begin();
+    CORVUS_GPU_PUSH_GROUP(cmd, deferred ? "Scene Deferred Pass" : "Scene Forward Pass");
 
     // Bind framebuffer
-    if (targetFB && targetFB->valid()) {
+    if (deferred) {
+        gbuffer_.resize(context_, targetFB->width, targetFB->height);
+        cmd.bindFramebuffer(gbuffer_.framebuffer);
+        cmd.setViewport(0, 0, gbuffer_.width, gbuffer_.height);
+        cmd.setDepthMask(true);
+        cmd.clear(0.0f, 0.0f, 0.0f, 0.0f, true);
+    } else if (targetFB && targetFB->valid()) {
         cmd.bindFramebuffer(*targetFB);
         cmd.setViewport(0, 0, targetFB->width, targetFB->height);
     } else {
         cmd.unbindFramebuffer();
     }
 
-    for (auto& renderable : renderables) {
-        if (!renderable.enabled)
-            continue;
-
-        if (!renderable.model || !renderable.model->valid())
-            continue;
+    // Bin point and spot lights once for the view, objects then read them per fragment
+    lighting_.buildClusters(cmd, view, proj);
 
-        if (!renderable.material)
-            continue;
+    // Every instanced batch reads from the same buffer, uploaded once for the frame
+    if (!instanceTexels_.empty())
+        instanceBuffer_.setData(
+            cmd,
+            instanceTexels_.data(),
+            static_cast<uint32_t>(instanceTexels_.size() * sizeof(glm::vec4)));
 
-        // Apply material
-        auto* shader = materialRenderer_.apply(*renderable.material, cmd);
-        if (!shader || !shader->valid())
-            continue;
+    // Pre-passed batches are all deferred ones in the deferred path, so it fills the G-buffer depth
+    if (depthPrePass)
+        renderDepthPrePass(cmd, renderables, view, proj);
 
-        // Setup standard uniforms
-        setupStandardUniforms(cmd, *shader, renderable.transform, view, proj);
-
-        // Setup lighting uniforms
-        setupLightingUniforms(
-            cmd, *shader, renderable.position, renderable.boundingRadius, cameraPos);
-        lighting_.bindShadowTextures(cmd);
-
-        // Culling
-        float det      = glm::determinant(renderable.transform);
-        bool  mirrored = det < 0.0f;
-        bool  cull     = renderable.material->getRenderState().cullFace;
-        cmd.setCullFace(cull, mirrored);
-
-        // Draw
-        renderable.model->draw(cmd, renderable.wireframe);
-
-        // Stats
-        stats_.entitiesRendered++;
-        for (const auto& mesh : renderable.model->getMeshes()) {
-            if (mesh && mesh->valid()) {
-                stats_.drawCalls++;
-                stats_.triangles += mesh->getIndexCount() / 3;
-                stats_.vertices += mesh->getIndexCount();
-            }
-        }
+    if (deferred) {
+        drawBatches(cmd, renderables, view, proj, cameraPos, DrawPass::GBuffer);
+        renderDeferredLighting(cmd, view, proj, cameraPos, *targetFB);
     }
 
+    // Opaque forward batches, then the sorted transparent queue
+    drawBatches(cmd, renderables, view, proj, cameraPos, DrawPass::Lit);
+
+    if (weightedBlended)
+        renderWeightedBlended(cmd, renderables, view, proj, cameraPos, *targetFB);
+
     if (targetFB && targetFB->valid())
         cmd.unbindFramebuffer();
 
+    CORVUS_GPU_POP_GROUP(cmd);
     cmd.end();
     cmd.submit();
 }
 
+void SceneRenderer::drawBatches(CommandBuffer&                 cmd,
+                                const std::vector<Renderable>& renderables,
+                                const glm::mat4&               view,
+                                const glm::mat4&               proj,
+                                const glm::vec3&               cameraPos,
+                                DrawPass                       pass) {
+    using ShaderVariant = MaterialRenderer::ShaderVariant;
+
+    const auto variantFor = [pass](bool instanced) {
+        if (pass == DrawPass::GBuffer)
+            return instanced ? ShaderVariant::GBufferInstanced : ShaderVariant::GBuffer;
+        if (pass == DrawPass::WeightedBlended)
+            return instanced ? ShaderVariant::WeightedBlendedInstanced
+                             : ShaderVariant::WeightedBlended;
+        return ShaderVariant::Instanced;
+    };
+
+    // Accumulated transparency never writes depth, whatever the material asks for
+    const auto applyPassState = [&cmd, pass]() {
+        if (pass == DrawPass::WeightedBlended)
+            cmd.setDepthMask(false);
+    };
+
+    // Pre-passed batches only shade the fragments whose depth they wrote
+    bool equalDepth = false;
+    const auto matchPrePass = [&cmd, &equalDepth](const DrawBatch& batch) {
+        if (batch.prePassed) {
+            cmd.setDepthMask(false);
+            cmd.setDepthFunc(Graphics::DepthFunc::Equal);
+        } else if (equalDepth) {
+            cmd.setDepthFunc(Graphics::DepthFunc::Less);
+        }
+        equalDepth = batch.prePassed;
+    };
+
+    const auto countDraws
+        = [this](const Model& model, uint32_t lod, uint32_t instances, uint32_t draws) {
+              stats_.entitiesRendered += instances;
+              for (const auto& mesh : model.getLodMeshes(lod)) {
+                  if (mesh && mesh->valid()) {
+                      stats_.drawCalls += draws;
+                      stats_.triangles += mesh->getIndexCount() / 3 * instances;
+                      stats_.vertices += mesh->getIndexCount() * instances;
+                      stats_.lodTriangles[lod] += mesh->getIndexCount() / 3 * instances;
+                  }
+              }
+          };
+
+    for (const DrawBatch& batch : drawBatches_) {
+        if (batch.pass != pass)
+            continue;
+
+        const DrawItem&   first      = drawItems_[batch.first];
+        const Renderable& renderable = renderables[first.index];
+
+        if (batch.instanceOffset >= 0) {
+            auto* shader
+                = materialRenderer_.applyVariant(*renderable.material, cmd, variantFor(true));
+            if (!shader)
+                continue;
+            matchPrePass(batch);
+            applyPassState();
+
+            setupViewUniforms(cmd, *shader, view, proj);
+            shader->setInt(cmd, "u_InstanceOffset", batch.instanceOffset);
+            cmd.bindTextureBuffer(INSTANCE_TEXTURE_SLOT, instanceBuffer_, "u_InstanceData");
+
+            // Lighting is applied later by the full screen pass
+            if (pass != DrawPass::GBuffer) {
+                setupLightingUniforms(cmd, *shader, cameraPos);
+                lighting_.bindShadowTextures(cmd);
+                lighting_.bindClusterTextures(cmd);
+            }
+
+            cmd.setCullFace(renderable.material->getRenderState().cullFace, first.mirrored);
+            renderable.model->drawInstanced(cmd, batch.count, first.wireframe, first.lod);
+            countDraws(*renderable.model, first.lod, batch.count, 1);
+            stats_.instancedBatches++;
+        } else {
+            for (uint32_t i = 0; i < batch.count; ++i) {
+                const DrawItem&   item   = drawItems_[batch.first + i];
+                const Renderable& single = renderables[item.index];
+
+                // Apply material
+                auto* shader = pass == DrawPass::Lit
+                                 ? materialRenderer_.apply(*single.material, cmd)
+                                 : materialRenderer_.applyVariant(
+                                       *single.material, cmd, variantFor(false));
+                if (!shader || !shader->valid())
+                    continue;
+                matchPrePass(batch);
+                applyPassState();
+
+                // Setup standard uniforms
+                setupStandardUniforms(cmd, *shader, single.transform, view, proj);
+
+                // Setup lighting uniforms
+                if (pass != DrawPass::GBuffer) {
+                    setupLightingUniforms(cmd, *shader, cameraPos);
+                    lighting_.bindShadowTextures(cmd);
+                    lighting_.bindClusterTextures(cmd);
+                }
+
+                // Culling
+                cmd.setCullFace(single.material->getRenderState().cullFace, item.mirrored);
+
+                // Draw
+                single.model->draw(cmd, single.wireframe, item.lod);
+                countDraws(*single.model, item.lod, 1, 1);
+            }
+        }
+
+        if (pass == DrawPass::GBuffer)
+            stats_.deferredDraws += batch.count;
+        else if (first.material->getRenderState().blend)
+            stats_.transparentDraws += batch.count;
+    }
+
+    if (equalDepth)
+        cmd.setDepthFunc(Graphics::DepthFunc::Less);
+}
+
+void SceneRenderer::renderDeferredLighting(CommandBuffer&               cmd,
+                                           const glm::mat4&             view,
+                                           const glm::mat4&             proj,
+                                           const glm::vec3&             cameraPos,
+                                           const Graphics::Framebuffer& targetFB) {
+    cmd.bindFramebuffer(targetFB);
+    cmd.setViewport(0, 0, targetFB.width, targetFB.height);
+
+    auto& shader = materialRenderer_.getDeferredLightingShader();
+    if (!shader.valid())
+        return;
+
+    CORVUS_GPU_PUSH_GROUP(cmd, "Deferred Lighting");
+    cmd.setShader(shader);
+    cmd.setBlendState(false);
+    cmd.setCullFace(false, false);
+
+    // Depth comes from the G-buffer through gl_FragDepth, uncovered pixels are discarded
+    cmd.setDepthTest(true);
+    cmd.setDepthMask(true);
+    cmd.setDepthFunc(Graphics::DepthFunc::Always);
+
+    cmd.bindTexture(0, gbuffer_.albedo, "u_GBufferAlbedo");
+    cmd.bindTexture(1, gbuffer_.normal, "u_GBufferNormal");
+    cmd.bindTexture(2, gbuffer_.depth, "u_GBufferDepth");
+    shader.setMat4(cmd, "u_InverseViewProjection", glm::inverse(proj * view));
+
+    setupViewUniforms(cmd, shader, view, proj);
+    setupLightingUniforms(cmd, shader, cameraPos);
+    lighting_.bindShadowTextures(cmd);
+    lighting_.bindClusterTextures(cmd);
+
+    getFullscreenTriangle().draw(cmd);
+    stats_.drawCalls++;
+
+    cmd.setDepthFunc(Graphics::DepthFunc::Less);
+    CORVUS_GPU_POP_GROUP(cmd);
+}
+
+void SceneRenderer::renderWeightedBlended(CommandBuffer&                 cmd,
+                                          const std::vector<Renderable>& renderables,
+                                          const glm::mat4&               view,
+                                          const glm::mat4&               proj,
+                                          const glm::vec3&               cameraPos,
+                                          const Graphics::Framebuffer&   targetFB) {
+    const bool any = std::any_of(drawBatches_.begin(), drawBatches_.end(), [](const DrawBatch& b) {
+        return b.pass == DrawPass::WeightedBlended;
+    });
+    if (!any)
+        return;
+
+    CORVUS_GPU_PUSH_GROUP(cmd, "Weighted Blended Transparency");
+
+    // Transparent fragments are tested against the finished opaque depth but never write it
+    oitBuffer_.resize(context_, targetFB.width, targetFB.height);
+    cmd.blitFramebuffer(targetFB, oitBuffer_.framebuffer, false, true);
+    cmd.setViewport(0, 0, oitBuffer_.width, oitBuffer_.height);
+
+    // Nothing accumulated, full revealage
+    cmd.setColorMask(true);
+    cmd.clear(0.0f, 0.0f, 0.0f, 1.0f, false);
+
+    cmd.setBlendFunc(Graphics::BlendFunc::WeightedAccumulate);
+    drawBatches(cmd, renderables, view, proj, cameraPos, DrawPass::WeightedBlended);
+    cmd.setBlendFunc(Graphics::BlendFunc::Alpha);
+
+    // Resolve over the opaque image with ordinary alpha blending
+    auto& composite = getOITCompositeShader();
+    cmd.bindFramebuffer(targetFB);
+    cmd.setViewport(0, 0, targetFB.width, targetFB.height);
+    cmd.setShader(composite);
+    cmd.setBlendState(true);
+    cmd.setDepthTest(false);
+    cmd.setDepthMask(false);
+    cmd.setCullFace(false, false);
+    cmd.bindTexture(0, oitBuffer_.accum, "u_OITAccum");
+    cmd.bindTexture(1, oitBuffer_.weight, "u_OITWeight");
+
+    getFullscreenTriangle().draw(cmd);
+    stats_.drawCalls++;
+
+    cmd.setDepthTest(true);
+    cmd.setDepthMask(true);
+    CORVUS_GPU_POP_GROUP(cmd);
+}
+
+Model& SceneRenderer::getFullscreenTriangle() {
+    if (!fullscreenTriangle_.valid())
+        fullscreenTriangle_ = ModelGenerator::createFullscreenTriangle(context_);
+    return fullscreenTriangle_;
+}
+
+Shader& SceneRenderer::getOITCompositeShader() {
+    if (!oitCompositeShader_.valid()) {
+        auto vsBytes
+            = Core::StaticResourceFile::create("engine/shaders/fullscreen.vert")->readAllBytes();
+        auto fsBytes
+            = Core::StaticResourceFile::create("engine/shaders/oit_composite.frag")->readAllBytes();
+        oitCompositeShader_ = context_.createShader(std::string(vsBytes.begin(), vsBytes.end()),
+                                                    std::string(fsBytes.begin(), fsBytes.end()));
+        if (oitCompositeShader_.valid()) {
+            CORVUS_GPU_LABEL(oitCompositeShader_, "OIT Composite Shader");
+        } else {
+            CORVUS_CORE_ERROR("Failed to create OIT composite shader");
+        }
+    }
+
+    return oitCompositeShader_;
+}
+
 void SceneRenderer::render(const std::vector<Renderable>& renderables,
                            const Camera&                  camera,
                            const Graphics::Framebuffer*   targetFB) {
@@ -113,129 +404,354 @@ void SceneRenderer::render(const std::vector<Renderable>& renderables,
     glm::mat4 proj      = camera.getProjectionMatrix();
     glm::vec3 cameraPos = camera.getPosition();
 
-    render(renderables, view, proj, cameraPos, targetFB);
+    render(renderables,
+           view,
+           proj,
+           cameraPos,
+           camera.getFrustum(),
+           targetFB,
+           camera.isDepthPrePassEnabled(),
+           camera.getRenderPath());
 }
 
-// ECS Integration
-void SceneRenderer::renderScene(entt::registry&              registry,
-                                const Camera&                camera,
-                                Core::AssetManager*          assetManager,
-                                const Graphics::Framebuffer* targetFB) {
+void SceneRenderer::renderDepthPrePass(CommandBuffer&                 cmd,
+                                       const std::vector<Renderable>& renderables,
+                                       const glm::mat4&               view,
+                                       const glm::mat4&               proj) {
 
-    // Convert ECS lights to renderer lights
-    collectLightsFromRegistry(registry);
+    auto& shadowShader = lighting_.getShadowShader();
+    if (!shadowShader.valid())
+        return;
 
-    // Convert ECS entities to renderables
-    auto renderables = collectRenderables(registry, assetManager);
+    auto&           instancedShader = getDepthInstancedShader();
+    const glm::mat4 viewProj        = proj * view;
 
-    // Use the primary render method
-    render(renderables, camera, targetFB);
-}
+    CORVUS_GPU_PUSH_GROUP(cmd, "Depth Pre-Pass");
+    cmd.setColorMask(false);
+    cmd.setDepthTest(true);
+    cmd.setDepthMask(true);
+    cmd.setBlendState(false);
 
-void SceneRenderer::collectLightsFromRegistry(entt::registry& registry) {
-    // Clear lights from previous frame
-    lighting_.clear();
+    for (DrawBatch& batch : drawBatches_) {
+        const DrawItem&    first = drawItems_[batch.first];
+        const RenderState& state = first.material->getRenderState();
 
-    const auto lightView
-        = registry.view<Core::Components::LightComponent, Core::Components::TransformComponent>();
+        // Only opaque, depth writing materials whose vertex stage the depth shaders reproduce,
+        // the equal test in the lit pass needs bit identical positions
+        if (state.blend || !state.depthTest || !state.depthWrite || first.wireframe
+            || !materialRenderer_.usesDefaultShader(*first.material))
+            continue;
 
-    for (const auto entityHandle : lightView) {
-        const auto& lightComp = lightView.get<Core::Components::LightComponent>(entityHandle);
-        auto&       transform = lightView.get<Core::Components::TransformComponent>(entityHandle);
+        cmd.setCullFace(state.cullFace, first.mirrored);
+        const Model& model = *renderables[first.index].model;
+
+        if (batch.instanceOffset >= 0 && instancedShader.valid()) {
+            cmd.setShader(instancedShader);
+            instancedShader.setMat4(cmd, "u_ViewProjection", viewProj);
+            instancedShader.setInt(cmd, "u_InstanceOffset", batch.instanceOffset);
+            cmd.bindTextureBuffer(INSTANCE_TEXTURE_SLOT, instanceBuffer_, "u_InstanceData");
+            model.drawInstanced(cmd, batch.count, false, first.lod);
+            stats_.depthPrePassDraws++;
+        } else {
+            cmd.setShader(shadowShader);
+            shadowShader.setMat4(cmd, "u_LightSpaceMatrix", viewProj);
+            for (uint32_t i = 0; i < batch.count; ++i) {
+                const DrawItem&   item       = drawItems_[batch.first + i];
+                const Renderable& renderable = renderables[item.index];
+                shadowShader.setMat4(cmd, "u_Model", renderable.transform);
+                renderable.model->draw(cmd, false, item.lod);
+            }
+            stats_.depthPrePassDraws += batch.count;
+        }
 
-        // Check if entity is enabled
-        if (const auto* entityInfo
-            = registry.try_get<Core::Components::EntityInfoComponent>(entityHandle);
-            entityInfo && !entityInfo->enabled)
-            continue;
+        batch.prePassed = true;
+    }
 
-        if (!lightComp.enabled)
-            continue;
+    cmd.setColorMask(true);
+    CORVUS_GPU_POP_GROUP(cmd);
+}
 
-        // Convert ECS light component to renderer light
-        Light light;
-
-        switch (lightComp.type) {
-            case Core::Components::LightType::Directional:
-                light.type = LightType::Directional;
-                break;
-            case Core::Components::LightType::Point:
-                light.type = LightType::Point;
-                break;
-            case Core::Components::LightType::Spot:
-                light.type = LightType::Spot;
-                break;
-        }
+Shader& SceneRenderer::getDepthInstancedShader() {
+    if (!depthInstancedShader_.valid()) {
+        // Same position math as default_lit_instanced.vert
+        std::string vertexShader = R"(
+            #version 330 core
+            layout(location = 0) in vec3 vertexPosition;
+
+            uniform mat4          u_ViewProjection;
+            uniform samplerBuffer u_InstanceData;
+            uniform int           u_InstanceOffset;
+
+            invariant gl_Position;
+
+            void main() {
+                int  base  = (u_InstanceOffset + gl_InstanceID) * 7;
+                mat4 model = mat4(texelFetch(u_InstanceData, base),
+                                  texelFetch(u_InstanceData, base + 1),
+                                  texelFetch(u_InstanceData, base + 2),
+                                  texelFetch(u_InstanceData, base + 3));
+                gl_Position = u_ViewProjection * model * vec4(vertexPosition, 1.0);
+            }
+        )";
+
+        std::string fragmentShader = R"(
+            #version 330 core
+
+            void main() {
+                // Depth is written automatically
+            }
+        )";
 
-        light.position    = transform.position;
-        light.direction   = glm::normalize(glm::rotate(transform.rotation, glm::vec3(0, 0, -1)));
-        light.color       = glm::vec3(lightComp.color.r, lightComp.color.g, lightComp.color.b);
-        light.intensity   = lightComp.intensity;
-        light.range       = lightComp.range;
-        light.innerCutoff = lightComp.innerCutoff;
-        light.outerCutoff = lightComp.outerCutoff;
-        light.castShadows = lightComp.castShadows;
-        light.shadowMapResolution = lightComp.shadowMapResolution;
-        light.shadowBias          = lightComp.shadowBias;
-        light.shadowStrength      = lightComp.shadowStrength;
-        light.shadowDistance      = lightComp.shadowDistance;
-        light.shadowNearPlane     = lightComp.shadowNearPlane;
-        light.shadowFarPlane      = lightComp.shadowFarPlane;
-
-        lighting_.addLight(light);
+        depthInstancedShader_ = context_.createShader(vertexShader, fragmentShader);
+        if (depthInstancedShader_.valid()) {
+            CORVUS_GPU_LABEL(depthInstancedShader_, "Depth Instanced Shader");
+        } else {
+            CORVUS_CORE_ERROR("Failed to create depth instanced shader");
+        }
     }
+
+    return depthInstancedShader_;
 }
 
-std::vector<Renderable> SceneRenderer::collectRenderables(entt::registry&     registry,
-                                                          Core::AssetManager* assetManager) {
+void SceneRenderer::buildCullBounds(const std::vector<Renderable>& renderables) {
+    cullBounds_.clear();
+    cullBounds_.reserve(renderables.size());
+    for (const auto& renderable : renderables)
+        cullBounds_.push(renderable.position, renderable.boundingRadius);
+}
 
-    std::vector<Renderable> renderables;
+SceneRenderer::DrawPass SceneRenderer::passFor(const Material& material,
+                                               bool            deferred,
+                                               bool            weightedBlended) const {
+    using ShaderVariant      = MaterialRenderer::ShaderVariant;
+    const RenderState& state = material.getRenderState();
+
+    // The G-buffer takes opaque, depth writing materials the default shader draws, custom shaders
+    // stay forward and are drawn over the lit result
+    if (state.blend)
+        return weightedBlended
+                    && materialRenderer_.supportsVariant(material, ShaderVariant::WeightedBlended)
+                 ? DrawPass::WeightedBlended
+                 : DrawPass::Lit;
+    if (deferred && state.depthTest && state.depthWrite
+        && materialRenderer_.supportsVariant(material, ShaderVariant::GBuffer))
+        return DrawPass::GBuffer;
+    return DrawPass::Lit;
+}
 
-    const auto meshView = registry.view<Core::Components::MeshRendererComponent,
-                                        Core::Components::TransformComponent>();
+uint32_t
+SceneRenderer::selectLod(const Model& model, const float coverage, const uint32_t previous) const {
+    uint32_t lod = 0;
+    for (uint32_t level = 1; level < model.getLodCount(); ++level) {
+        // Leaving the previous level takes a margin past the threshold in either direction
+        const float margin = level > previous ? 1.0f - lodHysteresis_ : 1.0f + lodHysteresis_;
+        if (coverage >= model.getLodScreenCoverage(level) * margin)
+            break;
+        lod = level;
+    }
+    return lod;
+}
 
-    for (const auto entityHandle : meshView) {
-        auto& meshRenderer = meshView.get<Core::Components::MeshRendererComponent>(entityHandle);
-        auto& transform    = meshView.get<Core::Components::TransformComponent>(entityHandle);
+void SceneRenderer::buildDrawBatches(const std::vector<Renderable>& renderables,
+                                     const glm::mat4&               view,
+                                     const glm::mat4&               proj,
+                                     bool                           deferred,
+                                     bool                           weightedBlended) {
+    drawItems_.clear();
+    drawBatches_.clear();
+    instanceTexels_.clear();
+    instanceSources_.clear();
+
+    // Levels picked last frame, the hysteresis compares against them
+    lodPrevious_.swap(lodCurrent_);
+    lodCurrent_.clear();
+
+    for (size_t i = 0; i < renderables.size(); ++i) {
+        const auto& renderable = renderables[i];
+        if (!renderable.enabled)
+            continue;
 
-        // Check if entity is enabled
-        if (const auto* entityInfo
-            = registry.try_get<Core::Components::EntityInfoComponent>(entityHandle);
-            entityInfo && !entityInfo->enabled)
+        if (!renderable.model || !renderable.model->valid())
             continue;
 
-        // Get model
-        auto* model = meshRenderer.getModel(assetManager, &context_);
-        if (!model || !model->valid())
+        if (!visible_[i]) {
+            stats_.entitiesCulled++;
             continue;
+        }
 
-        // Get MaterialAsset and convert to Material
-        auto* materialAsset = meshRenderer.getMaterial(assetManager);
-        if (!materialAsset)
+        if (!renderable.material)
             continue;
 
-        // Convert MaterialAsset -> Material
-        Material* material = materialRenderer_.getMaterialFromAsset(*materialAsset, assetManager);
-        if (!material)
+        // Fraction of the screen height the bounding sphere covers, w is 1 for orthographic
+        const glm::vec4 viewPos  = view * glm::vec4(renderable.position, 1.0f);
+        const float     w        = (proj * viewPos).w;
+        const float     coverage = w > 1e-4f
+                                     ? renderable.boundingRadius * proj[1][1] / w
+                                     : std::numeric_limits<float>::max();
+        if (coverage < lodCullCoverage_) {
+            stats_.entitiesCulled++;
+            stats_.lodCulled++;
             continue;
+        }
 
-        // Create pure renderer Renderable
-        Renderable renderable;
-        renderable.model          = model;
-        renderable.material       = material;
-        renderable.transform      = transform.getMatrix();
-        renderable.position       = transform.position;
-        renderable.boundingRadius = meshRenderer.getBoundingRadius();
-        renderable.wireframe      = meshRenderer.renderWireframe;
-        renderable.enabled        = true;
-
-        renderables.push_back(renderable);
+        uint32_t previous = 0;
+        if (renderable.id != 0) {
+            if (auto it = lodPrevious_.find(renderable.id); it != lodPrevious_.end())
+                previous = it->second;
+        }
+        const uint32_t lod = selectLod(*renderable.model, coverage, previous);
+        if (renderable.id != 0)
+            lodCurrent_[renderable.id] = static_cast<uint8_t>(lod);
+
+        // Mirrored transforms flip the winding, so they cannot share a draw with the rest
+        const bool mirrored = glm::determinant(renderable.transform) < 0.0f;
+        drawItems_.push_back({ renderable.material,
+                               renderable.model,
+                               static_cast<uint32_t>(i),
+                               -viewPos.z,
+                               static_cast<uint8_t>(lod),
+                               renderable.wireframe,
+                               mirrored });
     }
 
-    return renderables;
+    // A material carries its render state, so equal materials also share state
+    std::sort(drawItems_.begin(), drawItems_.end(), [](const DrawItem& a, const DrawItem& b) {
+        return std::tie(a.material, a.model, a.lod, a.wireframe, a.mirrored, a.depth)
+             < std::tie(b.material, b.model, b.lod, b.wireframe, b.mirrored, b.depth);
+    });
+
+    for (uint32_t first = 0; first < drawItems_.size();) {
+        const DrawItem& head = drawItems_[first];
+        const DrawPass  pass = passFor(*head.material, deferred, weightedBlended);
+
+        // Sorted transparency needs every object at its own depth, so those never batch
+        const bool sorted = pass == DrawPass::Lit && head.material->getRenderState().blend;
+        uint32_t   end    = first + 1;
+        while (!sorted && end < drawItems_.size() && drawItems_[end].material == head.material
+               && drawItems_[end].model == head.model && drawItems_[end].lod == head.lod
+               && drawItems_[end].wireframe == head.wireframe
+               && drawItems_[end].mirrored == head.mirrored)
+            ++end;
+
+        DrawBatch batch { first, end - first, -1, false, pass };
+        if (batch.count > 1
+            && materialRenderer_.supportsVariant(*head.material,
+                                                 MaterialRenderer::ShaderVariant::Instanced)) {
+            batch.instanceOffset = static_cast<int32_t>(instanceSources_.size());
+            for (uint32_t i = first; i < end; ++i)
+                instanceSources_.push_back(drawItems_[i].index);
+        }
+
+        drawBatches_.push_back(batch);
+        first = end;
+    }
+
+    // Every instance owns its own texels, so the matrices are streamed in parallel. Models are
+    // gathered a few at a time so their normal matrices are computed in SIMD batches.
+    instanceTexels_.resize(instanceSources_.size() * INSTANCE_TEXELS);
+    Core::JobSystem::get().parallelFor(
+        0, instanceSources_.size(), INSTANCE_GRAIN, [&](const size_t first, const size_t last) {
+            glm::mat4 models[NORMAL_BATCH];
+            glm::mat3 normals[NORMAL_BATCH];
+
+            for (size_t start = first; start < last; start += NORMAL_BATCH) {
+                const size_t count = std::min(NORMAL_BATCH, last - start);
+                for (size_t k = 0; k < count; ++k)
+                    models[k] = renderables[instanceSources_[start + k]].transform;
+                normalMatrices(models, count, normals);
+
+                for (size_t k = 0; k < count; ++k) {
+                    glm::vec4* texel = &instanceTexels_[(start + k) * INSTANCE_TEXELS];
+                    texel[0]         = models[k][0];
+                    texel[1]         = models[k][1];
+                    texel[2]         = models[k][2];
+                    texel[3]         = models[k][3];
+                    texel[4]         = glm::vec4(normals[k][0], 0.0f);
+                    texel[5]         = glm::vec4(normals[k][1], 0.0f);
+                    texel[6]         = glm::vec4(normals[k][2], 0.0f);
+                }
+            }
+        });
+
+    // Opaque batches front to back by their nearest member to cut overdraw, then the transparent
+    // queue back to front so each blends over what is behind it
+    std::stable_sort(
+        drawBatches_.begin(), drawBatches_.end(), [this](const DrawBatch& a, const DrawBatch& b) {
+            const DrawItem& itemA  = drawItems_[a.first];
+            const DrawItem& itemB  = drawItems_[b.first];
+            const bool      blendA = itemA.material->getRenderState().blend;
+            const bool      blendB = itemB.material->getRenderState().blend;
+            if (blendA != blendB)
+                return blendB;
+            return blendA ? itemA.depth > itemB.depth : itemA.depth < itemB.depth;
+        });
+
+    if (!instanceTexels_.empty() && !instanceBuffer_.valid()) {
+        instanceBuffer_ = context_.createTextureBuffer(
+            Graphics::ImageFormat::RGBA32F, nullptr, sizeof(glm::vec4) * INSTANCE_TEXELS);
+        CORVUS_GPU_LABEL(instanceBuffer_, "Instance Transforms");
+    }
 }
 
-void SceneRenderer::renderShadowMaps(const std::vector<Renderable>& renderables) {
+void SceneRenderer::cullAgainst(const Camera::Frustum& frustum,
+                                std::vector<uint8_t>&  visible) const {
+    if (frustumCulling_) {
+        cullSpheres(frustum, cullBounds_, visible);
+    } else {
+        visible.assign(cullBounds_.size(), 1);
+    }
+}
+
+void SceneRenderer::cullAgainst(const glm::vec3&      center,
+                                float                 radius,
+                                std::vector<uint8_t>& visible) const {
+    if (frustumCulling_) {
+        cullSpheres(center, radius, cullBounds_, visible);
+    } else {
+        visible.assign(cullBounds_.size(), 1);
+    }
+}
+
+// ECS Integration
+void SceneRenderer::renderScene(entt::registry&              registry,
+                                const Camera&                camera,
+                                Core::AssetManager*          assetManager,
+                                const Graphics::Framebuffer* targetFB) {
+
+    if (renderWorld_.getRegistry() != &registry)
+        renderWorld_.attach(registry);
+
+    // Only entities changed since the last frame are converted again
+    renderWorld_.update(assetManager, staticBatching_ ? &staticBatcher_ : nullptr);
+    lighting_.clear();
+    lighting_.getLights() = renderWorld_.getLights();
+
+    // Use the primary render method
+    render(renderWorld_.getRenderables(), camera, targetFB);
+    stats_.proxiesUpdated      = renderWorld_.getProxiesUpdated();
+    stats_.staticChunks        = staticBatcher_.getChunkCount();
+    stats_.staticChunksRebuilt
+        = renderWorld_.staticBatchesUpdated() ? staticBatcher_.getChunksRebuilt() : 0;
+}
+
+void SceneRenderer::setStaticBatching(const bool enabled) {
+    if (enabled == staticBatching_)
+        return;
+
+    // Static meshes move between the chunks and the dynamic renderables
+    staticBatching_ = enabled;
+    staticBatcher_.invalidate();
+    renderWorld_.markAllDirty();
+}
+
+void SceneRenderer::invalidateStaticBatches() {
+    staticBatcher_.invalidate();
+    renderWorld_.markAllDirty();
+}
+
+void SceneRenderer::renderShadowMaps(const std::vector<Renderable>& renderables,
+                                     const glm::mat4&               view,
+                                     const glm::mat4&               proj) {
     // Prepare shadow maps
     lighting_.prepareShadowMaps(context_);
 
@@ -248,160 +764,265 @@ void SceneRenderer::renderShadowMaps(const std::vector<Renderable>& renderables)
     if (renderables.empty())
         return;
 
-    // Calculate scene center for directional lights
-    glm::vec3 sceneCenter(0.0f);
-    for (const auto& r : renderables) {
-        sceneCenter += r.position;
-    }
-    if (!renderables.empty()) {
-        sceneCenter /= static_cast<float>(renderables.size());
-    }
-
-    // Get all lights
-    auto& lights = lighting_.getLights();
-
-    size_t shadowMapIndex = 0;
-    size_t cubemapIndex   = 0;
+    // Get all lights, only the primary directional light is shaded so only it gets cascades
+    auto&        lights  = lighting_.getLights();
+    const Light* primary = lighting_.getPrimaryDirectionalLight();
 
-    std::vector<float> shadowBiases;
-    std::vector<float> shadowStrengths;
-
-    // Render shadow maps for each shadow-casting light
-    for (auto& light : lights) {
+    // Render shadow maps for each shadow-casting light, skipping any whose casters are unchanged
+    for (size_t lightIndex = 0; lightIndex < lights.size(); ++lightIndex) {
+        const Light& light = lights[lightIndex];
         if (!light.castShadows)
             continue;
 
         if (light.type == LightType::Directional) {
-            if (shadowMapIndex >= LightingSystem::MAX_SHADOW_MAPS)
-                break;
+            auto& cascades = lighting_.getCascadedShadowMap();
+            if (&light != primary || !cascades.initialized)
+                continue;
 
-            auto& shadowMaps = lighting_.getShadowMaps();
-            if (shadowMapIndex >= shadowMaps.size())
-                break;
+            lighting_.calculateCascades(light, view, proj);
+            renderCascadedShadowMap(cascades, renderables, shadowShader);
+            continue;
+        }
 
-            auto&     shadowMap = shadowMaps[shadowMapIndex];
-            glm::mat4 lightSpaceMatrix
-                = lighting_.calculateDirectionalLightMatrix(light, sceneCenter);
-            shadowMap.lightSpaceMatrix = lightSpaceMatrix;
+        // No slot when the atlas ran out of room for this light
+        ShadowAtlasSlot* slot = lighting_.getShadowSlot(lightIndex);
+        if (!slot)
+            continue;
 
-            shadowBiases.push_back(light.shadowBias);
-            shadowStrengths.push_back(light.shadowStrength);
+        uint64_t casterHash = 0;
+        if (light.type == LightType::Spot) {
+            cullAgainst(Camera::Frustum::fromMatrix(slot->lightSpaceMatrix), shadowVisible_);
+            casterHash = collectShadowCasters(
+                renderables, hashBytes(HASH_SEED, &slot->lightSpaceMatrix, sizeof(glm::mat4)));
+
+            if (casterHash != slot->casterHash)
+                renderSpotShadowMap(*slot, renderables, shadowShader);
+        } else {
+            // Only casters overlapping the light's range can land in any face
+            cullAgainst(light.position, light.range, shadowVisible_);
+            const glm::vec4 lightSphere(light.position, light.range);
+            casterHash = collectShadowCasters(
+                renderables, hashBytes(HASH_SEED, &lightSphere, sizeof(glm::vec4)));
+
+            if (casterHash != slot->casterHash) {
+                auto lightMatrices
+                    = lighting_.calculatePointLightMatrices(light.position, 0.1f, light.range);
+                renderPointShadowMap(*slot, light, lightMatrices, renderables);
+            }
+        }
 
-            renderDirectionalShadowMap(shadowMap, lightSpaceMatrix, renderables, shadowShader);
-            shadowMapIndex++;
+        if (casterHash != slot->casterHash) {
+            slot->casterHash = casterHash;
+            stats_.shadowMapsRendered++;
+        } else {
+            stats_.shadowMapsCached++;
+        }
+    }
+}
 
-        } else if (light.type == LightType::Spot) {
-            if (shadowMapIndex >= LightingSystem::MAX_SHADOW_MAPS)
-                break;
+uint64_t SceneRenderer::collectShadowCasters(const std::vector<Renderable>& renderables,
+                                             uint64_t                       lightHash) {
+    uint64_t hash = lightHash;
+    for (size_t i = 0; i < renderables.size(); ++i) {
+        const auto& renderable = renderables[i];
+        if (!renderable.enabled || !renderable.castShadows || !renderable.model
+            || !renderable.model->valid()) {
+            shadowVisible_[i] = 0;
+            continue;
+        }
 
-            auto& shadowMaps = lighting_.getShadowMaps();
-            if (shadowMapIndex >= shadowMaps.size())
-                break;
+        if (!shadowVisible_[i]) {
+            stats_.shadowCastersCulled++;
+            continue;
+        }
 
-            auto&     shadowMap        = shadowMaps[shadowMapIndex];
-            glm::mat4 lightSpaceMatrix = lighting_.calculateSpotLightMatrix(light);
-            shadowMap.lightSpaceMatrix = lightSpaceMatrix;
+        hash = hashBytes(hash, &renderable.model, sizeof(renderable.model));
+        hash = hashBytes(hash, &renderable.transform, sizeof(glm::mat4));
+        hash = hashBytes(hash, &renderable.boundingRadius, sizeof(float));
+    }
+    return hash;
+}
 
-            shadowBiases.push_back(light.shadowBias);
-            shadowStrengths.push_back(light.shadowStrength);
+void SceneRenderer::renderSpotShadowMap(const ShadowAtlasSlot&         slot,
+                                        const std::vector<Renderable>& renderables,
+                                        Shader&                        shadowShader) {
 
-            renderDirectionalShadowMap(shadowMap, lightSpaceMatrix, renderables, shadowShader);
+    if (!shadowShader.valid())
+        return;
 
-            light.shadowMapIndex = static_cast<int>(shadowMapIndex);
+    const auto&            atlas = lighting_.getShadowAtlas();
+    const ShadowAtlasTile& tile  = slot.tiles[0];
 
-            shadowMapIndex++;
+    auto cmd = context_.createCommandBuffer();
+    cmd.begin();
+    CORVUS_GPU_PUSH_GROUP(cmd, "Spot Shadow");
 
-        } else if (light.type == LightType::Point) {
-            if (cubemapIndex >= LightingSystem::MAX_POINT_SHADOWS)
-                break;
+    // Scissor keeps the clear inside this light's tile, the rest of the atlas stays cached
+    cmd.bindFramebuffer(atlas.framebuffer);
+    cmd.setViewport(tile.x, tile.y, tile.size, tile.size);
+    cmd.setDepthMask(true);
+    cmd.setScissor(tile.x, tile.y, tile.size, tile.size);
+    cmd.enableScissor(true);
+    cmd.clear(1.0f, 1.0f, 1.0f, 1.0f, true, false);
+    cmd.enableScissor(false);
 
-            auto& cubemaps = lighting_.getCubemapShadows();
-            if (cubemapIndex >= cubemaps.size())
-                break;
+    cmd.setShader(shadowShader);
+    cmd.setDepthTest(true);
+    cmd.setCullFace(true, false);
 
-            auto& cubemap         = cubemaps[cubemapIndex];
-            cubemap.lightPosition = light.position;
-            cubemap.farPlane      = light.range;
+    // shadowVisible_ holds the casters from collectShadowCasters
+    for (size_t i = 0; i < renderables.size(); ++i) {
+        if (!shadowVisible_[i])
+            continue;
 
-            auto lightMatrices
-                = lighting_.calculatePointLightMatrices(light.position, 0.1f, light.range);
-            renderPointShadowMap(cubemap, light, lightMatrices, renderables, shadowShader);
-            cubemapIndex++;
-        }
-        lighting_.setShadowProperties(shadowBiases, shadowStrengths);
+        const auto& renderable = renderables[i];
+        shadowShader.setMat4(cmd, "u_LightSpaceMatrix", slot.lightSpaceMatrix);
+        shadowShader.setMat4(cmd, "u_Model", renderable.transform);
+        renderable.model->draw(cmd);
     }
+
+    cmd.unbindFramebuffer();
+    CORVUS_GPU_POP_GROUP(cmd);
+    cmd.end();
+    cmd.submit();
 }
 
-void SceneRenderer::renderDirectionalShadowMap(const ShadowMap&               shadowMap,
-                                               const glm::mat4&               lightSpaceMatrix,
-                                               const std::vector<Renderable>& renderables,
-                                               Shader&                        shadowShader) const {
+void SceneRenderer::renderCascadedShadowMap(CascadedShadowMap&             cascades,
+                                            const std::vector<Renderable>& renderables,
+                                            Shader&                        shadowShader) {
 
     if (!shadowShader.valid())
         return;
 
     auto cmd = context_.createCommandBuffer();
     cmd.begin();
-
-    cmd.bindFramebuffer(shadowMap.framebuffer);
-    cmd.setViewport(0, 0, shadowMap.resolution, shadowMap.resolution);
-    cmd.clear(1.0f, 1.0f, 1.0f, 1.0f, true, false);
+    CORVUS_GPU_PUSH_GROUP(cmd, "Cascaded Shadow Map");
 
     cmd.setShader(shadowShader);
     cmd.setDepthTest(true);
     cmd.setDepthMask(true);
     cmd.setCullFace(true, false);
 
-    for (const auto& renderable : renderables) {
-        if (!renderable.enabled || !renderable.model || !renderable.model->valid())
+    for (uint32_t c = 0; c < cascades.cascadeCount; ++c) {
+        const glm::mat4& lightSpaceMatrix = cascades.lightSpaceMatrices[c];
+
+        // Each cascade only draws the casters inside its own light volume, and only when those
+        // or the (texel snapped) cascade matrix changed
+        cullAgainst(Camera::Frustum::fromMatrix(lightSpaceMatrix), shadowVisible_);
+        uint64_t casterHash = collectShadowCasters(
+            renderables, hashBytes(HASH_SEED, &lightSpaceMatrix, sizeof(glm::mat4)));
+
+        if (casterHash == cascades.casterHashes[c]) {
+            stats_.shadowMapsCached++;
             continue;
+        }
+        cascades.casterHashes[c] = casterHash;
+        stats_.shadowMapsRendered++;
 
-        shadowShader.setMat4(cmd, "u_LightSpaceMatrix", lightSpaceMatrix);
-        shadowShader.setMat4(cmd, "u_Model", renderable.transform);
-        renderable.model->draw(cmd);
+        CORVUS_GPU_PUSH_GROUP(cmd, "Cascade");
+        cmd.bindFramebuffer(cascades.framebuffers[c]);
+        cmd.setViewport(0, 0, cascades.resolution, cascades.resolution);
+        cmd.clear(1.0f, 1.0f, 1.0f, 1.0f, true, false);
+
+        for (size_t i = 0; i < renderables.size(); ++i) {
+            if (!shadowVisible_[i])
+                continue;
+
+            const auto& renderable = renderables[i];
+            shadowShader.setMat4(cmd, "u_LightSpaceMatrix", lightSpaceMatrix);
+            shadowShader.setMat4(cmd, "u_Model", renderable.transform);
+            renderable.model->draw(cmd);
+        }
+        CORVUS_GPU_POP_GROUP(cmd);
     }
 
     cmd.unbindFramebuffer();
+    CORVUS_GPU_POP_GROUP(cmd);
     cmd.end();
     cmd.submit();
 }
 
-void SceneRenderer::renderPointShadowMap(CubemapShadow&                  cubemap,
+void SceneRenderer::renderPointShadowMap(const ShadowAtlasSlot&          slot,
                                          const Light&                    light,
                                          const std::array<glm::mat4, 6>& lightMatrices,
-                                         const std::vector<Renderable>&  renderables,
-                                         Shader&                         shadowShader) const {
+                                         const std::vector<Renderable>&  renderables) {
 
-    if (!shadowShader.valid())
+    auto& shader = lighting_.getPointShadowShader();
+    if (!shader.valid())
         return;
 
+    const auto& atlas = lighting_.getShadowAtlas();
+
+    // Build a face mask per caster so the geometry stage only emits to faces it can land in
+    faceMasks_.assign(renderables.size(), 0);
     for (int face = 0; face < 6; ++face) {
-        auto cmd = context_.createCommandBuffer();
-        cmd.begin();
+        cullAgainst(Camera::Frustum::fromMatrix(lightMatrices[face]), faceVisible_);
+        for (size_t i = 0; i < renderables.size(); ++i)
+            faceMasks_[i] |= static_cast<uint8_t>((shadowVisible_[i] & faceVisible_[i]) << face);
+    }
+
+    static const auto matrixNames = [] {
+        std::array<std::string, 6> names;
+        for (size_t i = 0; i < names.size(); ++i)
+            names[i] = "u_ShadowMatrices[" + std::to_string(i) + "]";
+        return names;
+    }();
+    static const auto rectNames = [] {
+        std::array<std::string, 6> names;
+        for (size_t i = 0; i < names.size(); ++i)
+            names[i] = "u_FaceRects[" + std::to_string(i) + "]";
+        return names;
+    }();
+
+    auto cmd = context_.createCommandBuffer();
+    cmd.begin();
+    CORVUS_GPU_PUSH_GROUP(cmd, "Point Shadow");
+
+    cmd.bindFramebuffer(atlas.framebuffer);
+    cmd.setDepthMask(true);
 
-        cubemap.framebuffer.attachTextureCubeFace(cubemap.depthCubemap, face);
-        cmd.bindFramebuffer(cubemap.framebuffer);
-        cmd.setViewport(0, 0, cubemap.resolution, cubemap.resolution);
+    // Clear each face tile on its own, the tiles need not be adjacent
+    cmd.enableScissor(true);
+    for (size_t face = 0; face < 6; ++face) {
+        const ShadowAtlasTile& tile = slot.tiles[face];
+        cmd.setScissor(tile.x, tile.y, tile.size, tile.size);
         cmd.clear(1.0f, 1.0f, 1.0f, 1.0f, true, false);
+    }
+    cmd.enableScissor(false);
 
-        cmd.setShader(shadowShader);
-        cmd.setDepthTest(true);
-        cmd.setDepthMask(true);
-        cmd.setCullFace(true, false);
+    // Draw over the whole atlas, each face is mapped into its tile and clipped to it
+    cmd.setViewport(0, 0, atlas.size, atlas.size);
+    cmd.setClipDistances(4);
 
-        for (const auto& renderable : renderables) {
-            if (!renderable.enabled || !renderable.model || !renderable.model->valid())
-                continue;
+    cmd.setShader(shader);
+    cmd.setDepthTest(true);
+    cmd.setCullFace(true, false);
 
-            shadowShader.setMat4(cmd, "u_LightSpaceMatrix", lightMatrices[face]);
-            shadowShader.setMat4(cmd, "u_Model", renderable.transform);
-            renderable.model->draw(cmd);
-        }
+    const float invSize = 1.0f / static_cast<float>(atlas.size);
+    for (size_t face = 0; face < 6; ++face) {
+        const ShadowAtlasTile& tile   = slot.tiles[face];
+        const float            scale  = static_cast<float>(tile.size) * invSize;
+        const glm::vec2        ndcMin = glm::vec2(tile.x, tile.y) * invSize * 2.0f - 1.0f;
+        shader.setMat4(cmd, matrixNames[face].c_str(), lightMatrices[face]);
+        shader.setVec4(cmd, rectNames[face].c_str(), glm::vec4(ndcMin + scale, scale, scale));
+    }
+    shader.setVec3(cmd, "u_LightPos", light.position);
+    shader.setFloat(cmd, "u_FarPlane", light.range);
 
-        cmd.unbindFramebuffer();
-        cmd.end();
-        cmd.submit();
+    for (size_t i = 0; i < renderables.size(); ++i) {
+        if (!faceMasks_[i])
+            continue;
+
+        shader.setMat4(cmd, "u_Model", renderables[i].transform);
+        shader.setInt(cmd, "u_FaceMask", faceMasks_[i]);
+        renderables[i].model->draw(cmd);
     }
+
+    cmd.setClipDistances(0);
+    cmd.unbindFramebuffer();
+    CORVUS_GPU_POP_GROUP(cmd);
+    cmd.end();
+    cmd.submit();
 }
 
 void SceneRenderer::setupStandardUniforms(CommandBuffer&   cmd,
@@ -410,23 +1031,28 @@ void SceneRenderer::setupStandardUniforms(CommandBuffer&   cmd,
                                           const glm::mat4& view,
                                           const glm::mat4& proj) {
 
-    const glm::mat4 viewProj = proj * view;
-    const glm::mat4 normal   = glm::transpose(glm::inverse(model));
+    const glm::mat4 normal(normalMatrix(model));
 
     shader.setMat4(cmd, "u_Model", model);
+    shader.setMat4(cmd, "u_NormalMatrix", normal);
+    setupViewUniforms(cmd, shader, view, proj);
+}
+
+void SceneRenderer::setupViewUniforms(CommandBuffer&   cmd,
+                                      Shader&          shader,
+                                      const glm::mat4& view,
+                                      const glm::mat4& proj) {
+
     shader.setMat4(cmd, "u_View", view);
     shader.setMat4(cmd, "u_Projection", proj);
-    shader.setMat4(cmd, "u_ViewProjection", viewProj);
-    shader.setMat4(cmd, "u_NormalMatrix", normal);
+    shader.setMat4(cmd, "u_ViewProjection", proj * view);
 }
 
 void SceneRenderer::setupLightingUniforms(CommandBuffer&   cmd,
                                           Shader&          shader,
-                                          const glm::vec3& objectPos,
-                                          float            objectRadius,
                                           const glm::vec3& cameraPos) {
 
-    lighting_.applyLightingUniforms(cmd, shader, objectPos, objectRadius, cameraPos);
+    lighting_.applyLightingUniforms(cmd, shader, cameraPos);
 }
 
 }
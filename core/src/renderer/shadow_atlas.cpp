@@ -0,0 +1,184 @@
+#include "corvus/renderer/shadow_atlas.hpp"
+#include <algorithm>
+#include <functional>
+
+namespace Corvus::Renderer {
+
+void ShadowAtlas::initialize(Graphics::GraphicsContext& ctx, const uint32_t atlasSize) {
+    if (initialized && size == atlasSize) {
+        return;
+    }
+
+    cleanup();
+    size = atlasSize;
+
+    depthTexture = ctx.createDepthTexture(atlasSize, atlasSize);
+    framebuffer  = ctx.createFramebuffer(atlasSize, atlasSize);
+    framebuffer.attachDepthTexture(depthTexture);
+    CORVUS_GPU_LABEL(depthTexture, "Shadow Atlas Depth");
+    CORVUS_GPU_LABEL(framebuffer, "Shadow Atlas FBO");
+
+    // One level per power of two from the full atlas down to MIN_TILE_SIZE
+    uint32_t levels = 1;
+    while ((atlasSize >> levels) >= MIN_TILE_SIZE)
+        ++levels;
+
+    freeTiles_.assign(levels, {});
+    freeTiles_[0].emplace_back(0u, 0u);
+    slots_.clear();
+
+    initialized = true;
+}
+
+void ShadowAtlas::cleanup() {
+    if (initialized) {
+        framebuffer.release();
+        depthTexture.release();
+        freeTiles_.clear();
+        slots_.clear();
+        initialized = false;
+        size        = 0;
+    }
+}
+
+void ShadowAtlas::retain(const uint64_t key, const uint32_t tileCount, const uint32_t tileSize) {
+    auto it = slots_.find(key);
+    if (it != slots_.end() && it->second.tileCount == tileCount
+        && it->second.requestedSize == tileSize)
+        it->second.lastFrame = frame_;
+}
+
+void ShadowAtlas::releaseUnretained() {
+    for (auto it = slots_.begin(); it != slots_.end();) {
+        if (it->second.lastFrame != frame_) {
+            freeSlot(it->second);
+            it = slots_.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+ShadowAtlasSlot*
+ShadowAtlas::acquire(const uint64_t key, const uint32_t tileCount, const uint32_t tileSize) {
+    if (!initialized || tileCount == 0 || tileCount > 6)
+        return nullptr;
+
+    auto it = slots_.find(key);
+    if (it != slots_.end()) {
+        if (it->second.tileCount == tileCount && it->second.requestedSize == tileSize) {
+            it->second.lastFrame = frame_;
+            return &it->second;
+        }
+        freeSlot(it->second);
+        slots_.erase(it);
+    }
+
+    ShadowAtlasSlot slot;
+    slot.tileCount     = tileCount;
+    slot.requestedSize = tileSize;
+    slot.lastFrame     = frame_;
+
+    // Step down a level at a time until every tile of the light fits
+    for (uint32_t level = levelOf(tileSize); level < levelCount(); ++level) {
+        uint32_t allocated = 0;
+        while (allocated < tileCount && allocateTile(level, slot.tiles[allocated]))
+            ++allocated;
+
+        if (allocated == tileCount)
+            return &(slots_[key] = slot);
+
+        for (uint32_t i = 0; i < allocated; ++i)
+            freeTile(slot.tiles[i]);
+    }
+
+    return nullptr;
+}
+
+glm::vec4 ShadowAtlas::uvRect(const ShadowAtlasTile& tile) const {
+    const float invSize = 1.0f / static_cast<float>(size);
+    return glm::vec4(static_cast<float>(tile.x) * invSize,
+                     static_cast<float>(tile.y) * invSize,
+                     static_cast<float>(tile.size) * invSize,
+                     static_cast<float>(tile.size) * invSize);
+}
+
+uint32_t ShadowAtlas::levelOf(const uint32_t tileSize) const {
+    // Level 0 is never handed out whole so one light cannot take the entire atlas
+    uint32_t level = 1;
+    while (level + 1 < levelCount() && (size >> (level + 1)) >= tileSize)
+        ++level;
+    return level;
+}
+
+bool ShadowAtlas::allocateTile(const uint32_t level, ShadowAtlasTile& tile) {
+    auto& freeList = freeTiles_[level];
+    if (!freeList.empty()) {
+        const glm::uvec2 origin = freeList.back();
+        freeList.pop_back();
+        tile = { origin.x, origin.y, size >> level };
+        return true;
+    }
+
+    if (level == 0)
+        return false;
+
+    // Split a parent into four, hand out the first quadrant and keep the rest free
+    ShadowAtlasTile parent;
+    if (!allocateTile(level - 1, parent))
+        return false;
+
+    const uint32_t half = parent.size / 2;
+    freeList.emplace_back(parent.x + half, parent.y);
+    freeList.emplace_back(parent.x, parent.y + half);
+    freeList.emplace_back(parent.x + half, parent.y + half);
+    tile = { parent.x, parent.y, half };
+    return true;
+}
+
+void ShadowAtlas::freeTile(const ShadowAtlasTile& tile) {
+    uint32_t level = 0;
+    while ((size >> level) > tile.size)
+        ++level;
+
+    auto& freeList = freeTiles_[level];
+    if (level == 0) {
+        freeList.emplace_back(tile.x, tile.y);
+        return;
+    }
+
+    // Merge with the three siblings when they are all free
+    const uint32_t   parentSize = tile.size * 2;
+    const uint32_t   parentMask = ~(parentSize - 1);
+    const glm::uvec2 parent(tile.x & parentMask, tile.y & parentMask);
+
+    std::array<size_t, 3> siblings {};
+    size_t                found = 0;
+    for (size_t i = 0; i < freeList.size() && found < siblings.size(); ++i) {
+        const glm::uvec2 origin = freeList[i];
+        if ((origin.x & parentMask) == parent.x && (origin.y & parentMask) == parent.y)
+            siblings[found++] = i;
+    }
+
+    if (found < siblings.size()) {
+        freeList.emplace_back(tile.x, tile.y);
+        return;
+    }
+
+    // Swap-remove from the back so the remaining indices stay valid
+    std::sort(siblings.begin(), siblings.end(), std::greater<>());
+    for (size_t index : siblings) {
+        freeList[index] = freeList.back();
+        freeList.pop_back();
+    }
+
+    freeTile({ parent.x, parent.y, parentSize });
+}
+
+void ShadowAtlas::freeSlot(ShadowAtlasSlot& slot) {
+    for (uint32_t i = 0; i < slot.tileCount; ++i)
+        freeTile(slot.tiles[i]);
+    slot.tileCount = 0;
+}
+
+}
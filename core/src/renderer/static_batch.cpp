@@ -0,0 +1,134 @@
+#include "corvus/renderer/static_batch.hpp"
+#include "corvus/renderer/batch_transform.hpp"
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <limits>
+
+namespace Corvus::Renderer {
+
+size_t StaticBatcher::ChunkKeyHash::operator()(const ChunkKey& key) const {
+    size_t hash = std::hash<const void*>()(key.material);
+    hash ^= std::hash<int>()(key.cell.x) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+    hash ^= std::hash<int>()(key.cell.y) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+    hash ^= std::hash<int>()(key.cell.z) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+    return hash ^ static_cast<size_t>(key.castShadows);
+}
+
+StaticBatcher::StaticBatcher(Graphics::GraphicsContext& ctx) : context_(ctx) { }
+
+StaticBatcher::~StaticBatcher() { invalidate(); }
+
+bool StaticBatcher::canBatch(const Model& model) {
+    for (const auto& mesh : model.getMeshes()) {
+        if (!mesh || !mesh->valid())
+            continue;
+        if (mesh->getPrimitiveType() != PrimitiveType::Triangles || mesh->hasColors()
+            || mesh->getVertices().empty() || mesh->getIndices().size() != mesh->getIndexCount())
+            return false;
+    }
+    return model.valid();
+}
+
+void StaticBatcher::update(const std::vector<StaticMeshInstance>& instances) {
+    ++updateCount_;
+    chunksRebuilt_ = 0;
+
+    for (const auto& instance : instances) {
+        const glm::vec3 position(instance.transform[3]);
+        const ChunkKey  key { instance.material,
+                             glm::ivec3(glm::floor(position / CHUNK_SIZE)),
+                             instance.castShadows };
+
+        Chunk& chunk = chunks_[key];
+        if (chunk.lastUpdate != updateCount_) {
+            chunk.pending.clear();
+            chunk.lastUpdate = updateCount_;
+        }
+        chunk.pending.push_back(instance);
+    }
+
+    for (auto it = chunks_.begin(); it != chunks_.end();) {
+        Chunk& chunk = it->second;
+        if (chunk.lastUpdate != updateCount_) {
+            if (chunk.model)
+                chunk.model->release();
+            it = chunks_.erase(it);
+            continue;
+        }
+
+        if (!chunk.model || chunk.pending != chunk.members) {
+            chunk.members.swap(chunk.pending);
+            rebuild(chunk);
+            chunksRebuilt_++;
+        }
+        ++it;
+    }
+}
+
+void StaticBatcher::invalidate() {
+    for (auto& [key, chunk] : chunks_) {
+        if (chunk.model)
+            chunk.model->release();
+    }
+    chunks_.clear();
+}
+
+void StaticBatcher::appendRenderables(std::vector<Renderable>& renderables) {
+    for (auto& [key, chunk] : chunks_) {
+        if (!chunk.model || !chunk.model->valid())
+            continue;
+
+        Renderable renderable;
+        renderable.model          = chunk.model.get();
+        renderable.material       = key.material;
+        renderable.position       = chunk.center;
+        renderable.boundingRadius = chunk.radius;
+        renderable.castShadows    = key.castShadows;
+        renderables.push_back(renderable);
+    }
+}
+
+void StaticBatcher::rebuild(Chunk& chunk) {
+    std::vector<Vertex>   vertices;
+    std::vector<uint32_t> indices;
+    glm::vec3             boundsMin(std::numeric_limits<float>::max());
+    glm::vec3             boundsMax(std::numeric_limits<float>::lowest());
+
+    for (const auto& member : chunk.members) {
+        const glm::mat3 normal = normalMatrix(member.transform);
+
+        for (const auto& mesh : member.model->getMeshes()) {
+            if (!mesh || !mesh->valid())
+                continue;
+
+            const auto base = static_cast<uint32_t>(vertices.size());
+            for (const auto& vertex : mesh->getVertices()) {
+                const glm::vec3 position(member.transform * glm::vec4(vertex.position, 1.0f));
+                vertices.push_back({ position,
+                                     glm::normalize(normal * vertex.normal),
+                                     vertex.texCoord });
+                boundsMin = glm::min(boundsMin, position);
+                boundsMax = glm::max(boundsMax, position);
+            }
+            for (const uint32_t index : mesh->getIndices())
+                indices.push_back(base + index);
+        }
+    }
+
+    // Allocate the new model before dropping the old one, so its address changes and anything
+    // keyed on the model pointer (the shadow caster cache) sees the edit
+    auto model = std::make_unique<Model>();
+    if (!indices.empty())
+        model->addMesh(Mesh::createFromVertices(context_, vertices, indices));
+    if (chunk.model)
+        chunk.model->release();
+    chunk.model = std::move(model);
+
+    chunk.center = (boundsMin + boundsMax) * 0.5f;
+    chunk.radius = 0.0f;
+    for (const auto& vertex : vertices)
+        chunk.radius = std::max(chunk.radius, glm::distance(vertex.position, chunk.center));
+}
+
+}
@@ -0,0 +1,43 @@
+#include "corvus/renderer/transparency.hpp"
+
+namespace Corvus::Renderer {
+
+void WeightedBlendedBuffer::resize(Graphics::GraphicsContext& ctx,
+                                   const uint32_t             w,
+                                   const uint32_t             h) {
+    if (initialized && width == w && height == h) {
+        return;
+    }
+
+    cleanup();
+    width  = w;
+    height = h;
+
+    accum       = ctx.createTexture2D(w, h, Graphics::ImageFormat::RGBA16F);
+    weight      = ctx.createTexture2D(w, h, Graphics::ImageFormat::R32F);
+    depth       = ctx.createDepthTexture(w, h);
+    framebuffer = ctx.createFramebuffer(w, h);
+    framebuffer.attachTexture2D(accum, 0);
+    framebuffer.attachTexture2D(weight, 1);
+    framebuffer.attachDepthTexture(depth);
+    CORVUS_GPU_LABEL(accum, "OIT Accumulation");
+    CORVUS_GPU_LABEL(weight, "OIT Weight");
+    CORVUS_GPU_LABEL(depth, "OIT Depth");
+    CORVUS_GPU_LABEL(framebuffer, "OIT FBO");
+
+    initialized = true;
+}
+
+void WeightedBlendedBuffer::cleanup() {
+    if (initialized) {
+        framebuffer.release();
+        depth.release();
+        weight.release();
+        accum.release();
+        initialized = false;
+        width       = 0;
+        height      = 0;
+    }
+}
+
+}
@@ -1,33 +1,112 @@
-#include <ranges>
-
 #include "corvus/components/entity_info.hpp"
 #include "corvus/components/mesh_renderer.hpp"
 #include "corvus/components/transform.hpp"
 #include "corvus/entity.hpp"
+#include "corvus/jobs/system_scheduler.hpp"
 #include "corvus/log.hpp"
 #include "corvus/scene.hpp"
+#include <iterator>
 
 namespace Corvus::Core {
 
+namespace {
+    void applyDisabledTag(entt::registry& registry, const entt::entity entity) {
+        const auto* info = registry.try_get<Components::EntityInfoComponent>(entity);
+        if (!info)
+            return;
+
+        if (info->enabled)
+            registry.remove<Components::DisabledTag>(entity);
+        else
+            registry.emplace_or_replace<Components::DisabledTag>(entity);
+    }
+
+    // The tag reorders the pools owned by the render groups, a system patching the info from a
+    // concurrent stage leaves it to the scheduler to apply between stages
+    void syncDisabledTag(entt::registry& registry, const entt::entity entity) {
+        SystemScheduler::deferChange(registry, entity, &applyDisabledTag);
+    }
+
+    void clearDisabledTag(entt::registry& registry, const entt::entity entity) {
+        registry.remove<Components::DisabledTag>(entity);
+    }
+}
+
+Scene::Scene(const std::string_view& name, AssetManager* assetManager)
+    : name(name), assetManager(assetManager), renderer(nullptr),
+      hierarchy(std::make_unique<TransformHierarchy>()),
+      changes(std::make_unique<SceneChanges>()) {
+    hierarchy->attach(registry);
+    changes->attach(registry);
+
+    // Edits to enabled only reach the tag when the info is patched, as the inspector does
+    registry.on_construct<Components::EntityInfoComponent>().connect<&syncDisabledTag>();
+    registry.on_update<Components::EntityInfoComponent>().connect<&syncDisabledTag>();
+    registry.on_destroy<Components::EntityInfoComponent>().connect<&clearDisabledTag>();
+}
+
 void Scene::destroyEntity(const Entity entity) {
-    rootOrderedEntities.erase(std::ranges::remove(rootOrderedEntities, entity).begin(),
-                              rootOrderedEntities.end());
+    rootOrderedEntities.erase(entity);
     registry.destroy(entity.entityHandle);
 }
 
+std::vector<Entity> Scene::createEntities(const size_t count, const std::string& entityName) {
+    std::vector<entt::entity> handles(count);
+    registry.create(handles.begin(), handles.end());
+
+    // Every info gets its own id, the transforms all start out as the same default
+    std::vector<Components::EntityInfoComponent> infos;
+    infos.reserve(count);
+    for (size_t i = 0; i < count; ++i)
+        infos.emplace_back(entityName.empty() ? "New entity" : entityName);
+
+    registry.insert<Components::EntityInfoComponent>(
+        handles.begin(), handles.end(), std::make_move_iterator(infos.begin()));
+    registry.insert<Components::TransformComponent>(handles.begin(), handles.end());
+
+    std::vector<Entity> entities;
+    entities.reserve(count);
+    for (const auto handle : handles) {
+        entities.emplace_back(handle, this);
+        rootOrderedEntities.push_back(entities.back());
+    }
+    return entities;
+}
+
+void Scene::destroyEntities(const std::span<const Entity> entities) {
+    std::vector<entt::entity> handles;
+    handles.reserve(entities.size());
+    for (const auto& entity : entities) {
+        rootOrderedEntities.erase(entity);
+        handles.push_back(entity.entityHandle);
+    }
+    registry.destroy(handles.begin(), handles.end());
+}
+
 Scene& Scene::operator=(Scene&& other) noexcept {
     if (this != &other) {
         name                = std::move(other.name);
         registry            = std::move(other.registry);
+        format              = other.format;
         rootOrderedEntities = std::move(other.rootOrderedEntities);
         assetManager        = other.assetManager;
         renderer            = other.renderer;
+        hierarchy           = std::move(other.hierarchy);
+        changes             = std::move(other.changes);
 
         // Rebind all entity.scene pointers to this new Scene instance
         for (auto& e : rootOrderedEntities) {
             e.scene = this;
         }
 
+        // The render world observes the registry object, move it over while the old one exists
+        if (renderer)
+            renderer->attachRegistry(registry);
+        if (hierarchy)
+            hierarchy->attach(registry);
+        if (changes)
+            changes->attach(registry);
+
         other.assetManager = nullptr;
         other.renderer     = nullptr;
     }
@@ -35,19 +114,77 @@ Scene& Scene::operator=(Scene&& other) noexcept {
 }
 
 Scene::Scene(Scene&& other) noexcept
-    : name(std::move(other.name)), registry(std::move(other.registry)),
+    : name(std::move(other.name)), registry(std::move(other.registry)), format(other.format),
       rootOrderedEntities(std::move(other.rootOrderedEntities)), assetManager(other.assetManager),
-      renderer(other.renderer) {
+      renderer(other.renderer), hierarchy(std::move(other.hierarchy)),
+      changes(std::move(other.changes)) {
 
     // Rebind all entity.scene pointers to this new Scene instance
     for (auto& e : rootOrderedEntities) {
         e.scene = this;
     }
 
+    if (renderer)
+        renderer->attachRegistry(registry);
+    if (hierarchy)
+        hierarchy->attach(registry);
+    if (changes)
+        changes->attach(registry);
+
     other.assetManager = nullptr;
     other.renderer     = nullptr;
 }
 
+void Scene::setParent(const Entity child, const Entity parent) {
+    if (!parent) {
+        registry.remove<Components::ParentComponent>(child.entityHandle);
+        return;
+    }
+
+    const auto& parentInfo = registry.get<Components::EntityInfoComponent>(parent.entityHandle);
+    registry.emplace_or_replace<Components::ParentComponent>(
+        child.entityHandle, Components::ParentComponent { parentInfo.id });
+}
+
+SceneSnapshot Scene::snapshot() {
+    SceneSnapshot snapshot;
+    snapshot.entities.assign(registry.data(), registry.data() + registry.size());
+    snapshot.released   = registry.released();
+    snapshot.order      = rootOrderedEntities;
+    snapshot.components = Components::ComponentRegistry::get().snapshotComponents(registry);
+    snapshot.pending    = changes->getPending();
+    snapshot.valid      = true;
+    return snapshot;
+}
+
+void Scene::restore(SceneSnapshot&& snapshot) {
+    if (!snapshot.valid) {
+        CORVUS_CORE_WARN("Cannot restore scene {} from an empty snapshot", name);
+        return;
+    }
+
+    // Restoring is not an edit, keep it out of the unsaved changes
+    changes->detach();
+
+    // The handle pool can only be assigned to a registry with nothing alive
+    registry.clear();
+    registry.assign(snapshot.entities.begin(), snapshot.entities.end(), snapshot.released);
+    for (const auto& components : snapshot.components)
+        components->restore(registry);
+
+    rootOrderedEntities = std::move(snapshot.order);
+    for (auto& e : rootOrderedEntities) {
+        e.scene = this;
+    }
+
+    changes->attach(registry);
+    changes->setPending(std::move(snapshot.pending));
+
+    snapshot.entities.clear();
+    snapshot.components.clear();
+    snapshot.valid = false;
+}
+
 Entity Scene::createEntity(const std::string& entityName) {
     Entity entity = { registry.create(), this };
 
@@ -64,12 +201,14 @@ void Scene::render(Graphics::GraphicsContext&   ctx,
                    const Renderer::Camera&      camera,
                    const Graphics::Framebuffer* targetFB) {
 
-    // Ensure all entities have EntityInfo component
-    for (auto& entity : std::ranges::reverse_view(rootOrderedEntities)) {
-        if (!entity.hasComponent<Components::EntityInfoComponent>()) {
-            CORVUS_ERROR("An Entity did not have a EntityInfo component, this should not happen. "
-                         "It has been added automatically.");
-            entity.addComponent<Components::EntityInfoComponent>();
+    // Ensure all entities have EntityInfo component, only walked when the counts disagree
+    if (registry.view<Components::EntityInfoComponent>().size() != registry.alive()) {
+        for (auto& entity : rootOrderedEntities) {
+            if (!entity.hasComponent<Components::EntityInfoComponent>()) {
+                CORVUS_ERROR("An Entity did not have a EntityInfo component, this should not "
+                             "happen. It has been added automatically.");
+                entity.addComponent<Components::EntityInfoComponent>();
+            }
         }
     }
 
@@ -78,6 +217,7 @@ void Scene::render(Graphics::GraphicsContext&   ctx,
         renderer = new Renderer::SceneRenderer(ctx);
     }
 
+    hierarchy->update();
     renderer->renderScene(registry, camera, assetManager, targetFB);
 }
 
@@ -0,0 +1,361 @@
+#include "corvus/scene_binary.hpp"
+
+#include "corvus/components/entity_info.hpp"
+#include "corvus/log.hpp"
+#include "corvus/scene.hpp"
+#include "corvus/util/memory_stream.hpp"
+#include <cereal/archives/json.hpp>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace Corvus::Core::SceneBinary {
+
+namespace {
+    enum class RecordKind : uint8_t {
+        Written,
+        Removed
+    };
+
+    template <typename T>
+    void append(std::vector<char>& out, const T& value) {
+        const auto* bytes = reinterpret_cast<const char*>(&value);
+        out.insert(out.end(), bytes, bytes + sizeof(T));
+    }
+
+    void appendString(std::vector<char>& out, const std::string& value) {
+        append(out, static_cast<uint32_t>(value.size()));
+        out.insert(out.end(), value.begin(), value.end());
+    }
+
+    /**
+     * Bounds checked walk over the file, the mapping may not be aligned for direct loads
+     */
+    class Reader {
+    public:
+        explicit Reader(const std::span<const char> bytes) : bytes_(bytes) { }
+
+        template <typename T>
+        T read() {
+            T value;
+            std::memcpy(&value, take(sizeof(T)).data(), sizeof(T));
+            return value;
+        }
+
+        std::string readString() {
+            const auto size  = read<uint32_t>();
+            const auto chars = take(size);
+            return { chars.begin(), chars.end() };
+        }
+
+        std::span<const char> take(const size_t size) {
+            if (size > bytes_.size() - offset_)
+                throw std::runtime_error("Binary scene is truncated");
+
+            const auto span = bytes_.subspan(offset_, size);
+            offset_ += size;
+            return span;
+        }
+
+        size_t offset() const { return offset_; }
+        bool   atEnd() const { return offset_ == bytes_.size(); }
+
+    private:
+        std::span<const char> bytes_;
+        size_t                offset_ = 0;
+    };
+
+    /**
+     * Files before version 3 store no component versions, every type is read as the version it
+     * had when those files were written
+     */
+    uint32_t legacyComponentVersion(const std::string& typeName) {
+        return typeName == "MeshRenderer" ? 2 : 0;
+    }
+
+    /**
+     * Apply the records of one delta, entities are found by their EntityInfo id
+     */
+    void readDelta(Reader&                                        reader,
+                   const uint32_t                                 fileVersion,
+                   Scene&                                         scene,
+                   std::unordered_map<std::string, entt::entity>& byId) {
+        auto&      registry   = scene.registry;
+        auto&      components = Components::ComponentRegistry::get();
+        const auto types      = components.getRegisteredTypes();
+
+        const auto                      recordCount = reader.read<uint32_t>();
+        std::unordered_set<std::string> written;
+        for (uint32_t record = 0; record < recordCount; ++record) {
+            const auto kind = static_cast<RecordKind>(reader.read<uint8_t>());
+            const auto id   = reader.readString();
+            const auto it   = byId.find(id);
+
+            if (kind == RecordKind::Removed) {
+                if (it != byId.end()) {
+                    scene.getRootOrderedEntities().erase(Entity { it->second, &scene });
+                    registry.destroy(it->second);
+                    byId.erase(it);
+                }
+                continue;
+            }
+
+            // New entities join the end of the order like createEntity does
+            entt::entity entity;
+            if (it != byId.end()) {
+                entity = it->second;
+            } else {
+                entity = registry.create();
+                scene.getRootOrderedEntities().push_back(Entity { entity, &scene });
+                byId.emplace(id, entity);
+            }
+
+            written.clear();
+            const auto componentCount = reader.read<uint32_t>();
+            for (uint32_t i = 0; i < componentCount; ++i) {
+                auto       typeName = reader.readString();
+                const auto schema   = fileVersion >= 3 ? reader.read<uint32_t>()
+                                                       : legacyComponentVersion(typeName);
+                const auto data     = reader.take(static_cast<size_t>(reader.read<uint64_t>()));
+                if (!components.deserializeComponentBinary(
+                        typeName, entity, registry, schema, data)) {
+                    // Dropping a known component would lose it for good on the next save
+                    if (components.isRegistered(typeName))
+                        throw std::runtime_error("Component " + typeName + " version "
+                                                 + std::to_string(schema)
+                                                 + " is newer than this build");
+                    CORVUS_CORE_WARN("Skipped unknown component {} of entity {}", typeName, id);
+                }
+                written.insert(std::move(typeName));
+            }
+
+            // The record holds the whole entity, anything it doesn't name was removed
+            for (const auto& typeName : types) {
+                if (!written.contains(typeName))
+                    components.removeComponent(typeName, entity, registry);
+            }
+        }
+    }
+}
+
+bool isBinary(const std::span<const char> bytes) {
+    return bytes.size() >= sizeof(MAGIC) && std::memcmp(bytes.data(), MAGIC, sizeof(MAGIC)) == 0;
+}
+
+std::vector<char> write(const Scene& scene) {
+    auto& components = Components::ComponentRegistry::get();
+
+    // The block writers only read, they take the registry mutably for its views
+    auto& registry = const_cast<entt::registry&>(scene.registry);
+
+    Components::EntityPositions positions;
+    for (const auto& entity : scene.getRootOrderedEntities())
+        positions.emplace(entt::entity(entity), static_cast<uint32_t>(positions.size()));
+
+    std::vector<std::pair<std::string, Components::ComponentBlock>> blocks;
+    for (const auto& typeName : components.getRegisteredTypes()) {
+        Components::ComponentBlock block;
+        components.writeComponentBlock(typeName, registry, positions, block);
+        if (!block.indices.empty())
+            blocks.emplace_back(typeName, std::move(block));
+    }
+
+    std::vector<char> out(std::begin(MAGIC), std::end(MAGIC));
+    append(out, VERSION);
+    append(out, static_cast<uint32_t>(positions.size()));
+    append(out, static_cast<uint32_t>(blocks.size()));
+    appendString(out, scene.name);
+
+    for (const auto& [typeName, block] : blocks) {
+        appendString(out, typeName);
+        append(out, static_cast<uint32_t>(block.indices.size()));
+        append(out, block.version);
+        append(out, block.stride);
+        append(out, static_cast<uint64_t>(block.data.size()));
+
+        const auto* indices = reinterpret_cast<const char*>(block.indices.data());
+        out.insert(out.end(), indices, indices + block.indices.size() * sizeof(uint32_t));
+        out.insert(out.end(), block.data.begin(), block.data.end());
+    }
+
+    return out;
+}
+
+std::vector<char> writeDelta(const Scene&                        scene,
+                             const std::span<const entt::entity> changed,
+                             const std::span<const std::string>  removed) {
+    auto&      components = Components::ComponentRegistry::get();
+    auto&      registry   = const_cast<entt::registry&>(scene.registry);
+    const auto types      = components.getRegisteredTypes();
+
+    std::vector<char> out(std::begin(DELTA_MAGIC), std::end(DELTA_MAGIC));
+    const size_t      countOffset = out.size();
+    append(out, uint32_t(0));
+
+    uint32_t recordCount = 0;
+    for (const auto& id : removed) {
+        append(out, static_cast<uint8_t>(RecordKind::Removed));
+        appendString(out, id);
+        ++recordCount;
+    }
+
+    std::string data;
+    uint32_t    version = 0;
+    for (const auto entity : changed) {
+        // Entities lose their info only on the way to being repaired, the repair is saved later
+        if (!registry.valid(entity) || !registry.all_of<Components::EntityInfoComponent>(entity))
+            continue;
+
+        append(out, static_cast<uint8_t>(RecordKind::Written));
+        appendString(out, registry.get<Components::EntityInfoComponent>(entity).id);
+
+        const size_t componentOffset = out.size();
+        uint32_t     componentCount  = 0;
+        append(out, componentCount);
+        for (const auto& typeName : types) {
+            if (!components.serializeComponentBinary(typeName, entity, registry, data, version))
+                continue;
+
+            appendString(out, typeName);
+            append(out, version);
+            append(out, static_cast<uint64_t>(data.size()));
+            out.insert(out.end(), data.begin(), data.end());
+            ++componentCount;
+        }
+        std::memcpy(out.data() + componentOffset, &componentCount, sizeof(componentCount));
+        ++recordCount;
+    }
+
+    std::memcpy(out.data() + countOffset, &recordCount, sizeof(recordCount));
+    return out;
+}
+
+bool read(Scene& scene, const std::span<const char> bytes) {
+    if (!isBinary(bytes)) {
+        CORVUS_CORE_ERROR("Not a binary scene");
+        return false;
+    }
+
+    try {
+        Reader reader(bytes);
+        reader.take(sizeof(MAGIC));
+
+        const auto version = reader.read<uint32_t>();
+        if (version == 0 || version > VERSION) {
+            CORVUS_CORE_ERROR("Binary scene version {} is not supported (expected {})",
+                              version,
+                              VERSION);
+            return false;
+        }
+
+        const auto entityCount = reader.read<uint32_t>();
+        const auto blockCount  = reader.read<uint32_t>();
+        scene.name             = reader.readString();
+
+        auto& registry = scene.registry;
+        auto& entities = scene.getRootOrderedEntities();
+        registry.clear();
+        entities.clear();
+
+        std::vector<entt::entity> handles(entityCount);
+        registry.create(handles.begin(), handles.end());
+        for (const auto handle : handles)
+            entities.push_back(Entity { handle, &scene });
+
+        auto&                     components = Components::ComponentRegistry::get();
+        std::vector<entt::entity> owners;
+        for (uint32_t block = 0; block < blockCount; ++block) {
+            const auto typeName = reader.readString();
+            const auto count    = reader.read<uint32_t>();
+            const auto schema   = version >= 3 ? reader.read<uint32_t>()
+                                               : legacyComponentVersion(typeName);
+            const auto stride   = reader.read<uint32_t>();
+            const auto dataSize = reader.read<uint64_t>();
+            const auto indices  = reader.take(static_cast<size_t>(count) * sizeof(uint32_t));
+            const auto data     = reader.take(static_cast<size_t>(dataSize));
+
+            owners.resize(count);
+            for (uint32_t i = 0; i < count; ++i) {
+                uint32_t index;
+                std::memcpy(&index, indices.data() + i * sizeof(uint32_t), sizeof(uint32_t));
+                if (index >= entityCount)
+                    throw std::runtime_error("Component block " + typeName + " is corrupt");
+                owners[i] = handles[index];
+            }
+
+            if (components.readComponentBlock(typeName, registry, owners, schema, stride, data))
+                continue;
+
+            // Skipping a known type would drop its components from the file on the next save
+            if (components.isRegistered(typeName))
+                throw std::runtime_error("Component block " + typeName + " (version "
+                                         + std::to_string(schema) + ", stride "
+                                         + std::to_string(stride)
+                                         + ") is newer than this build or can't be migrated");
+            CORVUS_CORE_WARN("Skipped component block {} ({} components), the type is unknown",
+                             typeName,
+                             count);
+        }
+
+        // Changes saved since the blocks were written
+        const size_t                                  baseBytes  = reader.offset();
+        uint32_t                                      deltaCount = 0;
+        std::unordered_map<std::string, entt::entity> byId;
+        while (!reader.atEnd()) {
+            const auto magic = reader.take(sizeof(DELTA_MAGIC));
+            if (std::memcmp(magic.data(), DELTA_MAGIC, sizeof(DELTA_MAGIC)) != 0)
+                throw std::runtime_error("Binary scene has trailing data that is not a delta");
+
+            if (deltaCount++ == 0) {
+                for (const auto entity : registry.view<Components::EntityInfoComponent>())
+                    byId.emplace(registry.get<Components::EntityInfoComponent>(entity).id, entity);
+            }
+            readDelta(reader, version, scene, byId);
+        }
+
+        // Loading is not a change, the file on disk holds exactly this. Deltas are only appended
+        // to files of the current version, older ones are rewritten by the next save.
+        scene.getChanges().clear();
+        if (version == VERSION)
+            scene.getChanges().setSaved(baseBytes, bytes.size() - baseBytes);
+        else
+            scene.getChanges().setSaved(0, 0);
+
+        CORVUS_CORE_TRACE("Binary scene {} read, {} entities in {} blocks and {} deltas",
+                          scene.name,
+                          entityCount,
+                          blockCount,
+                          deltaCount);
+        return true;
+    } catch (const std::exception& e) {
+        CORVUS_CORE_ERROR("Failed to read binary scene: {}", e.what());
+        return false;
+    }
+}
+
+std::vector<char> fromJson(const std::span<const char> json) {
+    Scene scene("Converting...", nullptr);
+    {
+        MemoryInputStream        stream(json);
+        cereal::JSONInputArchive ar(stream);
+        ar(cereal::make_nvp("scene", scene));
+    }
+    return write(scene);
+}
+
+std::string toJson(const std::span<const char> binary) {
+    Scene scene("Converting...", nullptr);
+    if (!read(scene, binary))
+        throw std::runtime_error("Invalid binary scene");
+
+    std::ostringstream stream;
+    {
+        cereal::JSONOutputArchive ar(stream);
+        ar(cereal::make_nvp("scene", scene));
+    }
+    return stream.str();
+}
+
+}
@@ -0,0 +1,79 @@
+#include "corvus/scene_changes.hpp"
+
+#include "corvus/components/entity_info.hpp"
+
+namespace Corvus::Core {
+
+SceneChanges::~SceneChanges() { detach(); }
+
+void SceneChanges::attach(entt::registry& registry) {
+    detach();
+    registry_ = &registry;
+
+    Components::ComponentRegistry::get().connectListener(registry, *this);
+    registry.on_destroy<Components::EntityInfoComponent>().connect<&SceneChanges::onInfoDestroyed>(
+        *this);
+}
+
+void SceneChanges::detach() {
+    if (!registry_)
+        return;
+
+    Components::ComponentRegistry::get().disconnectListener(*registry_, *this);
+    registry_->on_destroy<Components::EntityInfoComponent>().disconnect(*this);
+    registry_ = nullptr;
+}
+
+void SceneChanges::onComponentChanged(const entt::entity entity) {
+    std::lock_guard lock(mutex_);
+    changed_.insert(entity);
+}
+
+void SceneChanges::onInfoDestroyed(entt::registry& registry, const entt::entity entity) {
+    std::lock_guard lock(mutex_);
+    removed_.push_back(registry.get<Components::EntityInfoComponent>(entity).id);
+}
+
+bool SceneChanges::hasChanges() const {
+    std::lock_guard lock(mutex_);
+    return !changed_.empty() || !removed_.empty();
+}
+
+void SceneChanges::take(std::vector<entt::entity>& changed, std::vector<std::string>& removed) {
+    std::lock_guard lock(mutex_);
+
+    changed.clear();
+    changed.reserve(changed_.size());
+    for (const auto entity : changed_) {
+        if (registry_ && registry_->valid(entity))
+            changed.push_back(entity);
+    }
+
+    removed = std::move(removed_);
+    changed_.clear();
+    removed_.clear();
+}
+
+void SceneChanges::clear() {
+    std::lock_guard lock(mutex_);
+    changed_.clear();
+    removed_.clear();
+}
+
+SceneChanges::Pending SceneChanges::getPending() const {
+    std::lock_guard lock(mutex_);
+    return { changed_, removed_ };
+}
+
+void SceneChanges::setPending(Pending pending) {
+    std::lock_guard lock(mutex_);
+    changed_ = std::move(pending.changed);
+    removed_ = std::move(pending.removed);
+}
+
+void SceneChanges::setSaved(const size_t baseBytes, const size_t deltaBytes) {
+    savedBaseBytes_  = baseBytes;
+    savedDeltaBytes_ = deltaBytes;
+}
+
+}
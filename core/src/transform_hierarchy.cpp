@@ -0,0 +1,277 @@
+#include "corvus/transform_hierarchy.hpp"
+
+#include "corvus/components/entity_info.hpp"
+#include "corvus/jobs/job_system.hpp"
+#include "corvus/log.hpp"
+#include "corvus/renderer/batch_transform.hpp"
+#include <algorithm>
+#include <string_view>
+
+namespace Corvus::Core {
+
+using Components::EntityInfoComponent;
+using Components::ParentComponent;
+using Components::TransformComponent;
+using Components::WorldTransformComponent;
+
+namespace {
+    // Entities of one depth per job, a job only reads the finished level above it
+    constexpr size_t HIERARCHY_GRAIN = 2048;
+    // Edited poses per job when building local matrices
+    constexpr size_t COMPOSE_GRAIN = 4096;
+
+    const glm::mat4 IDENTITY(1.0f);
+}
+
+TransformHierarchy::~TransformHierarchy() { detach(); }
+
+void TransformHierarchy::attach(entt::registry& registry) {
+    detach();
+    registry_ = &registry;
+
+    registry.on_construct<TransformComponent>().connect<&TransformHierarchy::onTransformAdded>(
+        *this);
+    registry.on_update<TransformComponent>().connect<&TransformHierarchy::onTransformChanged>(
+        *this);
+    registry.on_destroy<TransformComponent>().connect<&TransformHierarchy::onStructureChanged>(
+        *this);
+    registry.on_construct<ParentComponent>().connect<&TransformHierarchy::onStructureChanged>(
+        *this);
+    registry.on_update<ParentComponent>().connect<&TransformHierarchy::onStructureChanged>(*this);
+    registry.on_destroy<ParentComponent>().connect<&TransformHierarchy::onStructureChanged>(*this);
+
+    structureChanged_ = true;
+}
+
+void TransformHierarchy::detach() {
+    if (registry_) {
+        registry_->on_construct<TransformComponent>().disconnect(*this);
+        registry_->on_update<TransformComponent>().disconnect(*this);
+        registry_->on_destroy<TransformComponent>().disconnect(*this);
+        registry_->on_construct<ParentComponent>().disconnect(*this);
+        registry_->on_update<ParentComponent>().disconnect(*this);
+        registry_->on_destroy<ParentComponent>().disconnect(*this);
+        registry_ = nullptr;
+    }
+
+    entities_.clear();
+    parents_.clear();
+    local_.clear();
+    world_.clear();
+    flags_.clear();
+    levels_.clear();
+    indices_.clear();
+    added_.clear();
+}
+
+void TransformHierarchy::onStructureChanged(entt::registry&, entt::entity) {
+    structureChanged_.store(true, std::memory_order_relaxed);
+}
+
+void TransformHierarchy::onTransformAdded(entt::registry&, const entt::entity entity) {
+    // Components are only added outside of system stages, never from two threads at once
+    added_.push_back(entity);
+    structureChanged_.store(true, std::memory_order_relaxed);
+}
+
+void TransformHierarchy::onTransformChanged(entt::registry&, const entt::entity entity) {
+    // Systems patching in parallel always touch different entities, so the flags never collide
+    if (const auto it = indices_.find(entity); it != indices_.end()) {
+        flags_[it->second] |= LOCAL_DIRTY;
+        pending_.store(true, std::memory_order_relaxed);
+    }
+}
+
+const glm::mat4& TransformHierarchy::getWorldMatrix(const entt::entity entity) const {
+    const auto it = indices_.find(entity);
+    return it != indices_.end() ? world_[it->second] : IDENTITY;
+}
+
+entt::entity TransformHierarchy::getParent(const entt::entity entity) const {
+    const auto it = indices_.find(entity);
+    if (it == indices_.end() || parents_[it->second] == NO_PARENT)
+        return entt::null;
+    return entities_[parents_[it->second]];
+}
+
+void TransformHierarchy::update() {
+    updated_ = 0;
+    if (!registry_)
+        return;
+
+    if (structureChanged_.exchange(false, std::memory_order_relaxed))
+        rebuild();
+    else if (!pending_.load(std::memory_order_relaxed))
+        return;
+    pending_.store(false, std::memory_order_relaxed);
+
+    // Edited poses are gathered into arrays so their local matrices are built several at a time
+    editedIndices_.clear();
+    editedPoses_.clear();
+    for (uint32_t i = 0; i < entities_.size(); ++i) {
+        if (!(flags_[i] & LOCAL_DIRTY))
+            continue;
+
+        const auto& transform = registry_->get<TransformComponent>(entities_[i]);
+        editedIndices_.push_back(i);
+        editedPoses_.push(transform.position, transform.rotation, transform.scale);
+    }
+
+    auto& jobs = JobSystem::get();
+    editedLocal_.resize(editedIndices_.size());
+    jobs.parallelFor(
+        0, editedIndices_.size(), COMPOSE_GRAIN, [this](const size_t first, const size_t last) {
+            Renderer::composeMatrices(editedPoses_, first, last, editedLocal_.data());
+            for (size_t k = first; k < last; ++k)
+                local_[editedIndices_[k]] = editedLocal_[k];
+        });
+
+    for (size_t level = 0; level + 1 < levels_.size(); ++level) {
+        jobs.parallelFor(
+            levels_[level], levels_[level + 1], HIERARCHY_GRAIN, [&](size_t first, size_t last) {
+                for (size_t i = first; i < last; ++i) {
+                    uint8_t        flags  = flags_[i];
+                    const uint32_t parent = parents_[i];
+
+                    if (flags & LOCAL_DIRTY)
+                        flags |= WORLD_DIRTY;
+                    if (parent != NO_PARENT && (flags_[parent] & WORLD_DIRTY))
+                        flags |= WORLD_DIRTY;
+
+                    if (flags & WORLD_DIRTY)
+                        world_[i] = parent == NO_PARENT ? local_[i] : world_[parent] * local_[i];
+                    flags_[i] = flags;
+                }
+            });
+    }
+
+    for (size_t i = 0; i < entities_.size(); ++i) {
+        if (!(flags_[i] & WORLD_DIRTY)) {
+            flags_[i] = 0;
+            continue;
+        }
+
+        registry_->get<WorldTransformComponent>(entities_[i]).matrix = world_[i];
+        registry_->patch<WorldTransformComponent>(entities_[i]);
+        flags_[i] = 0;
+        ++updated_;
+    }
+}
+
+void TransformHierarchy::rebuild() {
+    auto& registry = *registry_;
+
+    // Entities that lost their transform keep no stale world matrix
+    std::vector<entt::entity> orphaned;
+    for (const auto entity :
+         registry.view<WorldTransformComponent>(entt::exclude<TransformComponent>))
+        orphaned.push_back(entity);
+    for (const auto entity : orphaned)
+        registry.remove<WorldTransformComponent>(entity);
+
+    // Parent links name EntityInfo ids
+    std::unordered_map<std::string_view, entt::entity> byId;
+    std::unordered_map<entt::entity, entt::entity>     parentOf;
+    if (registry.view<ParentComponent>().size() > 0) {
+        for (const auto entity : registry.view<EntityInfoComponent, TransformComponent>())
+            byId.emplace(registry.get<EntityInfoComponent>(entity).id, entity);
+
+        for (const auto entity : registry.view<ParentComponent, TransformComponent>()) {
+            const auto it = byId.find(registry.get<ParentComponent>(entity).parent);
+            if (it != byId.end() && it->second != entity)
+                parentOf.emplace(entity, it->second);
+        }
+    }
+
+    auto       view  = registry.view<TransformComponent>();
+    const auto count = static_cast<uint32_t>(view.size());
+
+    std::vector<entt::entity> unsorted;
+    std::vector<uint32_t>     depths;
+    unsorted.reserve(count);
+    depths.reserve(count);
+
+    for (const auto entity : view) {
+        uint32_t     depth   = 0;
+        entt::entity current = entity;
+        for (auto it = parentOf.find(current); it != parentOf.end(); it = parentOf.find(current)) {
+            current = it->second;
+            if (++depth > count)
+                break;
+        }
+
+        // Walking further up than there are entities means the links loop, cut this one
+        if (depth > count) {
+            CORVUS_CORE_WARN("Transform parent cycle at entity {}, it is placed at the root",
+                             static_cast<uint32_t>(entity));
+            parentOf.erase(entity);
+            depth = 0;
+        }
+
+        unsorted.push_back(entity);
+        depths.push_back(depth);
+    }
+
+    // Counting sort by depth, entities keep their pool order within a level
+    levels_.assign(1, 0);
+    for (const uint32_t depth : depths) {
+        if (depth + 2 > levels_.size())
+            levels_.resize(depth + 2, 0);
+        ++levels_[depth + 1];
+    }
+    for (size_t level = 1; level < levels_.size(); ++level)
+        levels_[level] += levels_[level - 1];
+
+    std::vector<uint32_t>     cursor(levels_.begin(), levels_.end() - 1);
+    std::vector<entt::entity> sorted(count);
+    for (uint32_t i = 0; i < count; ++i)
+        sorted[cursor[depths[i]]++] = unsorted[i];
+
+    std::unordered_map<entt::entity, uint32_t> indices;
+    indices.reserve(count);
+    for (uint32_t i = 0; i < count; ++i)
+        indices.emplace(sorted[i], i);
+
+    std::vector<uint32_t> parents(count);
+    for (uint32_t i = 0; i < count; ++i) {
+        const auto it = parentOf.find(sorted[i]);
+        parents[i]    = it != parentOf.end() ? indices[it->second] : NO_PARENT;
+    }
+
+    // Entities laid out before keep their matrices and pending edits. Only new ones, those whose
+    // transform was added again and those under a different parent start dirty, so spawning one
+    // entity doesn't patch every world transform in the scene.
+    std::sort(added_.begin(), added_.end());
+    std::vector<glm::mat4> local(count), world(count);
+    std::vector<uint8_t>   flags(count, LOCAL_DIRTY);
+    for (uint32_t i = 0; i < count; ++i) {
+        const entt::entity entity = sorted[i];
+        const auto         old    = indices_.find(entity);
+        if (old == indices_.end() || std::binary_search(added_.begin(), added_.end(), entity)
+            || !registry.all_of<WorldTransformComponent>(entity))
+            continue;
+
+        const uint32_t     oldParent = parents_[old->second];
+        const entt::entity before    = oldParent == NO_PARENT ? entt::null : entities_[oldParent];
+        const entt::entity now       = parents[i] == NO_PARENT ? entt::null : sorted[parents[i]];
+        if (before != now)
+            continue;
+
+        local[i] = local_[old->second];
+        world[i] = world_[old->second];
+        flags[i] = flags_[old->second];
+    }
+    added_.clear();
+
+    entities_ = std::move(sorted);
+    indices_  = std::move(indices);
+    parents_  = std::move(parents);
+    local_    = std::move(local);
+    world_    = std::move(world);
+    flags_    = std::move(flags);
+
+    for (const auto entity : entities_)
+        registry.get_or_emplace<WorldTransformComponent>(entity);
+}
+
+}
@@ -188,6 +188,9 @@ struct ComponentInfo<Core::Components::MeshRendererComponent> {
         if (needsRegen && renderer.primitiveType != PrimitiveType::Model)
             renderer.generateModel(*ctx);
 
+        ImGui::Checkbox("Cast Shadows", &renderer.castShadows);
+        ImGui::Checkbox("Static", &renderer.isStatic);
+
         // Material Dropdown
         if (assetMgr) {
             ImGui::Columns(2, "##MaterialColumns", false);
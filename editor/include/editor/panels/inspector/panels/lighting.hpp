@@ -169,7 +169,7 @@ struct ComponentInfo<Core::Components::LightComponent> {
             if (light.type == Core::Components::LightType::Directional) {
                 ImGui::FloatEditor("Shadow Distance", light.shadowDistance, 5.0f, 1.0f, 200.0f);
                 if (ImGui::IsItemHovered()) {
-                    ImGui::SetTooltip("How far shadows render from center");
+                    ImGui::SetTooltip("How far from the camera shadow cascades reach");
                 }
             }
 
@@ -118,6 +118,10 @@ private:
     EditorCamera editorCamera;
     EditorGizmo  editorGizmo;
 
+    // World space pose the gizmo edits for parented entities, a member so it keeps its address
+    // while dragging
+    Core::Components::TransformComponent gizmoWorldTransform;
+
     // Rendering resources
     Graphics::Framebuffer framebuffer;
     Graphics::Texture2D   colorTexture;
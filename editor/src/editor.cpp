@@ -118,6 +118,16 @@ void EditorLayer::renderMenuBar() {
                 }
             }
 
+            // Takes effect on the next save, the scene keeps its format from then on
+            if (currentProject) {
+                if (const auto scene = currentProject->getCurrentScene()) {
+                    bool binary = scene->format == Core::SceneFormat::Binary;
+                    if (ImGui::MenuItem("Save As Binary", nullptr, &binary))
+                        scene->format
+                            = binary ? Core::SceneFormat::Binary : Core::SceneFormat::Json;
+                }
+            }
+
             ImGui::Separator();
 
             if (ImGui::MenuItem("Exit")) {
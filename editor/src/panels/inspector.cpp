@@ -97,6 +97,9 @@ void InspectorPanel::drawComponentImpl(Core::Entity               entity,
         ImGui::PushID(reinterpret_cast<void*>(typeid(T).hash_code()));
         ComponentInfo<T>::draw(component, assetManager, ctx);
         ImGui::PopID();
+
+        // Widgets write straight into the component, patch it so the render world sees the edit
+        entity.patchComponent<T>();
     } else {
         constexpr ImGuiTreeNodeFlags treeNodeFlags = ImGuiTreeNodeFlags_DefaultOpen
             | ImGuiTreeNodeFlags_Framed | ImGuiTreeNodeFlags_SpanAvailWidth
@@ -137,6 +140,9 @@ void InspectorPanel::drawComponentImpl(Core::Entity               entity,
             ComponentInfo<T>::draw(component, assetManager, ctx);
             ImGui::PopID();
             ImGui::TreePop();
+
+            // Only the selected entity is drawn, so patching every frame stays one entity
+            entity.patchComponent<T>();
         }
 
         if (removeComponent) {
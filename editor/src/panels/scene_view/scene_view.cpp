@@ -103,9 +103,13 @@ void SceneViewPanel::handleShortcuts() {
         return;
 
     if (ImGui::IsKeyPressed(ImGuiKey_F) && sceneHierarchyPanel->selectedEntity) {
-        auto tr = sceneHierarchyPanel->selectedEntity
-                      .getComponent<Core::Components::TransformComponent>();
-        viewport.getCamera().focusOn(tr.position);
+        auto& entity = sceneHierarchyPanel->selectedEntity;
+        if (entity.hasComponent<Core::Components::WorldTransformComponent>())
+            viewport.getCamera().focusOn(
+                entity.getComponent<Core::Components::WorldTransformComponent>().getPosition());
+        else
+            viewport.getCamera().focusOn(
+                entity.getComponent<Core::Components::TransformComponent>().position);
     }
 
     static const std::unordered_map<ImGuiKey, EditorGizmo::Mode> map
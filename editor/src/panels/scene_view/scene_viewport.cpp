@@ -30,6 +30,7 @@ SceneViewport::SceneViewport(Core::Project& project, Graphics::GraphicsContext&
     const std::string vsSrc(vsBytes.begin(), vsBytes.end());
     const std::string fsSrc(fsBytes.begin(), fsBytes.end());
     gridShader = ctx.createShader(vsSrc, fsSrc);
+    CORVUS_GPU_LABEL(gridShader, "Editor Grid Shader");
 
     struct GridVertex {
         glm::vec3 pos;
@@ -109,6 +110,9 @@ void SceneViewport::manageFramebuffer(const ImVec2& size) {
 
     framebuffer.attachTexture2D(colorTexture, 0);
     framebuffer.attachDepthTexture(depthTexture);
+    CORVUS_GPU_LABEL(framebuffer, "Scene Viewport FBO");
+    CORVUS_GPU_LABEL(colorTexture, "Scene Viewport Color");
+    CORVUS_GPU_LABEL(depthTexture, "Scene Viewport Depth");
 
     framebuffer.width   = width;
     framebuffer.height  = height;
@@ -137,6 +141,7 @@ void SceneViewport::renderSceneToFramebuffer(Core::Entity*    selectedEntity,
     {
         Graphics::CommandBuffer cmd = ctx.createCommandBuffer();
         cmd.begin();
+        CORVUS_GPU_PUSH_GROUP(cmd, "Editor Grid");
         cmd.bindFramebuffer(framebuffer);
         cmd.setViewport(0, 0, static_cast<uint32_t>(currentSize.x), static_cast<uint32_t>(currentSize.y));
         cmd.executeCallback([]() { glFrontFace(GL_CCW); });
@@ -144,6 +149,7 @@ void SceneViewport::renderSceneToFramebuffer(Core::Entity*    selectedEntity,
         cmd.clear(64.f / 255.0f, 64.f / 255.0f, 64.f / 255.0f, 1.f, true, true);
         renderGrid(cmd, view, proj, camPos);
         cmd.unbindFramebuffer();
+        CORVUS_GPU_POP_GROUP(cmd);
         cmd.end();
         cmd.submit();
     }
@@ -155,24 +161,43 @@ void SceneViewport::renderSceneToFramebuffer(Core::Entity*    selectedEntity,
     if (selectedEntity && *selectedEntity
         && selectedEntity->hasComponent<Core::Components::TransformComponent>()) {
 
-        auto& tr = selectedEntity->getComponent<Core::Components::TransformComponent>();
+        using Core::Components::TransformComponent;
+        auto& tr = selectedEntity->getComponent<TransformComponent>();
+
+        // The gizmo works in world space, children go through their parent's world matrix
+        auto&              hierarchy   = project.getCurrentScene()->getHierarchy();
+        const entt::entity parent      = hierarchy.getParent(entt::entity(*selectedEntity));
+        const glm::mat4&   parentWorld = hierarchy.getWorldMatrix(parent);
+        if (parent != entt::null)
+            gizmoWorldTransform = TransformComponent::fromMatrix(parentWorld * tr.getMatrix());
+        TransformComponent& target = parent != entt::null ? gizmoWorldTransform : tr;
+
         Graphics::CommandBuffer cmd = ctx.createCommandBuffer();
         cmd.begin();
+        CORVUS_GPU_PUSH_GROUP(cmd, "Editor Gizmo");
         cmd.bindFramebuffer(framebuffer);
         cmd.setViewport(0, 0, static_cast<uint32_t>(currentSize.x), static_cast<uint32_t>(currentSize.y));
-        editorGizmo.render(cmd,
-                           tr,
-                           mousePos,
-                           mousePressed,
-                           mouseDown && mouseInViewport,
-                           currentSize.x,
-                           currentSize.y,
-                           view,
-                           proj,
-                           camPos);
+        const bool dragging = editorGizmo.render(cmd,
+                                                 target,
+                                                 mousePos,
+                                                 mousePressed,
+                                                 mouseDown && mouseInViewport,
+                                                 currentSize.x,
+                                                 currentSize.y,
+                                                 view,
+                                                 proj,
+                                                 camPos);
         cmd.unbindFramebuffer();
+        CORVUS_GPU_POP_GROUP(cmd);
         cmd.end();
         cmd.submit();
+
+        // The gizmo writes the transform directly, let the render world pick up the new pose
+        if (dragging) {
+            if (parent != entt::null)
+                tr = TransformComponent::fromMatrix(glm::inverse(parentWorld) * target.getMatrix());
+            selectedEntity->patchComponent<TransformComponent>();
+        }
     }
 }
 
@@ -221,11 +246,11 @@ Core::Entity SceneViewport::pickEntity(const glm::vec2& mousePos) {
             || !e.hasComponent<Core::Components::TransformComponent>())
             continue;
 
-        auto& [position, rotation, scale] = e.getComponent<Core::Components::TransformComponent>();
         auto& mr = e.getComponent<Core::Components::MeshRendererComponent>();
 
-        glm::mat4 model = glm::translate(glm::mat4(1.0f), position) * glm::toMat4(rotation)
-            * glm::scale(glm::mat4(1.0f), scale);
+        // Cached by the hierarchy when the scene was last rendered
+        const glm::mat4& model
+            = project.getCurrentScene()->getHierarchy().getWorldMatrix(entt::entity(e));
 
         Geometry::RaycastHit hit;
 
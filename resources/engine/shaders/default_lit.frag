@@ -1,5 +1,19 @@
 #version 330
 
+// Variants, defined by the renderer after the version line
+//   GBUFFER_PASS       write surface data to the G-buffer instead of shading
+//   DEFERRED_LIGHTING  full screen pass shading the surface data read back from the G-buffer
+//   WEIGHTED_BLENDED   accumulate into the order-independent transparency targets
+
+#ifdef DEFERRED_LIGHTING
+in vec2 screenUV;
+
+// G-buffer, albedo + metallic, world normal + smoothness and depth
+uniform sampler2D u_GBufferAlbedo;
+uniform sampler2D u_GBufferNormal;
+uniform sampler2D u_GBufferDepth;
+uniform mat4      u_InverseViewProjection;
+#else
 // Inputs from vertex shader
 in vec2 fragTexCoord;
 in vec4 fragColor;
@@ -11,6 +25,11 @@ uniform sampler2D texture0;
 uniform vec4      _MainColor;
 uniform float     _Metallic;
 uniform float     _Smoothness;
+#endif
+
+// Camera
+uniform mat4 u_View;
+uniform mat4 u_ViewProjection;
 
 // Lighting uniforms
 uniform vec3 u_ViewPos;
@@ -24,8 +43,6 @@ struct PointLight {
     vec3  color;
     float range;
 };
-uniform int        u_PointLightCount;
-uniform PointLight u_PointLights[16];
 
 // Spot lights
 struct SpotLight {
@@ -36,26 +53,43 @@ struct SpotLight {
     float innerCutoff;
     float outerCutoff;
 };
-uniform int       u_SpotLightCount;
-uniform SpotLight u_SpotLights[16];
-uniform int       u_SpotLightShadowIndices[16];
-
-// Standard shadow uniforms (directional/spot)
-uniform int       u_ShadowMapCount;
-uniform sampler2D u_ShadowMaps[4];
-uniform mat4      u_LightSpaceMatrices[4];
-uniform float     u_ShadowBias[4];
-uniform float     u_ShadowStrength[4];
-
-// Point light shadow uniforms
-uniform int         u_PointLightShadowCount;
-uniform samplerCube u_PointLightShadowMaps[4];
-uniform vec3        u_PointLightShadowPositions[4];
-uniform float       u_PointLightShadowFarPlanes[4];
-uniform int         u_PointLightShadowIndices[4]; // Maps shadow index to point light index
+
+// Clustered lights, 4 texels per light in u_ClusterLights and (offset, count) per cluster
+uniform samplerBuffer  u_ClusterLights;
+uniform usamplerBuffer u_ClusterGrid;
+uniform usamplerBuffer u_ClusterIndices;
+uniform vec3           u_ClusterDims;
+uniform float          u_ClusterNear;
+uniform float          u_ClusterLogScale;
+
+// Directional light cascades
+uniform int            u_CascadeCount;
+uniform sampler2DArray u_CascadeShadowMap;
+uniform mat4           u_CascadeMatrices[4];
+uniform vec4           u_CascadeSplits; // View space far distance of each cascade
+uniform float          u_CascadeBias;
+uniform float          u_CascadeStrength;
+
+// Spot and point light shadows, tiles of one atlas described by per-light texels in u_ShadowData
+uniform sampler2D     u_ShadowAtlas;
+uniform samplerBuffer u_ShadowData;
+
+// Cube face basis, must match LightingSystem::calculatePointLightMatrices
+const vec3 CUBE_FACE_DIRS[6] = vec3[6](
+    vec3(1, 0, 0), vec3(-1, 0, 0), vec3(0, 1, 0), vec3(0, -1, 0), vec3(0, 0, 1), vec3(0, 0, -1));
+const vec3 CUBE_FACE_UPS[6] = vec3[6](
+    vec3(0, -1, 0), vec3(0, -1, 0), vec3(0, 0, 1), vec3(0, 0, -1), vec3(0, -1, 0), vec3(0, -1, 0));
 
 // Output
+#if defined(GBUFFER_PASS)
+layout(location = 0) out vec4 gAlbedo;
+layout(location = 1) out vec4 gNormal;
+#elif defined(WEIGHTED_BLENDED)
+layout(location = 0) out vec4 oitAccum;  // Weighted premultiplied color, alpha for revealage
+layout(location = 1) out vec4 oitWeight; // Weighted alpha
+#else
 out vec4 finalColor;
+#endif
 
 // Simple PBR-ish lighting for directional light
 vec3 calculateDirectionalLight(
@@ -116,12 +150,35 @@ vec3 calculatePointLight(PointLight light,
     return ((kD * diffuse) + specular) * attenuation;
 }
 
-// Spot light shadow calculation
-float calculateSpotLightShadow(vec3 fragPos, int shadowIndex) {
-    if (u_ShadowMapCount == 0 || shadowIndex >= u_ShadowMapCount || shadowIndex < 0)
-        return 0.0;
+// 3x3 PCF inside one atlas tile, rect is (offset, scale) and samples are clamped to the tile
+float sampleShadowTile(vec4 rect, vec2 tileCoords, float currentDepth, float bias) {
+    vec2 texelSize = 1.0 / vec2(textureSize(u_ShadowAtlas, 0));
+    vec2 minCoords = rect.xy + texelSize * 0.5;
+    vec2 maxCoords = rect.xy + rect.zw - texelSize * 0.5;
+    vec2 coords    = rect.xy + tileCoords * rect.zw;
 
-    vec4 fragPosLightSpace = u_LightSpaceMatrices[shadowIndex] * vec4(fragPos, 1.0);
+    float shadow = 0.0;
+    for (int x = -1; x <= 1; ++x) {
+        for (int y = -1; y <= 1; ++y) {
+            vec2  sampleCoords = clamp(coords + vec2(x, y) * texelSize, minCoords, maxCoords);
+            float pcfDepth     = texture(u_ShadowAtlas, sampleCoords).r;
+            shadow += (pcfDepth + bias) < currentDepth ? 1.0 : 0.0;
+        }
+    }
+
+    return shadow / 9.0;
+}
+
+// Spot light shadow, data is the light matrix, tile rect and (bias, strength)
+float calculateSpotLightShadow(vec3 fragPos, int shadowOffset) {
+    mat4 lightSpaceMatrix = mat4(texelFetch(u_ShadowData, shadowOffset),
+                                 texelFetch(u_ShadowData, shadowOffset + 1),
+                                 texelFetch(u_ShadowData, shadowOffset + 2),
+                                 texelFetch(u_ShadowData, shadowOffset + 3));
+    vec4 rect             = texelFetch(u_ShadowData, shadowOffset + 4);
+    vec4 params           = texelFetch(u_ShadowData, shadowOffset + 5);
+
+    vec4 fragPosLightSpace = lightSpaceMatrix * vec4(fragPos, 1.0);
     vec3 projCoords        = fragPosLightSpace.xyz / fragPosLightSpace.w;
     projCoords             = projCoords * 0.5 + 0.5;
 
@@ -130,22 +187,7 @@ float calculateSpotLightShadow(vec3 fragPos, int shadowIndex) {
         || projCoords.y > 1.0)
         return 0.0;
 
-    float currentDepth = projCoords.z;
-    float bias         = u_ShadowBias[shadowIndex];
-    float shadow       = 0.0;
-    vec2  texelSize    = 1.0 / textureSize(u_ShadowMaps[shadowIndex], 0);
-
-    // 3x3 PCF
-    for (int x = -1; x <= 1; ++x) {
-        for (int y = -1; y <= 1; ++y) {
-            vec2  offset   = vec2(x, y) * texelSize;
-            float pcfDepth = texture(u_ShadowMaps[shadowIndex], projCoords.xy + offset).r;
-            shadow += (pcfDepth + bias) < currentDepth ? 1.0 : 0.0;
-        }
-    }
-    shadow /= 9.0;
-
-    return shadow * u_ShadowStrength[shadowIndex];
+    return sampleShadowTile(rect, projCoords.xy, projCoords.z, params.x) * params.y;
 }
 
 // Spot light calculation
@@ -192,79 +234,103 @@ vec3 calculateSpotLight(SpotLight light,
     return ((kD * diffuse) + specular) * attenuation * spotIntensity;
 }
 
-// Standard shadow calculation (directional/spot) with PCF
-float calculateShadow(vec3 fragPos, int shadowIndex) {
-    if (u_ShadowMapCount == 0 || shadowIndex >= u_ShadowMapCount || shadowIndex < 0)
-        return 0.0;
-
-    vec4 fragPosLightSpace = u_LightSpaceMatrices[shadowIndex] * vec4(fragPos, 1.0);
+// Single cascade lookup with 3x3 PCF
+float sampleCascade(vec3 fragPos, int cascade) {
+    vec4 fragPosLightSpace = u_CascadeMatrices[cascade] * vec4(fragPos, 1.0);
     vec3 projCoords        = fragPosLightSpace.xyz / fragPosLightSpace.w;
     projCoords             = projCoords * 0.5 + 0.5;
 
-    if (projCoords.z > 1.0 || projCoords.x < 0.0 || projCoords.x > 1.0 || projCoords.y < 0.0
-        || projCoords.y > 1.0) {
+    if (projCoords.z > 1.0)
         return 0.0;
-    }
 
     float currentDepth = projCoords.z;
-    if (currentDepth > 1.0) {
-        return 0.0;
-    }
-
-    float bias      = u_ShadowBias[shadowIndex];
-    float shadow    = 0.0;
-    vec2  texelSize = 1.0 / textureSize(u_ShadowMaps[shadowIndex], 0);
+    float shadow       = 0.0;
+    vec2  texelSize    = 1.0 / vec2(textureSize(u_CascadeShadowMap, 0).xy);
 
     for (int x = -1; x <= 1; ++x) {
         for (int y = -1; y <= 1; ++y) {
-            vec2 sampleCoord = projCoords.xy + vec2(x, y) * texelSize;
-            sampleCoord      = clamp(sampleCoord, 0.0, 1.0);
-
-            float pcfDepth = texture(u_ShadowMaps[shadowIndex], sampleCoord).r;
-            shadow += (pcfDepth + bias) < currentDepth ? 1.0 : 0.0;
+            vec2  sampleCoord = projCoords.xy + vec2(x, y) * texelSize;
+            float pcfDepth    = texture(u_CascadeShadowMap, vec3(sampleCoord, float(cascade))).r;
+            shadow += (pcfDepth + u_CascadeBias) < currentDepth ? 1.0 : 0.0;
         }
     }
-    shadow /= 9.0;
 
-    return shadow * u_ShadowStrength[shadowIndex];
+    return shadow / 9.0;
 }
 
-// Point light cubemap shadow calculation
-float calculatePointLightShadow(vec3 fragPos, int shadowIndex) {
-    if (u_PointLightShadowCount == 0 || shadowIndex >= u_PointLightShadowCount || shadowIndex < 0)
+// Directional shadow, cascade picked by view depth and blended into the next near its split
+float calculateCascadedShadow(vec3 fragPos) {
+    if (u_CascadeCount == 0)
         return 0.0;
 
-    vec3  fragToLight  = fragPos - u_PointLightShadowPositions[shadowIndex];
-    float currentDepth = length(fragToLight);
-    float bias         = 0.05;
+    float viewDepth = -(u_View * vec4(fragPos, 1.0)).z;
 
-    float shadow  = 0.0;
-    float samples = 4.0; // adjust for quality vs performance
-    float offset  = 0.15;
+    int cascade = 0;
+    while (cascade < u_CascadeCount && viewDepth > u_CascadeSplits[cascade])
+        ++cascade;
 
-    for (int x = -1; x <= 1; ++x) {
-        for (int y = -1; y <= 1; ++y) {
-            for (int z = -1; z <= 1; ++z) {
-                vec3  sampleOffset = vec3(x, y, z) * offset;
-                float closestDepth
-                    = texture(u_PointLightShadowMaps[shadowIndex], fragToLight + sampleOffset).r;
-                closestDepth *= u_PointLightShadowFarPlanes[shadowIndex];
-                if (currentDepth - bias > closestDepth)
-                    shadow += 1.0;
-            }
-        }
+    if (cascade >= u_CascadeCount)
+        return 0.0;
+
+    float shadow = sampleCascade(fragPos, cascade);
+
+    float splitFar   = u_CascadeSplits[cascade];
+    float splitNear  = cascade > 0 ? u_CascadeSplits[cascade - 1] : 0.0;
+    float blendStart = splitFar - (splitFar - splitNear) * 0.1;
+    if (cascade + 1 < u_CascadeCount && viewDepth > blendStart) {
+        float t = (viewDepth - blendStart) / (splitFar - blendStart);
+        shadow  = mix(shadow, sampleCascade(fragPos, cascade + 1), t);
     }
-    shadow /= (samples * samples * samples);
 
-    return shadow * 0.8;
+    return shadow * u_CascadeStrength;
 }
 
-void main() {
-    vec4 texelColor = texture(texture0, fragTexCoord);
+// Point light shadow, data is one tile rect per cube face and the far plane. Tiles hold linear
+// distance to the light divided by the far plane
+float calculatePointLightShadow(vec3 fragPos, vec3 lightPos, int shadowOffset) {
+    vec3 fragToLight = fragPos - lightPos;
+    vec3 absDir      = abs(fragToLight);
+
+    int face;
+    if (absDir.x >= absDir.y && absDir.x >= absDir.z)
+        face = fragToLight.x > 0.0 ? 0 : 1;
+    else if (absDir.y >= absDir.z)
+        face = fragToLight.y > 0.0 ? 2 : 3;
+    else
+        face = fragToLight.z > 0.0 ? 4 : 5;
+
+    // Same projection as the face's 90 degree lookAt/perspective pair
+    vec3  forward    = CUBE_FACE_DIRS[face];
+    vec3  right      = normalize(cross(forward, CUBE_FACE_UPS[face]));
+    vec3  up         = cross(right, forward);
+    float depth      = dot(fragToLight, forward);
+    vec2  tileCoords = vec2(dot(fragToLight, right), dot(fragToLight, up)) / depth * 0.5 + 0.5;
+
+    vec4  rect     = texelFetch(u_ShadowData, shadowOffset + face);
+    float farPlane = texelFetch(u_ShadowData, shadowOffset + 6).x;
+    float bias     = 0.05;
+
+    float currentDepth = length(fragToLight) / farPlane;
+    return sampleShadowTile(rect, tileCoords, currentDepth, bias / farPlane) * 0.8;
+}
 
-    vec3  albedo = texelColor.rgb * _MainColor.rgb;
-    float alpha  = texelColor.a * _MainColor.a;
+// Cluster containing this fragment, logarithmic depth slices from the camera near plane
+int findCluster(vec3 fragPos) {
+    ivec3 dims = ivec3(u_ClusterDims);
+
+    vec4 clipPos = u_ViewProjection * vec4(fragPos, 1.0);
+    vec2 ndc     = clipPos.xy / clipPos.w;
+    int  x       = clamp(int((ndc.x * 0.5 + 0.5) * dims.x), 0, dims.x - 1);
+    int  y       = clamp(int((ndc.y * 0.5 + 0.5) * dims.y), 0, dims.y - 1);
+
+    float viewDepth = max(-(u_View * vec4(fragPos, 1.0)).z, u_ClusterNear);
+    int   z = clamp(int(floor(log(viewDepth / u_ClusterNear) * u_ClusterLogScale)), 0, dims.z - 1);
 
+    return x + dims.x * (y + dims.y * z);
+}
+
+// Full lighting for one surface point
+vec3 shade(vec3 fragPosition, vec3 fragNormal, vec3 albedo, float metallic, float smoothness) {
     vec3 viewDir = normalize(u_ViewPos - fragPosition);
 
     // Ambient
@@ -272,52 +338,100 @@ void main() {
 
     // Directional light
     vec3 directionalLighting
-        = calculateDirectionalLight(fragNormal, viewDir, albedo, _Metallic, _Smoothness);
+        = calculateDirectionalLight(fragNormal, viewDir, albedo, metallic, smoothness);
 
     // Directional shadow
-    float dirShadow = 0.0;
-    if (u_ShadowMapCount > 0) {
-        dirShadow = calculateShadow(fragPosition, 0);
-    }
-    vec3 shadedDirectional = (1.0 - dirShadow) * directionalLighting;
+    float dirShadow         = calculateCascadedShadow(fragPosition);
+    vec3  shadedDirectional = (1.0 - dirShadow) * directionalLighting;
 
-    // Point lights WITH shadows
+    // Point and spot lights from this fragment's cluster
     vec3 pointLighting = vec3(0.0);
-    for (int i = 0; i < u_PointLightCount && i < 16; ++i) {
-        vec3 lightContribution = calculatePointLight(
-            u_PointLights[i], fragNormal, fragPosition, viewDir, albedo, _Metallic, _Smoothness);
-
-        // Check if this point light casts shadows
-        float pointShadow = 0.0;
-        for (int s = 0; s < u_PointLightShadowCount; ++s) {
-            if (u_PointLightShadowIndices[s] == i) {
-                pointShadow = calculatePointLightShadow(fragPosition, s);
-                break;
-            }
+    vec3 spotLighting  = vec3(0.0);
+
+    int  cluster = findCluster(fragPosition);
+    int  offset  = int(texelFetch(u_ClusterGrid, cluster * 2).r);
+    int  count   = int(texelFetch(u_ClusterGrid, cluster * 2 + 1).r);
+    for (int i = 0; i < count; ++i) {
+        int  lightIndex  = int(texelFetch(u_ClusterIndices, offset + i).r) * 4;
+        vec4 posRange    = texelFetch(u_ClusterLights, lightIndex);
+        vec4 colorType   = texelFetch(u_ClusterLights, lightIndex + 1);
+        vec4 dirInner    = texelFetch(u_ClusterLights, lightIndex + 2);
+        vec4 outerShadow = texelFetch(u_ClusterLights, lightIndex + 3);
+
+        int shadowOffset = int(outerShadow.y);
+
+        if (colorType.w < 0.5) {
+            PointLight light             = PointLight(posRange.xyz, colorType.rgb, posRange.w);
+            vec3       lightContribution = calculatePointLight(
+                light, fragNormal, fragPosition, viewDir, albedo, metallic, smoothness);
+
+            float pointShadow = 0.0;
+            if (shadowOffset >= 0)
+                pointShadow = calculatePointLightShadow(fragPosition, posRange.xyz, shadowOffset);
+
+            pointLighting += (1.0 - pointShadow) * lightContribution;
+        } else {
+            SpotLight light = SpotLight(posRange.xyz,
+                                        dirInner.xyz,
+                                        colorType.rgb,
+                                        posRange.w,
+                                        dirInner.w,
+                                        outerShadow.x);
+            vec3 spotLightColor = calculateSpotLight(
+                light, fragNormal, fragPosition, viewDir, albedo, metallic, smoothness);
+
+            float shadowFactor = 0.0;
+            if (shadowOffset >= 0)
+                shadowFactor = calculateSpotLightShadow(fragPosition, shadowOffset);
+
+            spotLighting += (1.0 - shadowFactor) * spotLightColor;
         }
-
-        // Apply shadow to this light
-        lightContribution *= (1.0 - pointShadow);
-        pointLighting += lightContribution;
     }
 
-    // Spot lights
-    vec3 spotLighting = vec3(0.0);
-    for (int i = 0; i < u_SpotLightCount && i < 16; ++i) {
-        vec3 spotLightColor = calculateSpotLight(
-            u_SpotLights[i], fragNormal, fragPosition, viewDir, albedo, _Metallic, _Smoothness);
-
-        int shadowIndex = u_SpotLightShadowIndices[i];
-
-        float shadowFactor = 0.0;
-        if (shadowIndex >= 0 && shadowIndex < u_ShadowMapCount)
-            shadowFactor = calculateSpotLightShadow(fragPosition, shadowIndex);
+    // Combine all lighting
+    return ambient + shadedDirectional + pointLighting + spotLighting;
+}
 
-        spotLighting += (1.0 - shadowFactor) * spotLightColor;
-    }
+void main() {
+#ifdef DEFERRED_LIGHTING
+    // Nothing was drawn here, keep whatever the target was cleared to
+    float depth = texture(u_GBufferDepth, screenUV).r;
+    if (depth >= 1.0)
+        discard;
+
+    vec4 albedoMetallic   = texture(u_GBufferAlbedo, screenUV);
+    vec4 normalSmoothness = texture(u_GBufferNormal, screenUV);
+
+    // World position from depth, later forward draws depth test against it too
+    vec4 worldPos = u_InverseViewProjection * vec4(vec3(screenUV, depth) * 2.0 - 1.0, 1.0);
+    gl_FragDepth  = depth;
+
+    vec3 position = worldPos.xyz / worldPos.w;
+    finalColor    = vec4(shade(position,
+                            normalSmoothness.xyz,
+                            albedoMetallic.rgb,
+                            albedoMetallic.a,
+                            normalSmoothness.w),
+                      1.0);
+#else
+    vec4 texelColor = texture(texture0, fragTexCoord);
 
-    // Combine all lighting
-    vec3 finalLighting = ambient + shadedDirectional + pointLighting + spotLighting;
+    vec3  albedo = texelColor.rgb * _MainColor.rgb;
+    float alpha  = texelColor.a * _MainColor.a;
 
-    finalColor = vec4(finalLighting, alpha);
+#if defined(GBUFFER_PASS)
+    gAlbedo = vec4(albedo, _Metallic);
+    gNormal = vec4(normalize(fragNormal), _Smoothness);
+#elif defined(WEIGHTED_BLENDED)
+    // Depth weight from McGuire and Bavoil, nearer layers dominate the average
+    vec3  color  = shade(fragPosition, fragNormal, albedo, _Metallic, _Smoothness);
+    float depthZ = 1.0 - gl_FragCoord.z;
+    float weight = clamp(alpha * max(1e-2, 3e3 * depthZ * depthZ * depthZ), 1e-2, 3e3);
+
+    oitAccum  = vec4(color * alpha * weight, alpha);
+    oitWeight = vec4(alpha * weight);
+#else
+    finalColor = vec4(shade(fragPosition, fragNormal, albedo, _Metallic, _Smoothness), alpha);
+#endif
+#endif
 }
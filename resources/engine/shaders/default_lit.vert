@@ -19,6 +19,9 @@ out vec4 fragColor;
 out vec3 fragPosition;
 out vec3 fragNormal;
 
+// Must match the depth pre-pass bit for bit, the lit pass then tests depth for equality
+invariant gl_Position;
+
 void main() {
     // Send texture coordinates to fragment shader
     fragTexCoord = vertexTexCoord;
@@ -0,0 +1,47 @@
+#version 330
+
+// Input vertex attributes
+layout(location = 0) in vec3 vertexPosition;
+layout(location = 1) in vec3 vertexNormal;
+layout(location = 2) in vec2 vertexTexCoord;
+layout(location = 3) in vec4 vertexColor;
+
+// Input uniform values
+uniform mat4 u_View;
+uniform mat4 u_Projection;
+uniform mat4 u_ViewProjection;
+
+// 7 texels per instance, model matrix columns then normal matrix columns
+uniform samplerBuffer u_InstanceData;
+uniform int           u_InstanceOffset;
+
+// Output to fragment shader
+out vec2 fragTexCoord;
+out vec4 fragColor;
+out vec3 fragPosition;
+out vec3 fragNormal;
+
+// Must match the depth pre-pass bit for bit, the lit pass then tests depth for equality
+invariant gl_Position;
+
+void main() {
+    int  base  = (u_InstanceOffset + gl_InstanceID) * 7;
+    mat4 model = mat4(texelFetch(u_InstanceData, base),
+                      texelFetch(u_InstanceData, base + 1),
+                      texelFetch(u_InstanceData, base + 2),
+                      texelFetch(u_InstanceData, base + 3));
+    mat3 normalMatrix = mat3(texelFetch(u_InstanceData, base + 4).xyz,
+                             texelFetch(u_InstanceData, base + 5).xyz,
+                             texelFetch(u_InstanceData, base + 6).xyz);
+
+    // Send texture coordinates to fragment shader
+    fragTexCoord = vertexTexCoord;
+
+    // Send vertex color to fragment shader
+    fragColor = vertexColor;
+
+    // Calculate fragment position in world space
+    fragPosition = vec3(model * vec4(vertexPosition, 1.0));
+    fragNormal   = normalize(normalMatrix * vertexNormal);
+    gl_Position  = u_ViewProjection * model * vec4(vertexPosition, 1.0);
+}
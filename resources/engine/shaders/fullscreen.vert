@@ -0,0 +1,11 @@
+#version 330
+
+// Full screen triangle, positions are already in clip space
+layout(location = 0) in vec3 vertexPosition;
+
+out vec2 screenUV;
+
+void main() {
+    screenUV    = vertexPosition.xy * 0.5 + 0.5;
+    gl_Position = vec4(vertexPosition.xy, 0.0, 1.0);
+}
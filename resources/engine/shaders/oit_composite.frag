@@ -0,0 +1,21 @@
+#version 330
+
+// Resolves weighted blended transparency over the opaque scene
+in vec2 screenUV;
+
+uniform sampler2D u_OITAccum;  // rgb sum of weighted premultiplied color, a revealage
+uniform sampler2D u_OITWeight; // r sum of weighted alpha
+
+out vec4 finalColor;
+
+void main() {
+    vec4  accum     = texture(u_OITAccum, screenUV);
+    float revealage = accum.a;
+
+    // No transparent surface covered this pixel
+    if (revealage >= 1.0)
+        discard;
+
+    vec3 average = accum.rgb / max(texture(u_OITWeight, screenUV).r, 1e-5);
+    finalColor   = vec4(average, 1.0 - revealage);
+}
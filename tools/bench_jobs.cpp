@@ -0,0 +1,103 @@
+/**
+ * Scaling of the job system's first users over the number of threads: frustum culling through
+ * cullSpheres and local matrices through composeMatrices, split with parallelFor the way the
+ * transform hierarchy does. Every run is compared with the single threaded result, both kernels
+ * are deterministic per element so the results have to match exactly.
+ */
+#include "bench_util.hpp"
+#include "corvus/jobs/job_system.hpp"
+#include "corvus/log.hpp"
+#include "corvus/renderer/batch_transform.hpp"
+#include "corvus/renderer/culling.hpp"
+#include <algorithm>
+#include <cstring>
+#include <glm/gtc/matrix_transform.hpp>
+#include <random>
+#include <thread>
+#include <vector>
+
+using namespace Corvus;
+using namespace Corvus::Renderer;
+using Corvus::Tools::bestOf;
+
+namespace {
+constexpr size_t SPHERES       = 4 << 20;
+constexpr size_t POSES         = 1 << 20;
+constexpr size_t COMPOSE_GRAIN = 1024; // As in the transform hierarchy
+constexpr int    RUNS          = 10;
+}
+
+int main() {
+    Log::init();
+
+    std::mt19937                          rng(1234);
+    std::uniform_real_distribution<float> coordinate(-500.0f, 500.0f);
+    std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+    std::uniform_real_distribution<float> size(0.1f, 10.0f);
+
+    SphereBoundsSoA bounds;
+    bounds.reserve(SPHERES);
+    for (size_t i = 0; i < SPHERES; ++i)
+        bounds.push(glm::vec3(coordinate(rng), coordinate(rng), coordinate(rng)), size(rng));
+
+    TransformSoA poses;
+    poses.reserve(POSES);
+    for (size_t i = 0; i < POSES; ++i) {
+        const glm::quat rotation(unit(rng), unit(rng), unit(rng), unit(rng));
+        poses.push(glm::vec3(coordinate(rng), coordinate(rng), coordinate(rng)),
+                   glm::normalize(rotation),
+                   glm::vec3(size(rng), size(rng), size(rng)));
+    }
+
+    const auto frustum = Camera::Frustum::fromMatrix(
+        glm::perspective(glm::radians(60.0f), 16.0f / 9.0f, 0.1f, 400.0f)
+        * glm::lookAt(glm::vec3(0.0f), glm::vec3(0.0f, 0.0f, -1.0f), glm::vec3(0.0f, 1.0f, 0.0f)));
+
+    std::vector<uint8_t>   expectedVisible, visible;
+    std::vector<glm::mat4> expectedMatrices, matrices(POSES);
+    uint32_t               expectedCount = 0;
+    double                 cullBase = 0.0, composeBase = 0.0;
+
+    CORVUS_INFO("{} spheres, {} poses, best of {} runs", SPHERES, POSES, RUNS);
+
+    const uint32_t maxThreads = std::max(std::thread::hardware_concurrency(), 1u);
+    for (uint32_t threads = 1; threads <= maxThreads; ++threads) {
+        // The calling thread works too, so one thread is no workers at all
+        Core::JobSystem jobs(threads - 1);
+
+        uint32_t     count = 0;
+        const double cull
+            = bestOf(RUNS, [&] { count = cullSpheres(frustum, bounds, visible, jobs); });
+
+        const double compose = bestOf(RUNS, [&] {
+            jobs.parallelFor(0, POSES, COMPOSE_GRAIN, [&](const size_t first, const size_t last) {
+                composeMatrices(poses, first, last, matrices.data());
+            });
+        });
+
+        if (threads == 1) {
+            expectedCount    = count;
+            expectedVisible  = visible;
+            expectedMatrices = matrices;
+            cullBase         = cull;
+            composeBase      = compose;
+        } else if (count != expectedCount || visible != expectedVisible
+                   || std::memcmp(matrices.data(),
+                                  expectedMatrices.data(),
+                                  POSES * sizeof(glm::mat4))
+                       != 0) {
+            CORVUS_ERROR("{} threads produced a different result than one", threads);
+            return 1;
+        }
+
+        CORVUS_INFO("{:>3} threads   cull {:8.3f} ms {:5.2f}x   compose {:8.3f} ms {:5.2f}x",
+                    threads,
+                    cull,
+                    cullBase / cull,
+                    compose,
+                    composeBase / compose);
+    }
+
+    CORVUS_INFO("{} of {} spheres visible", expectedCount, SPHERES);
+    return 0;
+}
@@ -0,0 +1,105 @@
+/**
+ * Compares the batched SSE/AVX transform kernels with the glm code they replace, on random poses
+ * with uniform and non uniform scales. A count that is not a multiple of the lane width makes the
+ * scalar tail run too. Exits non zero if any matrix differs beyond the tolerance.
+ */
+#define GLM_ENABLE_EXPERIMENTAL
+#include "bench_util.hpp"
+#include "corvus/log.hpp"
+#include "corvus/renderer/batch_transform.hpp"
+#include <algorithm>
+#include <cmath>
+#include <glm/gtc/matrix_inverse.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtx/quaternion.hpp>
+#include <random>
+#include <vector>
+
+using namespace Corvus::Renderer;
+using Corvus::Tools::bestOf;
+
+namespace {
+constexpr size_t COUNT     = 100003; // Leaves a tail for both 4 and 8 lanes
+constexpr int    RUNS      = 20;
+constexpr float  TOLERANCE = 1e-4f; // Relative to the largest element of the reference
+
+template <typename Matrix>
+float maxError(const Matrix& actual, const Matrix& expected) {
+    using Length = typename Matrix::length_type;
+
+    float error = 0.0f, scale = 1.0f;
+    for (Length c = 0; c < Matrix::length(); ++c) {
+        for (Length r = 0; r < Matrix::col_type::length(); ++r) {
+            error = std::max(error, std::abs(actual[c][r] - expected[c][r]));
+            scale = std::max(scale, std::abs(expected[c][r]));
+        }
+    }
+    return error / scale;
+}
+
+void report(const char* what, const double glmMs, const double batchMs) {
+    CORVUS_INFO("{:<16} glm {:8.3f} ms   batched {:8.3f} ms   {:5.2f}x",
+                what,
+                glmMs,
+                batchMs,
+                glmMs / batchMs);
+}
+}
+
+int main() {
+    Corvus::Log::init();
+
+    std::mt19937                          rng(1234);
+    std::uniform_real_distribution<float> position(-100.0f, 100.0f);
+    std::uniform_real_distribution<float> component(-1.0f, 1.0f);
+    std::uniform_real_distribution<float> scale(0.1f, 10.0f);
+
+    // Every other pose has a uniform scale, which takes the cheaper normal matrix path
+    std::vector<glm::vec3> positions(COUNT), scales(COUNT);
+    std::vector<glm::quat> rotations(COUNT);
+    TransformSoA           soa;
+    soa.reserve(COUNT);
+    for (size_t i = 0; i < COUNT; ++i) {
+        const glm::quat rotation(component(rng), component(rng), component(rng), component(rng));
+        positions[i] = glm::vec3(position(rng), position(rng), position(rng));
+        rotations[i] = glm::normalize(rotation);
+        scales[i]    = i % 2 == 0 ? glm::vec3(scale(rng))
+                                  : glm::vec3(scale(rng), scale(rng), scale(rng));
+        soa.push(positions[i], rotations[i], scales[i]);
+    }
+
+    std::vector<glm::mat4> glmModels(COUNT), batchModels(COUNT);
+    std::vector<glm::mat3> glmNormals(COUNT), batchNormals(COUNT);
+
+    const double glmCompose = bestOf(RUNS, [&] {
+        for (size_t i = 0; i < COUNT; ++i)
+            glmModels[i] = glm::translate(glm::mat4(1.0f), positions[i])
+                * glm::toMat4(rotations[i]) * glm::scale(glm::mat4(1.0f), scales[i]);
+    });
+    const double batchCompose
+        = bestOf(RUNS, [&] { composeMatrices(soa, 0, COUNT, batchModels.data()); });
+
+    const double glmNormal = bestOf(RUNS, [&] {
+        for (size_t i = 0; i < COUNT; ++i)
+            glmNormals[i] = glm::inverseTranspose(glm::mat3(glmModels[i]));
+    });
+    const double batchNormal
+        = bestOf(RUNS, [&] { normalMatrices(glmModels.data(), COUNT, batchNormals.data()); });
+
+    float composeError = 0.0f, normalError = 0.0f;
+    for (size_t i = 0; i < COUNT; ++i) {
+        composeError = std::max(composeError, maxError(batchModels[i], glmModels[i]));
+        normalError  = std::max(normalError, maxError(batchNormals[i], glmNormals[i]));
+    }
+
+    CORVUS_INFO("{} poses, best of {} runs", COUNT, RUNS);
+    report("composeMatrices", glmCompose, batchCompose);
+    report("normalMatrices", glmNormal, batchNormal);
+    CORVUS_INFO("Largest relative error: compose {:.2e}, normal {:.2e}", composeError, normalError);
+
+    if (composeError > TOLERANCE || normalError > TOLERANCE) {
+        CORVUS_ERROR("Batched matrices differ from glm by more than {:.0e}", TOLERANCE);
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+
+namespace Corvus::Tools {
+
+/**
+ * Best time of runs calls to func in milliseconds. One extra call comes first and is not timed,
+ * it warms the caches and wakes the job system's workers.
+ */
+template <typename Func>
+double bestOf(const int runs, Func&& func) {
+    double best = 1e30;
+    for (int run = 0; run <= runs; ++run) {
+        const auto start = std::chrono::steady_clock::now();
+        func();
+        const std::chrono::duration<double, std::milli> elapsed
+            = std::chrono::steady_clock::now() - start;
+        if (run > 0)
+            best = std::min(best, elapsed.count());
+    }
+    return best;
+}
+
+}
@@ -0,0 +1,148 @@
+/**
+ * Runs the compute side of the RHI against a real context: storage buffer updates and growth,
+ * dispatch, image bindings and memory barriers. Needs a display and OpenGL 4.3, without a GPU
+ * run it under xvfb-run with Mesa's llvmpipe. Exits non zero on the first mismatch.
+ */
+#include "corvus/graphics/graphics.hpp"
+#include "corvus/graphics/window.hpp"
+#include "corvus/log.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <numeric>
+#include <vector>
+
+using namespace Corvus::Graphics;
+
+namespace {
+constexpr uint32_t COUNT = 64;
+
+// Doubles every value, then writes it to a column of the image so the next pass can read it
+const char* WRITE_SHADER = R"(#version 430
+layout(local_size_x = 16) in;
+layout(std430, binding = 0) buffer Values { uint values[]; };
+layout(rgba32f, binding = 0) uniform writeonly image2D target;
+void main() {
+    uint i = gl_GlobalInvocationID.x;
+    values[i] *= 2u;
+    imageStore(target, ivec2(i, 0), vec4(float(values[i]), 0.0, 0.0, 1.0));
+}
+)";
+
+// Adds the image back onto the buffer, only correct if the image writes were made visible
+const char* READ_SHADER = R"(#version 430
+layout(local_size_x = 16) in;
+layout(std430, binding = 0) buffer Values { uint values[]; };
+layout(rgba32f, binding = 0) uniform readonly image2D source;
+void main() {
+    uint i = gl_GlobalInvocationID.x;
+    values[i] += uint(imageLoad(source, ivec2(i, 0)).r);
+}
+)";
+
+bool expect(const StorageBuffer&         buffer,
+            const std::vector<uint32_t>& expected,
+            const char*                  what) {
+    std::vector<uint32_t> actual(expected.size());
+    buffer.getData(actual.data(), uint32_t(actual.size() * sizeof(uint32_t)));
+    for (size_t i = 0; i < expected.size(); ++i) {
+        if (actual[i] != expected[i]) {
+            CORVUS_ERROR("{}: value {} is {}, expected {}", what, i, actual[i], expected[i]);
+            return false;
+        }
+    }
+
+    CORVUS_INFO("{}: ok", what);
+    return true;
+}
+
+// Record one command buffer and run it to completion
+template <typename Record>
+void run(GraphicsContext& ctx, Record&& record) {
+    auto cmd = ctx.createCommandBuffer();
+    cmd.begin();
+    record(cmd);
+    cmd.end();
+    cmd.submit();
+    ctx.flush();
+}
+}
+
+int main() {
+    Corvus::Log::init();
+
+    auto window = Window::create(WindowAPI::GLFW, GraphicsAPI::OpenGL, 64, 64, "check_compute");
+    auto ctx    = GraphicsContext::create(GraphicsAPI::OpenGL);
+    if (!window || !ctx || !ctx->initialize(*window)) {
+        CORVUS_ERROR("No OpenGL context");
+        return 1;
+    }
+
+    std::vector<uint32_t> values(COUNT);
+    std::iota(values.begin(), values.end(), 0u);
+
+    auto buffer = ctx->createStorageBuffer(values.data(), COUNT * sizeof(uint32_t));
+    if (!buffer.valid()) {
+        CORVUS_ERROR("Storage buffers are not supported, OpenGL 4.3 is required");
+        return 1;
+    }
+
+    // A write at the start of the buffer must not drop the rest of it
+    const uint32_t head[4] = { 100, 101, 102, 103 };
+    run(*ctx, [&](CommandBuffer& cmd) { buffer.setData(cmd, head, sizeof(head)); });
+    std::copy(std::begin(head), std::end(head), values.begin());
+    if (buffer.sizeBytes != COUNT * sizeof(uint32_t) || !expect(buffer, values, "partial write"))
+        return 1;
+
+    // A write past the end grows the buffer and keeps what was there
+    const uint32_t tail[4] = { 200, 201, 202, 203 };
+    run(*ctx, [&](CommandBuffer& cmd) {
+        buffer.setData(cmd, tail, sizeof(tail), (COUNT + 4) * sizeof(uint32_t));
+    });
+    if (buffer.sizeBytes != (COUNT + 8) * sizeof(uint32_t) || !expect(buffer, values, "growth"))
+        return 1;
+
+    std::vector<uint32_t> appended(COUNT + 8);
+    buffer.getData(appended.data(), uint32_t(appended.size() * sizeof(uint32_t)));
+    if (!std::equal(std::begin(tail), std::end(tail), appended.begin() + COUNT + 4)) {
+        CORVUS_ERROR("growth: the appended values were not written");
+        return 1;
+    }
+
+    // Two dependent dispatches through an image, separated by barriers
+    auto write = ctx->createComputeShader(WRITE_SHADER);
+    auto read  = ctx->createComputeShader(READ_SHADER);
+    auto image = ctx->createTexture2D(COUNT, 1, ImageFormat::RGBA32F);
+    if (!write.valid() || !read.valid() || !image.valid()) {
+        CORVUS_ERROR("Failed to create the compute shaders or the image");
+        return 1;
+    }
+
+    run(*ctx, [&](CommandBuffer& cmd) {
+        cmd.bindStorageBuffer(0, buffer);
+        cmd.setShader(write);
+        cmd.bindImageTexture(0, image, ImageAccess::WriteOnly, ImageFormat::RGBA32F);
+        cmd.dispatch(COUNT / 16);
+        cmd.memoryBarrier(BarrierBits::ShaderImageAccess | BarrierBits::ShaderStorage);
+
+        cmd.setShader(read);
+        cmd.bindImageTexture(0, image, ImageAccess::ReadOnly, ImageFormat::RGBA32F);
+        cmd.dispatch(COUNT / 16);
+        cmd.memoryBarrier(BarrierBits::BufferUpdate);
+    });
+
+    // Each value was doubled and then had the doubled value added
+    for (auto& value : values)
+        value *= 4;
+    if (!expect(buffer, values, "dispatch with image and barriers"))
+        return 1;
+
+    buffer.release();
+    write.release();
+    read.release();
+    image.release();
+    ctx->flush();
+    ctx->shutdown();
+
+    CORVUS_INFO("All compute checks passed");
+    return 0;
+}
@@ -14,6 +14,7 @@ if is_mode("debug") then
     set_symbols("debug")
     set_optimize("none")
     set_warnings("all")
+    add_defines("CORVUS_DEBUG")
 end
 
 if is_mode("release") then
@@ -156,3 +157,22 @@ target("corvus-editor")
         "editor/src/**.cpp",
         "editor/src/**/**.cpp"
     )
+
+-- Standalone checks and benchmarks, not built by default: xmake build <name> && xmake run <name>
+target("corvus-check-compute")
+    set_kind("binary")
+    set_default(false)
+    add_deps("corvus-core")
+    add_files("tools/check_compute.cpp")
+
+target("corvus-bench-transforms")
+    set_kind("binary")
+    set_default(false)
+    add_deps("corvus-core")
+    add_files("tools/bench_transforms.cpp")
+
+target("corvus-bench-jobs")
+    set_kind("binary")
+    set_default(false)
+    add_deps("corvus-core")
+    add_files("tools/bench_jobs.cpp")